@@ -0,0 +1,284 @@
+#define _POSIX_C_SOURCE 200809L // clock_gettime
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "types.h"
+#include "board.h"
+#include "tetromino.h"
+#include "search.h"
+
+/* Microbenchmarks for the primitives the search is built on:
+ *   - Each case runs a warm-up, calibrates an iteration count so one repetition takes about
+ *     TARGET_REP_NS, then times REPS repetitions and reports mean, standard deviation and minimum ns/op.
+ *   - Results feed a volatile sink so the compiler cannot drop the work.
+ *   - Usage: microbench [FILTER]   (runs only cases whose name contains FILTER) */
+
+#define REPS 7
+#define WARMUP_NS 20000000.0     // 20 ms
+#define TARGET_REP_NS 50000000.0 // 50 ms
+#define FILL_PERCENT 50
+#define POSITION_NUM 1024
+
+// one benchmark: setup once per board size, then run(iterations) repeatedly
+typedef struct BenchCase
+{
+    const char *name;
+    bool per_size; // false: the primitive does not depend on the board, run it once
+    void (*setup)(int width, int height);
+    void (*run)(size_t iterations);
+    void (*teardown)(void);
+} BenchCase;
+
+typedef struct BenchSize
+{
+    int width;
+    int height;
+} BenchSize;
+
+static const BenchSize SIZES[] = {{4, 4}, {8, 8}, {16, 16}, {64, 64}, {256, 256}};
+
+static volatile size_t sink;
+
+// shared fixture
+static Board *bench_board;
+static FILE *bench_null;
+static Cell positions[POSITION_NUM];
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static uint64_t next_random(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+// fill about FILL_PERCENT of the board with random tetrominoes (the board a mid-search frame sees)
+static void fill_random(Board *board)
+{
+    int W = board_width(board);
+    int H = board_height(board);
+    size_t target = board_cell_count(board) * FILL_PERCENT / 100;
+    size_t attempts = board_cell_count(board) * 8;
+    for (size_t i = 0; i < attempts && board_filled_count(board) + 4 <= target; ++i)
+    {
+        TetrominoType type = (TetrominoType)(next_random() % TETRO_TYPE_COUNT);
+        size_t rot = (size_t)(next_random() % tetro_rotation_count(type));
+        int x = (int)(next_random() % (uint64_t)W);
+        int y = (int)(next_random() % (uint64_t)H);
+        board_place(board, x, y, type, rot, 'X');
+    }
+}
+
+// random anchors; with empty_only, only cells that are empty on the board
+static void pick_positions(bool empty_only)
+{
+    int W = board_width(bench_board);
+    int H = board_height(bench_board);
+    for (size_t i = 0; i < POSITION_NUM; ++i)
+    {
+        Cell c;
+        size_t tries = 0;
+        do
+        {
+            c.x = (int)(next_random() % (uint64_t)W);
+            c.y = (int)(next_random() % (uint64_t)H);
+        } while (empty_only && !board_is_empty(bench_board, c.x, c.y) && ++tries < 64);
+        positions[i] = c;
+    }
+}
+
+static void setup_empty(int width, int height)
+{
+    bench_board = board_create(width, height);
+    pick_positions(false);
+}
+
+static void setup_half(int width, int height)
+{
+    bench_board = board_create(width, height);
+    fill_random(bench_board);
+    pick_positions(true);
+}
+
+// the first empty cell sits in the middle of the board: rows above are full
+static void setup_prefix(int width, int height)
+{
+    bench_board = board_create(width, height);
+    for (int y = 0; y < height / 2; ++y)
+    {
+        for (int x = 0; x + 4 <= width; x += 4)
+            board_place(bench_board, x, y, TETRO_I, 0, 'X');
+    }
+}
+
+static void setup_print(int width, int height)
+{
+    setup_half(width, height);
+    bench_null = fopen("/dev/null", "w");
+}
+
+static void teardown_board(void)
+{
+    board_destroy(bench_board);
+    bench_board = NULL;
+    if (bench_null)
+        fclose(bench_null);
+    bench_null = NULL;
+}
+
+static void run_place_remove(size_t iterations)
+{
+    size_t placed = 0;
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        const Cell *c = positions + (i % POSITION_NUM);
+        TetrominoType type = (TetrominoType)(i % TETRO_TYPE_COUNT);
+        if (board_place(bench_board, c->x, c->y, type, 0, 'A'))
+        {
+            board_remove(bench_board, c->x, c->y, type, 0);
+            placed++;
+        }
+    }
+    sink = placed;
+}
+
+static void run_get_cells(size_t iterations)
+{
+    size_t acc = 0;
+    Cell cells[4];
+    TetrominoType type = TETRO_I;
+    size_t rot = 0;
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        acc += tetro_get_cells(type, rot, cells) + (size_t)cells[3].x;
+        if (++rot == tetro_rotation_count(type))
+        {
+            rot = 0;
+            type = type + 1 == TETRO_TYPE_COUNT ? TETRO_I : (TetrominoType)(type + 1);
+        }
+    }
+    sink = acc;
+}
+
+static void run_next_empty(size_t iterations)
+{
+    size_t acc = 0;
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        Cell c = search_next_empty(bench_board);
+        acc += (size_t)(c.x + c.y);
+    }
+    sink = acc;
+}
+
+static void run_candidates(size_t iterations)
+{
+    static const size_t counts[TETRO_TYPE_COUNT] = {1, 1, 1, 1, 1, 1, 1};
+    Placement cands[CANDS_MAX_SIZE];
+    size_t acc = 0;
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        const Cell *c = positions + (i % POSITION_NUM);
+        acc += search_candidates(bench_board, c->x, c->y, 'A', counts, false, cands);
+    }
+    sink = acc;
+}
+
+static void run_print(size_t iterations)
+{
+    for (size_t i = 0; i < iterations; ++i)
+        board_print(bench_board, bench_null);
+    sink = iterations;
+}
+
+static const BenchCase CASES[] = {
+    {"board_place+remove", true, setup_empty, run_place_remove, teardown_board},
+    {"tetro_get_cells", false, setup_empty, run_get_cells, teardown_board},
+    {"find_next_empty", true, setup_prefix, run_next_empty, teardown_board},
+    {"generate_candidates", true, setup_half, run_candidates, teardown_board},
+    {"board_print", true, setup_print, run_print, teardown_board},
+};
+
+static double time_run(const BenchCase *bc, size_t iterations)
+{
+    double start = now_ns();
+    bc->run(iterations);
+    return now_ns() - start;
+}
+
+// warm up, calibrate, then time REPS repetitions
+static void bench_one(const BenchCase *bc, const BenchSize *size)
+{
+    bc->setup(size->width, size->height);
+    if (!bench_board || (bc->setup == setup_print && !bench_null))
+    {
+        fprintf(stderr, "%s: setup failed for %dx%d\n", bc->name, size->width, size->height);
+        bc->teardown();
+        return;
+    }
+
+    // warm-up doubles as calibration: grow until a run takes a measurable time
+    size_t iterations = 1;
+    double elapsed = time_run(bc, iterations);
+    double warm = elapsed;
+    while (warm < WARMUP_NS || elapsed < TARGET_REP_NS / 16)
+    {
+        iterations *= 2;
+        elapsed = time_run(bc, iterations);
+        warm += elapsed;
+    }
+    double per_op = elapsed / (double)iterations;
+    size_t rep_iterations = (size_t)(TARGET_REP_NS / (per_op > 0.0 ? per_op : 1.0));
+    if (rep_iterations == 0)
+        rep_iterations = 1;
+
+    double samples[REPS];
+    double sum = 0.0;
+    double min = 0.0;
+    for (size_t r = 0; r < REPS; ++r)
+    {
+        samples[r] = time_run(bc, rep_iterations) / (double)rep_iterations;
+        sum += samples[r];
+        if (r == 0 || samples[r] < min)
+            min = samples[r];
+    }
+    double mean = sum / REPS;
+    double var = 0.0;
+    for (size_t r = 0; r < REPS; ++r)
+        var += (samples[r] - mean) * (samples[r] - mean);
+    double stddev = sqrt(var / (REPS - 1));
+
+    char board_text[32] = "-";
+    if (bc->per_size)
+        snprintf(board_text, sizeof(board_text), "%dx%d", size->width, size->height);
+    printf("%-22s %-9s %12.2f %10.2f %6.1f%% %12.2f %12zu\n", bc->name, board_text, mean, stddev,
+           mean > 0.0 ? 100.0 * stddev / mean : 0.0, min, rep_iterations);
+    fflush(stdout);
+    bc->teardown();
+}
+
+int main(int argc, char **argv)
+{
+    const char *filter = argc > 1 ? argv[1] : NULL;
+    printf("%-22s %-9s %12s %10s %7s %12s %12s\n", "benchmark", "board", "ns/op", "stddev", "cv", "min", "iters/rep");
+    for (size_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); ++i)
+    {
+        const BenchCase *bc = CASES + i;
+        if (filter && !strstr(bc->name, filter))
+            continue;
+        size_t size_num = bc->per_size ? sizeof(SIZES) / sizeof(SIZES[0]) : 1;
+        for (size_t s = 0; s < size_num; ++s)
+            bench_one(bc, SIZES + s);
+    }
+    return 0;
+}
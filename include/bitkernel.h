@@ -0,0 +1,38 @@
+#ifndef BITKERNEL_H
+#define BITKERNEL_H
+
+#include <stdint.h>
+#include "types.h"
+#include "board.h"
+
+/* Width-specialized bitboard kernels for the plain sequential search:
+ * - One kernel per row type (8/16/32/64-bit rows), stamped out from a single template at compile time.
+ *   A row keeps BITKERNEL_ROW_PAD always-filled bits right of the board and the board is followed by
+ *   always-filled rows, so fit tests need no bounds checks and shape masks are compile-time constants.
+ * - The kernels try exactly the candidates of the general engine in the same order (next empty cell in
+ *   row-major order, type enum order, rotation order) and return the same first tiling.
+ * - Subtrees already proven dead are remembered (the board is fully determined by the four rows from the
+ *   next empty cell down and the remaining counts), so repeated states are pruned in one lookup. */
+
+#define BITKERNEL_ROW_PAD 3          /* a shape anchored at the last column reaches 3 cells further */
+#define BITKERNEL_MAX_WIDTH (64 - BITKERNEL_ROW_PAD)
+
+/* True if a kernel covers a width x height board (0 < width <= BITKERNEL_MAX_WIDTH). */
+bool bitkernel_supports(int width, int height);
+
+/* Name of the kernel bitkernel_solve picks for this width ("row8", "row16", "row32", "row64"), or NULL. */
+const char *bitkernel_name(int width);
+
+/* Search a tiling of the empty cells of board with the bag.
+ * - STATUS_OK: out_list[0..bag->total) holds the tiling and it is placed on board.
+ * - STATUS_ERR_UNSOLVABLE: no tiling exists, or node_limit (0: none) placements were made without finding
+ *   one (then *out_nodes == node_limit); board is unchanged.
+ * - STATUS_ERR_INVALID_ARGUMENT: unsupported size or the bag does not match the empty area.
+ * - out_nodes (optional) receives the number of placements made. */
+StatusCode bitkernel_solve(Board *board,
+                           const TetrominoBag *bag,
+                           uint64_t node_limit,
+                           Placement *out_list,
+                           uint64_t *out_nodes);
+
+#endif /* BITKERNEL_H */
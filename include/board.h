@@ -15,6 +15,13 @@ typedef struct Board Board;
 Board *board_create(int width, int height);
 void board_destroy(Board *b);
 
+/* Deep copy of a board (dimensions and content); NULL on allocation failure. */
+Board *board_clone(const Board *b);
+
+/* Copy reflected across the main diagonal: a height x width board whose cell (y,x) holds cell (x,y) of b
+ * (marks and obstacles alike); NULL on allocation failure. */
+Board *board_transpose(const Board *b);
+
 /* Basic properties */
 int board_width(const Board *b);
 int board_height(const Board *b);
@@ -25,6 +32,25 @@ size_t board_filled_count(const Board *b); /* currently filled cell count */
 bool board_in_bounds(const Board *b, int x, int y);
 bool board_is_empty(const Board *b, int x, int y);
 
+/* Obstacles: blocked cells are filled for good. They print as BOARD_BLOCKED_MARK, count as filled,
+ * and survive board_clear; no placement or single cell can ever go there.
+ * - board_block_cell: block an empty in-bounds cell; false and no change otherwise. */
+#define BOARD_BLOCKED_MARK '#'
+bool board_block_cell(Board *b, int x, int y);
+bool board_is_blocked(const Board *b, int x, int y);
+size_t board_blocked_count(const Board *b);
+
+/* Single cells (fragments of pieces placed elsewhere):
+ * - board_cell_mark: the mark at (x,y), '.' if empty, '\0' if out of bounds;
+ * - board_fill_cell: fill an empty in-bounds cell with mark (not '.' or BOARD_BLOCKED_MARK); false and no
+ *   change otherwise. */
+char board_cell_mark(const Board *b, int x, int y);
+bool board_fill_cell(Board *b, int x, int y, char mark);
+
+/* Occupancy of the 4x4 window whose top-left is (x,y): bit (dy * 4 + dx) is set iff cell (x+dx, y+dy)
+ * is in bounds and empty; out-of-bounds cells read as filled. Returns 0 if (x,y) is out of bounds. */
+uint16_t board_window_mask(const Board *b, int x, int y);
+
 /* Placement/removal:
  * - board_place: if the 4 target cells are in bounds and empty, fill them with mark and return true; otherwise return false and do not modify.
  * - board_remove: precondition—must match a prior successful placement (x,y,type,rotation,mark) exactly; otherwise behavior is undefined. */
@@ -34,7 +60,10 @@ void board_remove(Board *b, int x, int y, TetrominoType type, size_t rotation);
 /* Text visualization: print exactly height lines of width chars; '.' for empty, piece mark for filled; each line ends with '\n'. */
 void board_print(const Board *b, FILE *out);
 
-/* Clear the board content, keep dimensions, reset all cells to '.'. */
+/* Same format for rows [first, first+count) only; nothing is printed if the range is out of bounds. */
+void board_print_rows(const Board *b, int first, int count, FILE *out);
+
+/* Clear the board content, keep dimensions and obstacles, reset all other cells to '.'. */
 void board_clear(Board *b);
 
 #endif /* BOARD_H */
\ No newline at end of file
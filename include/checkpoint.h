@@ -0,0 +1,31 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "types.h"
+#include "search.h"
+
+/* Checkpoint files for long-running searches:
+ * - A checkpoint holds the board size, the bag, the obstacles, the search counters (nodes, restarts, RNG state,
+ *   solutions counted), the search mode (randomization, candidate order, cover), the fixed-prefix floor and
+ *   every stack frame (candidate list + cursor).
+ *   A work unit is simply a checkpoint whose floor equals its frame count. The board content is not stored: it is
+ *   rebuilt by replaying the placed candidate of each frame, then checked against the saved counts.
+ * - Integers are stored little-endian with fixed widths, so files move between hosts.
+ * - Saving writes to "<path>.tmp" first and renames it over path, so a crash mid-write never
+ *   destroys the previous checkpoint. */
+
+/* Save ctx between search_run calls, while every frame on the stack is placed (e.g. at SEARCH_YIELD).
+ * STATUS_ERR_INPUT on I/O failure. */
+StatusCode checkpoint_save(const char *path, const SearchContext *ctx, const TetrominoBag *bag);
+
+/* Read only the instance (board size, bag and obstacles) a checkpoint belongs to. *out_blocked receives
+ * width * height flags (row-major, heap, caller frees) or NULL without obstacles.
+ * STATUS_ERR_INPUT if unreadable. */
+StatusCode checkpoint_peek(const char *path, int *out_w, int *out_h, TetrominoBag *out_bag, bool **out_blocked);
+
+/* Restore a checkpoint into ctx, freshly set up by search_init with the same board (obstacles included) and bag.
+ * STATUS_ERR_INPUT if the file cannot be read, is malformed (including any stored candidate that could not
+ * have been generated for its frame), or belongs to another instance. */
+StatusCode checkpoint_load(const char *path, SearchContext *ctx, const TetrominoBag *bag);
+
+#endif /* CHECKPOINT_H */
@@ -0,0 +1,69 @@
+#ifndef CNF_H
+#define CNF_H
+
+#include <stdio.h>
+#include "types.h"
+#include "board.h"
+#include "sat.h"
+
+/* CNF encoding of a tiling instance, for the built-in SAT solver (sat.h) or an external one:
+ * - One variable per placement that fits the empty cells: anchors in row-major order, then type enum
+ *   order, then rotation order; variable i + 1 is placements[i]. Unlike the backtracking engines this
+ *   covers every placement, not only those anchored at the next empty cell, so the formula is
+ *   satisfiable exactly when the instance can be tiled.
+ * - Exactly one placement per empty cell: one at-least-one clause plus pairwise exclusions (each
+ *   overlapping pair once).
+ * - At most counts[t] placements per type t (sequential counter). Because the empty area equals
+ *   4 * bag->total, the per-cell constraints make every type count exact.
+ * - Checkerboard balance: only T covers unequal colours (3:1), so the T placements leaning each way are
+ *   bounded by the colour imbalance of the empty area. This is implied by the clauses above, but
+ *   clause learning alone needs exponential time to prove such parity arguments.
+ * - Stripe parity: under column (or row) stripes J and L always cover the colours 3:1, I/O/S/Z evenly
+ *   or 4:0, and T either way by rotation, so the J/L count fixes the parity of the T placements leaning
+ *   across the stripes (an XOR chain), or refutes the bag outright when there are no T's.
+ * - Decoded tilings are marked 'A'+(i%26) in row-major order of each piece's first cell. */
+
+typedef struct TilingCnf
+{
+    int width;
+    int height;
+    int var_num;
+    size_t clause_num;
+    int *lits;   /* clauses in DIMACS form, each terminated by 0 */
+    size_t lit_num;
+    size_t lit_cap;
+    Placement *placements; /* variable i + 1 places placements[i] */
+    size_t placement_num;
+    size_t piece_num; /* bag->total */
+} TilingCnf;
+
+/* Encode the empty cells of board with bag. STATUS_ERR_INVALID_ARGUMENT if the area does not match
+ * or the formula would exceed INT_MAX variables; STATUS_ERR_MEMORY on allocation failure. */
+StatusCode cnf_encode(const Board *board, const TetrominoBag *bag, TilingCnf *out);
+void cnf_free(TilingCnf *cnf);
+
+/* Write "p cnf" DIMACS, preceded by comment lines mapping each placement variable
+ * ("c placement <var> <type> <rotation> <x> <y>"). */
+StatusCode cnf_write_dimacs(const TilingCnf *cnf, FILE *out);
+
+/* Read a SAT solver's answer ("s SATISFIABLE"/"s UNSATISFIABLE" or "SAT"/"UNSAT", then literals,
+ * optionally on "v" lines; "c" lines are ignored). model needs var_num + 1 entries.
+ * STATUS_ERR_UNSOLVABLE if the answer is unsatisfiable, STATUS_ERR_INPUT if it cannot be read. */
+StatusCode cnf_read_model(const TilingCnf *cnf, FILE *in, bool *model);
+
+/* Place the pieces selected by model on board and write them to out_list (capacity >= piece_num).
+ * STATUS_ERR_INPUT if the model does not describe a tiling of the encoded instance. */
+StatusCode cnf_apply_model(const TilingCnf *cnf, const bool *model, Board *board, Placement *out_list);
+
+/* Encode, solve with the built-in solver and apply the model (same conventions as bitkernel_solve).
+ * After conflict_limit conflicts (0: no limit) the solver gives up: board is left unchanged,
+ * *out_limited (optional) is set and STATUS_ERR_UNSOLVABLE is returned without a proof.
+ * out_stats (optional) receives the solver statistics. */
+StatusCode cnf_solve(Board *board,
+                     const TetrominoBag *bag,
+                     uint64_t conflict_limit,
+                     Placement *out_list,
+                     SatStats *out_stats,
+                     bool *out_limited);
+
+#endif /* CNF_H */
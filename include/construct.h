@@ -0,0 +1,22 @@
+#ifndef CONSTRUCT_H
+#define CONSTRUCT_H
+
+#include <stddef.h>
+#include "types.h"
+#include "board.h"
+
+/* Constructive fast path for structurally easy instances:
+ * - Recognizes boards that decompose into a grid of small tileable blocks:
+ *     all O on an even x even board, all I when one side is divisible by 4,
+ *     and mixes that fit 4x2 / 2x4 pair blocks plus 4x4 blocks (e.g. TTTT, JJSS).
+ * - Builds the tiling directly in O(area) without any search.
+ * - Only applies to an empty board whose area equals 4 * bag->total.
+ * - Success (true): board is filled, out_list[0..bag->total) is written with marks
+ *   'A'+(i%26) in placement order. capacity must be >= bag->total.
+ * - No pattern matched (false): board and out_list are left unchanged. */
+bool construct_tiling(Board *board,
+                      const TetrominoBag *bag,
+                      Placement *out_list,
+                      size_t capacity);
+
+#endif /* CONSTRUCT_H */
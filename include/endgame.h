@@ -0,0 +1,51 @@
+#ifndef ENDGAME_H
+#define ENDGAME_H
+
+#include <stddef.h>
+#include "types.h"
+#include "board.h"
+
+/* Endgame table for small residual regions:
+ * - Once the empty area drops to ENDGAME_MAX_CELLS or fewer, the solver asks the table whether
+ *   the remaining region (shape relative to the next empty cell) and remaining counts can be tiled.
+ * - Entries are computed on first sight with the same try order as the solver (row-major next
+ *   empty cell, type enum order, rotation order), so the tiling returned is the one the full
+ *   search would have found; later sightings are a single lookup. Searches in another SearchOrder
+ *   therefore do not probe the table.
+ * - The table is a fixed-size direct-mapped cache; a collision simply overwrites the older entry.
+ * - Keys are independent of the board, so one table can serve every search a thread runs in a solve;
+ *   probing is not thread-safe. */
+
+#ifndef ENDGAME_MAX_CELLS
+#define ENDGAME_MAX_CELLS 16
+#endif
+#define ENDGAME_MAX_PIECES (ENDGAME_MAX_CELLS / 4)
+#define ENDGAME_TABLE_LOG2 14 /* capacity of the tables the solver creates */
+
+typedef struct EndgameTable EndgameTable;
+
+typedef enum EndgameResult
+{
+    ENDGAME_SKIP = 0, /* region not representable (too large or too spread out); search normally */
+    ENDGAME_TILEABLE, /* out_tail holds a tiling of the region */
+    ENDGAME_DEAD      /* region cannot be tiled with the remaining counts */
+} EndgameResult;
+
+/* Create/destroy a table with 2^capacity_log2 entries (capacity_log2 in [1,24]). */
+EndgameTable *endgame_create(unsigned capacity_log2);
+void endgame_destroy(EndgameTable *table);
+
+/* Probe the region of all empty cells at or after first_empty (row-major).
+ * - remaining_cells must be the number of empty cells on the board and equal 4 * sum(counts).
+ * - On ENDGAME_TILEABLE, out_tail[0..*out_num) are absolute placements in try order;
+ *   their mark fields are left for the caller to assign. out_tail needs ENDGAME_MAX_PIECES slots.
+ * - The board is not modified. */
+EndgameResult endgame_probe(EndgameTable *table,
+                            const Board *board,
+                            Cell first_empty,
+                            const size_t counts[TETRO_TYPE_COUNT],
+                            size_t remaining_cells,
+                            Placement *out_tail,
+                            size_t *out_num);
+
+#endif /* ENDGAME_H */
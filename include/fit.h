@@ -0,0 +1,25 @@
+#ifndef FIT_H
+#define FIT_H
+
+#include <stdint.h>
+#include "types.h"
+#include "tetromino.h"
+
+/* Fit kernel: decides every orientation at one anchor with a single window load.
+ * - The window is the 4x4 block whose top-left is the anchor; bit (dy * 4 + dx) is set iff cell
+ *   (x+dx, y+dy) is in bounds and empty (see board_window_mask).
+ * - Orientation i enumerates (type, rotation) type-major, rotation-minor, i.e. the candidate order:
+ *   I0 I1 O0 T0..T3 S0 S1 Z0 Z1 J0..J3 L0..L3 (FIT_ORIENTATION_NUM in total).
+ * - The implementation (AVX2, SSE2 or scalar) is chosen once, at first use, from the CPU features. */
+
+#define FIT_WINDOW 4
+#define FIT_ORIENTATION_NUM CANDS_MAX_SIZE
+#define FIT_ALL ((1u << FIT_ORIENTATION_NUM) - 1u) /* every orientation */
+
+/* Bit i of the result is set iff orientation i fits entirely into the empty cells of window. */
+uint32_t fit_orientations(uint16_t window);
+
+/* Name of the selected kernel: "avx2", "sse2" or "scalar". */
+const char *fit_kernel_name(void);
+
+#endif /* FIT_H */
@@ -0,0 +1,38 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include "types.h"
+
+/* Aggregate run metrics for batch processing (--metrics):
+ * - Every run is one observation of its wall-clock latency and search nodes, filed under the board area
+ *   bucket (cells: <= 64, 256, 1024, 4096, 16384, 65536, more; "unknown" when the input did not parse)
+ *   and the outcome.
+ * - Histograms use logarithmic buckets in the spirit of HDR histograms with one significant bit:
+ *   latency bounds are 2^k microseconds (1 us to about 71 minutes), node bounds are 4^k (1 to 4^24).
+ * - The CLI records one observation per process, after the run, so recording is a few plain additions
+ *   and touches nothing the search uses.
+ * - metrics_write adds what this process recorded since its previous write to the totals already in the
+ *   file, under a lock on FILE.lock, then replaces the file atomically (temp file and rename). Any number
+ *   of batch processes can share one file, and a node exporter's textfile collector never reads it
+ *   half-written. The file is Prometheus text exposition format. */
+
+typedef enum MetricsOutcome
+{
+    METRICS_SOLVED = 0,
+    METRICS_UNSOLVABLE,
+    METRICS_ERROR,
+    METRICS_OUTCOME_NUM
+} MetricsOutcome;
+
+/* Monotonic clock in nanoseconds, for latencies passed to metrics_record. */
+uint64_t metrics_clock_ns(void);
+
+/* Record one run; area is the board's cell count (0: unknown). Not thread-safe. */
+void metrics_record(size_t area, MetricsOutcome outcome, uint64_t latency_ns, uint64_t nodes);
+
+/* Merge this process's new observations into path (see above).
+ * STATUS_ERR_INPUT if the file cannot be locked, read back or replaced; STATUS_ERR_MEMORY on allocation failure. */
+StatusCode metrics_write(const char *path);
+
+#endif /* METRICS_H */
@@ -7,13 +7,20 @@
 /* Input format:
  * First line: two positive integers <width> <height>, e.g.,
  *   8 5
+ * Optional obstacle grid right after the sizes: exactly <height> rows of <width> cells, '.' open and
+ * 'x'/'X' blocked, e.g.,
+ *   ..x.....
+ *   (4 more rows)
  * Following lines: tetromino list (case-insensitive). Two token forms, can be mixed:
  *   1) Single letter: I O T S Z J L; each adds one piece.
  *   2) Counted: I*3 t*2; '*' followed by a positive integer.
  * From '#' to end of line is a comment. Blank lines ignored. Read until EOF.
  * Parsing does not judge tileability (e.g., non-divisible area is still valid input).
- * Output: width/height and TetrominoBag (total aggregated). On invalid input returns STATUS_ERR_INPUT. */
-StatusCode parse_from_stream(FILE *in, int *out_w, int *out_h, TetrominoBag *out_bag);
+ * Output: width/height and TetrominoBag (total aggregated). On invalid input returns STATUS_ERR_INPUT.
+ * *out_blocked receives the grid as width * height flags (row-major, heap, caller frees) or NULL without
+ * a grid; a caller passing out_blocked == NULL gets STATUS_ERR_INPUT for an input with a grid.
+ * A grid row must fit the 4096-byte line buffer (boards with a grid are at most 4094 cells wide). */
+StatusCode parse_from_stream(FILE *in, int *out_w, int *out_h, TetrominoBag *out_bag, bool **out_blocked);
 
 /* Print usage help to the given stream; should briefly show the format above. */
 void parser_print_usage(FILE *out);
@@ -0,0 +1,42 @@
+#ifndef PERFCOUNT_H
+#define PERFCOUNT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "types.h"
+
+/* Hardware performance counters around a solve (--perf):
+ * - perfcount_start opens one counter per event with perf_event_open (user space only, inherited by the
+ *   portfolio threads) and enables them; perfcount_stop disables, reads and closes them.
+ * - Each event is opened on its own, so a missing event (no PMU in a VM, perf_event_paranoid too strict,
+ *   not Linux) only drops that line of the report. Nothing here fails: without counters the report says so.
+ * - When the kernel multiplexes counters, values are scaled by time enabled / time running. */
+
+typedef enum PerfEvent
+{
+    PERF_EVENT_CYCLES = 0,
+    PERF_EVENT_INSTRUCTIONS,
+    PERF_EVENT_L1D_MISSES, /* L1 data cache read misses */
+    PERF_EVENT_LLC_MISSES, /* last-level cache misses */
+    PERF_EVENT_BRANCH_MISSES,
+    PERF_EVENT_NUM
+} PerfEvent;
+
+typedef struct PerfCounters
+{
+    int fds[PERF_EVENT_NUM]; /* -1: event not available */
+    bool valid[PERF_EVENT_NUM];
+    uint64_t values[PERF_EVENT_NUM];
+    bool scaled; /* at least one value was extrapolated from a multiplexed counter */
+} PerfCounters;
+
+/* Open and enable whatever counters the system provides. */
+void perfcount_start(PerfCounters *pc);
+
+/* Disable, read and close the counters opened by perfcount_start. */
+void perfcount_stop(PerfCounters *pc);
+
+/* Print the counters, per search node when nodes > 0, plus IPC, as "perf: ..." lines to out. */
+void perfcount_report(const PerfCounters *pc, uint64_t nodes, FILE *out);
+
+#endif /* PERFCOUNT_H */
@@ -0,0 +1,49 @@
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "types.h"
+
+/* Live progress reports for long searches:
+ * - progress_install registers a SIGUSR1 handler and, for a positive interval, a SIGALRM heartbeat
+ *   (setitimer). Both handlers only set a flag.
+ * - Engines keep the pointer from progress_flag (NULL until installed, so an unused feature costs one
+ *   pointer test), poll it at each placement and, when it is set, describe their state in a
+ *   ProgressSnapshot and call progress_report, which clears the flag and prints one line to stderr.
+ * - The explored fraction is estimated from the candidate cursors along the stack: frame i contributes
+ *   (finished siblings / siblings) times the share of its parent, as if the tree were uniform. */
+
+typedef struct ProgressSnapshot
+{
+    const char *kernel; /* engine name, as in SolverStats.kernel */
+    size_t depth;       /* pieces currently placed by the search */
+    size_t piece_num;   /* pieces in the bag */
+    size_t filled_cells;
+    size_t total_cells;
+    uint64_t nodes;  /* placements tried so far */
+    double explored; /* estimated fraction of the tree finished, in [0,1] */
+} ProgressSnapshot;
+
+/* Install the handlers; interval_secs == 0 installs SIGUSR1 only.
+ * STATUS_ERR_INVALID_ARGUMENT if a handler or the timer cannot be set up. */
+StatusCode progress_install(unsigned interval_secs);
+
+/* The flag the handlers set, or NULL if progress_install has not run. */
+const volatile sig_atomic_t *progress_flag(void);
+
+/* Clear the flag and print the snapshot, with the node rate since the previous report. Thread-safe. */
+void progress_report(const ProgressSnapshot *snap);
+
+/* Accumulate the explored estimate one frame at a time, from the bottom of the stack:
+ * *share starts at 1 and *explored at 0; done of total candidates are finished at this frame. */
+static inline void progress_descend(double *explored, double *share, size_t done, size_t total)
+{
+    if (total == 0)
+        return;
+    *explored += *share * (double)done / (double)total;
+    *share /= (double)total;
+}
+
+#endif /* PROGRESS_H */
@@ -0,0 +1,57 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include <stdio.h>
+#include "types.h"
+#include "board.h"
+#include "solver.h"
+
+/* Feasibility queries: which of many bags tile the same board.
+ * - One backtracking search runs with the envelope of the pending bags (per-type maximum counts), so
+ *   every explored prefix is shared by all bags it fits. A placement is kept only while some pending
+ *   bag still contains the pieces used so far; each complete tiling answers every bag equal to its
+ *   piece counts. The search stops once every bag is answered.
+ * - On an empty board each bag first goes through the constructive path; residual regions small enough
+ *   for the endgame table are probed with each bag's own remaining counts, and the search scans the board
+ *   in the direction a single solve would (SolverScan). Together with the candidate order of the general
+ *   engine, a bag is feasible exactly when a single solve of it succeeds, and its tiling is the one that
+ *   solve prints, on boards whose empty cells form one region (a single solve splits the others by
+ *   region, see regions.h, and may tile them differently).
+ * - Query file: one bag per line in the input token syntax ("I*2 O T*3"); '#' comments and blank lines
+ *   are ignored. A counted token may give a range ("T*0..2"), which expands the line into every
+ *   combination; of those, only bags whose area matches the board are kept. */
+
+#define QUERY_MAX_BAGS (1u << 20) /* limit on the bags a query file may expand to */
+
+typedef struct BagQuery
+{
+    TetrominoBag bag;
+    bool feasible;
+    Placement *tiling; /* bag.total placements when feasible, NULL otherwise */
+} BagQuery;
+
+typedef struct QuerySet
+{
+    BagQuery *items;
+    size_t num;
+    size_t cap;
+} QuerySet;
+
+/* Append a bag (not yet answered). STATUS_ERR_MEMORY on allocation failure. */
+StatusCode query_add(QuerySet *set, const TetrominoBag *bag);
+
+/* Parse a query file for a board with cell_num empty cells and append its bags.
+ * STATUS_ERR_INPUT on a malformed line or more than QUERY_MAX_BAGS bags. */
+StatusCode query_read(FILE *in, size_t cell_num, QuerySet *set);
+
+/* Answer every bag in set for the empty cells of board (board is unchanged afterwards), scanning as
+ * solver_solve_config would with scan. out_nodes (optional) receives the number of placements tried by the
+ * shared search. */
+StatusCode query_solve(Board *board, QuerySet *set, SolverScan scan, uint64_t *out_nodes);
+
+/* Format a bag in the input token syntax ("I*2 O T*3"; "-" for an empty bag). */
+void query_format_bag(const TetrominoBag *bag, char *buf, size_t size);
+
+void query_free(QuerySet *set);
+
+#endif /* QUERY_H */
@@ -0,0 +1,41 @@
+#ifndef REGIONS_H
+#define REGIONS_H
+
+#include <stdbool.h>
+#include "types.h"
+#include "board.h"
+#include "solver.h"
+
+/* Independent-region decomposition for boards whose empty cells fall apart into several 4-connected
+ * regions (walled off by obstacles or cells filled before the solve):
+ * - No piece spans two regions, so a tiling is one sub-tiling per region; the search only has to decide
+ *   how the bag is split, then solves every region on its own, and costs add up instead of multiplying.
+ * - Regions are taken smallest first and the largest one gets whatever the others leave. For each of the
+ *   others the sub-bags of area/4 pieces are enumerated, closest to the region's proportional share of the
+ *   remaining counts first, skipping those with too few T's (or the wrong parity) for the region's
+ *   checkerboard imbalance. A region's result for a sub-bag is memoized, and with config->threads > 1 up
+ *   to that many untried sub-bags of a region are solved at once.
+ * - Each region runs solver_solve_config on a board of its bounding box with every other cell blocked,
+ *   single-threaded, so the chosen split and the tiling do not depend on the thread count.
+ * - A region's first empty cells in scan order are those of the whole board, so the anchored search fails
+ *   on every split only when it fails on the whole board scanned the same way: an exhausted enumeration is
+ *   a proof of unsolvability (each region picks its scan from its own bounding box, see SolverScan).
+ *   Past REGIONS_MAX_SUB_BAGS sub-bags for one region or REGIONS_MAX_SOLVES region solves the
+ *   decomposition gives up and the caller runs the plain search. */
+
+#define REGIONS_MAX_SUB_BAGS 4096 /* sub-bags enumerated for one region */
+#define REGIONS_MAX_SOLVES 1024   /* region solves across all splits */
+
+/* Decompose and solve (config must be valid, without checkpoint or resume, and bag->total * 4 must equal
+ * the empty cell count; see solver_solve_config).
+ * - true: *out_res holds the answer with solver_solve_config's contract for board and out_list; on success
+ *   out_list is in row-major order of anchors with marks 'A'+(i%26). stats->nodes sums the region solves.
+ * - false: fewer than two regions, or a limit was hit; board, out_list and stats are left unchanged. */
+bool regions_solve(Board *board,
+                   const TetrominoBag *bag,
+                   const SolverConfig *config,
+                   Placement *out_list,
+                   SolverStats *stats,
+                   StatusCode *out_res);
+
+#endif /* REGIONS_H */
@@ -0,0 +1,65 @@
+#ifndef RESOLVE_H
+#define RESOLVE_H
+
+#include <stdio.h>
+#include "types.h"
+#include "board.h"
+#include "solver.h"
+
+/* Incremental re-solve from a previous tiling after a small edit (another bag, a resized board):
+ * - The previous tiling is read back from board_print output. Pieces are the 4-cell groups of one mark
+ *   that form a tetromino; marks repeat every 26 pieces, so a group that touches another piece with the
+ *   same mark is not recovered and its cells are simply tiled again.
+ * - Previous pieces that still fit the board are kept. The repair starts from the cells they leave
+ *   uncovered and, for every type the new bag holds fewer of than were kept, from the kept pieces of that
+ *   type nearest to those cells (the last ones in row-major order when nothing is uncovered).
+ * - Each round rips up the kept pieces within radius cells (Chebyshev distance) of the freed cells and
+ *   tiles the empty area with the rest of the bag, a general engine search limited to
+ *   RESOLVE_ROUND_NODE_LIMIT nodes. The radius goes 0 (the freed cells alone), 1, 2, 4, ... after every
+ *   failed round; once it spans the board, solver_solve_config runs without any previous piece as a
+ *   last resort. */
+
+#define RESOLVE_ROUND_NODE_LIMIT (1ull << 16) /* placements tried per neighbourhood round */
+
+/* A tiling read back from solver output. */
+typedef struct PreviousTiling
+{
+    int width;
+    int height;
+    Placement *pieces; /* recovered pieces, marks as read */
+    size_t num;
+    size_t lost_cells; /* filled cells not recovered as a piece */
+} PreviousTiling;
+
+typedef struct ResolveStats
+{
+    size_t kept;      /* previous pieces in the result */
+    size_t previous;  /* previous pieces read */
+    unsigned rounds;  /* neighbourhood rounds run */
+    int radius;       /* radius of the round that succeeded; -1 if none did */
+    bool full_solve;  /* the last resort ran; solver holds its statistics */
+    uint64_t nodes;   /* placements tried by the rounds and the full solve */
+    SolverStats solver;
+} ResolveStats;
+
+/* Read a tiling in board_print format: lines of equal length made of '.', letters and obstacles
+ * (BOARD_BLOCKED_MARK, ignored: the new board brings its own; blank lines are skipped).
+ * STATUS_ERR_INPUT if that is not what in holds, STATUS_ERR_MEMORY on allocation failure. */
+StatusCode resolve_read_tiling(FILE *in, PreviousTiling *out);
+void resolve_tiling_free(PreviousTiling *prev);
+
+/* Same contract as solver_solve_config, re-using the pieces of prev (read for a board of any size), except
+ * for the marks of a repaired tiling: out_list is in row-major order of first cells, kept pieces keep
+ * their marks and new ones take the first letter no touching piece uses, so the output diffs cleanly
+ * against the previous one. The full solve marks as usual.
+ * config (NULL: defaults) only applies to the full solve, except that its endgame table (or one created
+ * here) serves the rounds as well. out_stats may be NULL. */
+StatusCode resolve_solve(Board *board,
+                         const TetrominoBag *bag,
+                         const PreviousTiling *prev,
+                         const SolverConfig *config,
+                         Placement *out_list,
+                         size_t *inout_count,
+                         ResolveStats *out_stats);
+
+#endif /* RESOLVE_H */
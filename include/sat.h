@@ -0,0 +1,57 @@
+#ifndef SAT_H
+#define SAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "types.h"
+
+/* A small CDCL SAT solver:
+ * - Variables are numbered 1..n and literals use the DIMACS convention (v or -v).
+ * - Two watched literals per clause, first-UIP learning with local minimization, VSIDS decisions
+ *   with phase saving, Luby restarts, and periodic reduction of learnt clauses by LBD.
+ * - Clauses are added before sat_solve; the solver is single-shot (no incremental assumptions). */
+
+typedef struct SatSolver SatSolver;
+
+typedef enum SatResult
+{
+    SAT_SATISFIABLE = 0,
+    SAT_UNSATISFIABLE,
+    SAT_ERROR,  /* allocation failure while solving */
+    SAT_UNKNOWN /* the conflict limit was reached first */
+} SatResult;
+
+typedef struct SatStats
+{
+    uint64_t decisions;
+    uint64_t conflicts;
+    uint64_t propagations;
+    uint64_t restarts;
+    uint64_t learnts; /* learnt clauses currently kept */
+} SatStats;
+
+/* Create a solver with var_num variables (more can be added with sat_new_var); NULL on allocation failure. */
+SatSolver *sat_create(int var_num);
+void sat_destroy(SatSolver *s);
+
+/* Add a fresh variable and return its number (> 0), or 0 on allocation failure. */
+int sat_new_var(SatSolver *s);
+int sat_var_count(const SatSolver *s);
+
+/* Add a clause of DIMACS literals (0 is not a terminator here and is rejected).
+ * STATUS_ERR_INVALID_ARGUMENT for a literal out of range, STATUS_ERR_MEMORY on allocation failure.
+ * An empty clause (or one falsified by earlier units) makes the formula unsatisfiable. */
+StatusCode sat_add_clause(SatSolver *s, const int *lits, size_t lit_num);
+
+/* Stop sat_solve with SAT_UNKNOWN after limit conflicts (in total, see SatStats); 0: no limit. */
+void sat_set_conflict_limit(SatSolver *s, uint64_t limit);
+
+/* Solve the clauses added so far. */
+SatResult sat_solve(SatSolver *s);
+
+/* After SAT_SATISFIABLE: value of var in the model. */
+bool sat_model_value(const SatSolver *s, int var);
+
+void sat_stats(const SatSolver *s, SatStats *out);
+
+#endif /* SAT_H */
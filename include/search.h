@@ -0,0 +1,153 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include <signal.h>
+#include "types.h"
+#include "board.h"
+#include "tetromino.h"
+#include "endgame.h"
+
+/* Backtracking search engine shared by the solver front-ends.
+ * The whole search state is explicit: a stack of frames, each holding the candidate
+ * placements generated for one empty cell and a cursor (idx) to the one currently placed.
+ * Invariant between calls: every frame 0..top has its cands[idx] placed on the board.
+ * Frames below floor are fixed (e.g. the prefix of a work unit): the search never backtracks into them.
+ * Candidates are anchored by the top-left corner of their bounding box at the first empty cell, which misses
+ * tilings whose piece covering that cell has its first cell further right (S, Z, T, J, L in some rotations).
+ * In cover mode every orientation is instead anchored so that it covers the cell; each tiling is then reached
+ * exactly once, which counting, enumeration and work units rely on. */
+
+// a frame in the solver stack
+typedef struct SolverFrame
+{
+    size_t cands_size;
+    int idx;
+    Placement cands[CANDS_MAX_SIZE];
+} SolverFrame;
+
+// solver stack for backtracking
+typedef struct SolverStack
+{
+    size_t capacity;
+    int top;
+    SolverFrame frames[];
+} SolverStack;
+
+/* Value ordering: the order in which piece types are tried at each new frame, re-ranked from the current
+ * counts every time. Rotations of one type stay in rotation order and ties keep enum order.
+ * - TYPE: enum order I, O, T, S, Z, J, L (the default, and the only order the bitboard kernels and the
+ *   endgame table implement: searches in other orders do not probe the table);
+ * - SCARCE: fewest remaining copies first, so a lone S or Z is placed while the board is still open
+ *   instead of failing deep in the tree (every type shares the same demand, the pieces still to place);
+ * - FITS: fewest orientations that fit at the target cell first, then SCARCE.
+ * Adding a policy takes a rank function and a name in search.c. */
+typedef enum SearchOrder
+{
+    SEARCH_ORDER_TYPE = 0,
+    SEARCH_ORDER_SCARCE,
+    SEARCH_ORDER_FITS,
+    SEARCH_ORDER_NUM
+} SearchOrder;
+
+/* Why search_run returned. */
+typedef enum SearchOutcome
+{
+    SEARCH_SOLVED = 0,  /* board fully tiled; frames 0..top hold the solution */
+    SEARCH_EXHAUSTED,   /* tree exhausted; only the frames below floor remain placed */
+    SEARCH_NODE_LIMIT,  /* node_limit reached; state is consistent and can be resumed or unwound */
+    SEARCH_CANCELLED,   /* *cancel became true; same state guarantees as SEARCH_NODE_LIMIT */
+    SEARCH_YIELD,       /* yield_interval nodes elapsed or *progress is set; call search_run again to continue */
+    SEARCH_DEPTH_LIMIT, /* depth_limit frames are placed and a new frame is due; see search_backtrack */
+    SEARCH_ERROR        /* see SearchContext.error */
+} SearchOutcome;
+
+typedef struct SearchContext
+{
+    Board *board;
+    SolverStack *stack;
+    EndgameTable *endgame; /* optional, not owned; NULL disables endgame lookups, as does an order other than TYPE */
+    /* static placement index, built by search_init on boards with obstacles (NULL otherwise): per cell,
+     * the orientations anchored there that avoid the walls and every cell filled at init */
+    uint32_t *static_fits;
+    size_t counts[TETRO_TYPE_COUNT];
+    size_t filled_cells;
+    size_t target_cells;
+    bool need_new_frame; /* true: the next step expands a new frame at the next empty cell */
+
+    SearchOrder order; /* candidate order of new frames */
+    bool cover;        /* complete search: new frames cover the target cell (no endgame lookups) */
+    bool randomize; /* shuffle each frame's candidates with rng (after ordering) */
+    uint64_t rng;   /* xorshift state; never 0 */
+    uint64_t nodes; /* candidate placements tried so far */
+    uint64_t node_limit; /* stop with SEARCH_NODE_LIMIT when nodes reaches it; 0 = unlimited */
+    uint64_t yield_interval; /* return SEARCH_YIELD every this many nodes; 0 = never */
+    const atomic_bool *cancel; /* optional external stop flag, polled cheaply */
+    const volatile sig_atomic_t *progress; /* optional report request (progress.h); yields while set */
+    /* optional: called after each placement (every frame placed); true skips the subtree below it */
+    bool (*prune)(const struct SearchContext *ctx, void *arg);
+    void *prune_arg;
+    int floor;       /* number of fixed frames at the bottom of the stack */
+    int depth_limit; /* stop with SEARCH_DEPTH_LIMIT before expanding frame depth_limit; 0 = none */
+    uint64_t solutions; /* solutions counted so far (counting runs) */
+    StatusCode error;
+
+    /* restart bookkeeping owned by the caller; kept here so checkpoints capture it */
+    size_t restart_base;
+    uint64_t restarts;
+} SearchContext;
+
+/* Set up a search over board with the given bag.
+ * - The board may be partially filled; target is filled + 4 * bag->total and must equal the board area
+ *   (otherwise STATUS_ERR_UNSOLVABLE and nothing is allocated).
+ * - bag->total is the number of pieces a tiling uses; the counts may add up to more (an envelope of
+ *   several bags, see query.h), in which case only combinations the counts allow are tried.
+ * - endgame (optional, owned by the caller) settles small residual regions; consecutive searches on one
+ *   thread may share it, concurrent ones may not.
+ * - On a board with obstacles the static placement index is built as well; an empty cell no placement
+ *   can cover makes the instance STATUS_ERR_UNSOLVABLE up front. */
+StatusCode search_init(SearchContext *ctx, Board *board, const TetrominoBag *bag, EndgameTable *endgame);
+
+/* Free the stack and placement index; the board and the endgame table are not touched. */
+void search_release(SearchContext *ctx);
+
+/* Run (or continue) the search until one of the SearchOutcome conditions. */
+SearchOutcome search_run(SearchContext *ctx);
+
+/* Remove every placement above floor and pop those frames, restoring the board to the fixed prefix. */
+void search_unwind(SearchContext *ctx);
+
+/* Undo the top frame's placement so the next search_run continues with its next candidate.
+ * Used after SEARCH_SOLVED (to look for further solutions) or SEARCH_DEPTH_LIMIT (to skip the subtree).
+ * Returns false if the top frame is fixed (below floor) or the stack is empty: nothing is left to search. */
+bool search_backtrack(SearchContext *ctx);
+
+/* Push a frame whose cands[idx] is placed immediately (used to rebuild saved or exported states).
+ * Fails with STATUS_ERR_INPUT if the frame is malformed: idx out of range, or any candidate with an unknown
+ * type or rotation, of a type with no pieces left, or not fitting the board as it is before the push. */
+StatusCode search_push_placed(SearchContext *ctx, const SolverFrame *frame);
+
+/* Copy the placements of frames 0..top to out (needs top+1 slots); returns the number written. */
+size_t search_placements(const SearchContext *ctx, Placement *out);
+
+/* Engine primitives, exposed for benchmarks:
+ * - search_next_empty: first empty cell in row-major order, {-1,-1} if the board is full;
+ * - search_candidates: placements anchored at (x,y) (or, with cover, covering it) that fit and have pieces left
+ *   in counts, in SEARCH_ORDER_TYPE order, written to out_cands (CANDS_MAX_SIZE slots); returns how many. */
+Cell search_next_empty(const Board *board);
+size_t search_candidates(const Board *board, int x, int y, char mark, const size_t *counts, bool cover,
+                         Placement *out_cands);
+
+/* Estimated fraction of the tree above floor already searched, from the frame cursors (see progress.h). */
+double search_explored(const SearchContext *ctx);
+
+/* Policy name ("type", "scarce", "fits") and lookup; search_order_from_name returns SEARCH_ORDER_NUM
+ * for an unknown name. */
+const char *search_order_name(SearchOrder order);
+SearchOrder search_order_from_name(const char *name);
+
+/* Seed the candidate shuffler (a zero seed is remapped to a fixed non-zero state). */
+void search_seed(SearchContext *ctx, uint64_t seed);
+
+#endif /* SEARCH_H */
@@ -4,6 +4,7 @@
 #include <stddef.h>
 #include "types.h"
 #include "board.h"
+#include "search.h"
 
 /* 求解接口：
  * - out_list 的容量必须 >= bag->total；调用前 *inout_count 需设为该容量；
@@ -18,4 +19,134 @@ StatusCode solver_solve(Board *board,
                         Placement *out_list,
                         size_t *inout_count);
 
-#endif /* SOLVER_H */
\ No newline at end of file
+/* 搜索后端：
+ * - AUTO：普通的单线程确定性求解（不随机化、无检查点/续跑）在宽度适用时走位棋盘专用内核（bitkernel.h），
+ *   其余情况走通用引擎；两者按相同顺序搜索，结果一致；
+ * - GENERIC：总是走通用引擎；
+ * - SAT：编码为 CNF 后由内置 CDCL 求解器求解（cnf.h）。它考虑所有放置而非只在首个空格锚定，
+ *   可能解出回溯搜索报告无解的实例，给出的铺法也可能不同；冲突数超出预算时转交回溯搜索（同 AUTO）；
+ *   仅支持单线程、不随机化、默认候选顺序、无检查点/续跑，且不支持计数。 */
+typedef enum SolverEngine
+{
+    SOLVER_ENGINE_AUTO = 0,
+    SOLVER_ENGINE_GENERIC,
+    SOLVER_ENGINE_SAT
+} SolverEngine;
+
+/* 扫描方向：回溯搜索总是在首个空格（行优先）锚定，棋盘越宽，搜索前沿越宽、剪枝越弱。
+ * - AUTO：宽大于高时按转置后的棋盘搜索（相当于列优先扫描），否则行优先；
+ * - ROW：总是行优先（本选项出现前的行为）；
+ * - COLUMN：总是转置后搜索。
+ * 转置搜索时 S 与 Z、J 与 L 互换，解再映射回原棋盘，out_list 为转置搜索的放置顺序（即原棋盘的列优先顺序）；
+ * 由于锚定搜索并不完备，两种方向找到的铺法可能不同，个别实例上可解性也可能不同。SAT 后端不受影响；
+ * 设置了 checkpoint_path 或 resume_path 的求解（含工作单元）总是行优先。 */
+typedef enum SolverScan
+{
+    SOLVER_SCAN_AUTO = 0,
+    SOLVER_SCAN_ROW,
+    SOLVER_SCAN_COLUMN,
+    SOLVER_SCAN_NUM
+} SolverScan;
+
+/* 搜索配置（先用 solver_config_init 填默认值）：
+ * - randomize：每个帧内随机打乱候选顺序，种子为 seed；
+ * - restart_base：Luby 重启单位（节点数），仅在 randomize 时生效；0 表示不重启；
+ * - threads：组合（portfolio）搜索的线程数；worker 0 按本配置运行，
+ *   worker i>0 使用 seed+i 随机化并带 Luby 重启，返回最先完成者的结果；
+ * - deterministic：threads > 1 时不跑组合搜索，而是把搜索树在固定深度切成有序子树，由各线程按顺序领取；
+ *   子树 i 找到解时只取消 i 右侧的子树，最终取最左侧有解子树中的第一个解，
+ *   因而结果（含标记顺序）与单线程 solver_solve 完全一致；不能与 randomize 同用；
+ * - checkpoint_path：非 NULL 时每隔 checkpoint_interval 秒把搜索状态写入该文件；
+ * - resume_path：非 NULL 时从该检查点继续搜索（随机化/重启设置以检查点为准）。
+ *   检查点与续跑仅支持单线程（threads == 1）；
+ * - engine：搜索后端，见 SolverEngine；
+ * - order：候选的类型顺序（值排序策略），见 search.h 的 SearchOrder；非默认顺序只走通用引擎，
+ *   续跑时以检查点中保存的顺序为准；
+ * - scan：扫描方向，见 SolverScan；检查点与续跑总是行优先，不看此项；
+ * - endgame：可选的残局表（endgame.h），由调用方创建与释放，可供同一线程上先后进行的求解复用；
+ *   NULL 时每次求解自建一张，由调用线程上的全部搜索共用，其余线程上的 worker 各建一张；
+ * - node_limit：非 0 时为 solver_solve_config 一次求解的放置次数预算，用尽即放弃并返回 STATUS_ERR_UNSOLVABLE
+ *   （并不证明无解，stats.limited 为 true）；仅支持单线程、非 SAT、无检查点/续跑，且不做区域拆分。 */
+typedef struct SolverConfig
+{
+    bool randomize;
+    uint64_t seed;
+    size_t restart_base;
+    size_t threads;
+    bool deterministic;
+    const char *checkpoint_path;
+    unsigned checkpoint_interval;
+    const char *resume_path;
+    SolverEngine engine;
+    SearchOrder order;
+    SolverScan scan;
+    EndgameTable *endgame;
+    uint64_t node_limit;
+} SolverConfig;
+
+/* 求解统计：产出结果的那次搜索的节点数（SAT 后端为决策次数）、重启次数、种子与重启单位（用于复现）。 */
+typedef struct SolverStats
+{
+    uint64_t nodes;
+    uint64_t restarts;
+    bool randomized; /* false: 结果来自确定性的枚举顺序，seed 无意义 */
+    uint64_t seed;
+    size_t restart_base; /* 0: 未重启 */
+    size_t worker;
+    uint64_t checkpoints_written;
+    uint64_t checkpoint_failures;
+    const char *kernel; /* 产出结果的后端名（"construct"、"regions"、"generic"、"row16"、"sat" 等） */
+    bool limited;       /* 因 node_limit 用尽而放弃 */
+} SolverStats;
+
+#define SOLVER_DEFAULT_RESTART_BASE 4096
+#define SOLVER_MAX_THREADS 256
+#define SOLVER_DEFAULT_CHECKPOINT_INTERVAL 60
+
+/* 默认配置：不随机化、不重启、单线程（组合搜索）、不写检查点、自动选择后端与扫描方向、按类型枚举顺序尝试候选。 */
+void solver_config_init(SolverConfig *config);
+
+/* 与 solver_solve 相同的约定，按 config 搜索；config 为 NULL 时等同默认配置。
+ * out_stats 可为 NULL。threads 超出 [1, SOLVER_MAX_THREADS] 返回 STATUS_ERR_INVALID_ARGUMENT。
+ * 空格分成多个互不连通的区域时（非 SAT、无检查点/续跑），先按区域拆分求解（regions.h），结果与线程数无关。 */
+StatusCode solver_solve_config(Board *board,
+                               const TetrominoBag *bag,
+                               const SolverConfig *config,
+                               Placement *out_list,
+                               size_t *inout_count,
+                               SolverStats *out_stats);
+
+/* 计数接口：枚举全部解并将数量写入 *out_count（不走构造捷径与残局表，忽略重启，总是行优先扫描）。
+ * - 搜索以覆盖模式进行（search.h）：候选覆盖首个空格而非以包围盒左上角锚定，每种铺法恰好计一次，计数是精确的；
+ * - 成功返回 STATUS_OK（0 个解同样是 STATUS_OK）；结束后 board 与调用前一致；
+ * - 支持 checkpoint_path / resume_path（已计数的数量随检查点保存）；续跑的检查点须由计数或工作单元切分写出，
+ *   普通求解的检查点返回 STATUS_ERR_INPUT；threads 必须为 1，engine 不能为 SAT。 */
+StatusCode solver_count(Board *board,
+                        const TetrominoBag *bag,
+                        const SolverConfig *config,
+                        uint64_t *out_count,
+                        SolverStats *out_stats);
+
+/* 逐个枚举接口（流式输出全部解）：
+ * - solver_iter_begin 建立搜索并保留显式栈，之后每次 solver_iter_next 从上一个解之后继续，
+ *   不会从根重新搜索；与 solver_count 一样以覆盖模式搜索，恰好给出全部解、各一次，顺序与其枚举顺序相同
+ *   （不走构造捷径与残局表）；第一个解因此可能与 solver_solve 找到的不同；
+ * - config 为 NULL 时等同默认配置；支持 order 与 randomize（只打乱候选顺序，不重启）；
+ *   threads 必须为 1，engine 不能为 SAT，不支持检查点/续跑，否则返回 STATUS_ERR_INVALID_ARGUMENT；
+ * - solver_iter_next 的 out_list / inout_count 约定与 solver_solve 相同：
+ *     STATUS_OK：写入下一个解，board 被填充为该解（到下一次调用或 solver_iter_end 前有效）；
+ *     STATUS_ERR_UNSOLVABLE：没有更多解（面积不符时第一次调用即返回），*inout_count 写为 0，board 恢复为开始时的状态；
+ * - solver_iter_end 撤销棋盘上的放置（恢复为开始时的状态）并释放迭代器；iter 可为 NULL。 */
+typedef struct SolverIter SolverIter;
+
+StatusCode solver_iter_begin(Board *board,
+                             const TetrominoBag *bag,
+                             const SolverConfig *config,
+                             SolverIter **out_iter);
+StatusCode solver_iter_next(SolverIter *iter, Placement *out_list, size_t *inout_count);
+void solver_iter_end(SolverIter *iter);
+
+/* 迭代器至今尝试的放置数（节点数）。 */
+uint64_t solver_iter_nodes(const SolverIter *iter);
+
+#endif /* SOLVER_H */
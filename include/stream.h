@@ -0,0 +1,46 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "types.h"
+
+/* Band streaming for boards too tall to hold in memory:
+ * - Only a window of 2 * band_rows + 3 rows is resident (and, near the bottom, the last rows of the board, see
+ *   below). A band search fills the window's first 2 * band_rows rows in the engine's scan order, with
+ *   candidates covering each first empty cell (pieces may stick into the 3 rows below); the first
+ *   band_rows rows are then committed: printed to out and dropped. The second band only proves that the
+ *   committed boundary profile can be continued; it is searched again as the first band of the next
+ *   window. Pieces sticking out of a committed band stay in the window, shifted up.
+ * - Types are tried in order of the largest remaining share of their initial count, so every band
+ *   draws on the bag in proportion and the remainder stays balanced.
+ * - The last band is the first one with at most STREAM_TAIL_WINDOWS windows of rows below it. It is searched
+ *   without the lookahead: each way of filling it is accepted only once the regular solver tiles all the rows
+ *   below it with what is left, within STREAM_TAIL_TRIAL_NODE_LIMIT nodes, and that tiling is printed after
+ *   it. So the pieces the bottom rows need are never spent on the bands above them. A board no taller than
+ *   one window goes to the regular solver as a whole, with the node budget of a band.
+ * - Streaming is greedy across bands: a committed band is never revisited. If a band search fails (no
+ *   profile found within STREAM_BAND_NODE_LIMIT nodes, the last band's trials included) or a board of one
+ *   window cannot be tiled within that budget, STATUS_ERR_UNSOLVABLE is returned after the rows already
+ *   written; that does not prove the instance unsolvable. */
+
+#define STREAM_BAND_NODE_LIMIT (1ull << 24)       /* placements tried per band (or single solve) before giving up */
+#define STREAM_TAIL_TRIAL_NODE_LIMIT (1ull << 16) /* placements tried per trial tiling of the last rows */
+#define STREAM_TAIL_WINDOWS 2                     /* the last rows tiled in one piece span up to this many windows */
+
+typedef struct StreamStats
+{
+    uint64_t nodes;   /* placements tried by the band searches, their tail trials and any single solve */
+    size_t bands;     /* bands committed before the last rows */
+    size_t rows_done; /* rows written to out */
+    int stuck_row;    /* on failure: first row that could not be tiled; -1 otherwise */
+} StreamStats;
+
+/* Tile a width x height board with bag, writing rows to out as they are committed (board_print format).
+ * - STATUS_ERR_UNSOLVABLE: area mismatch (nothing written) or the streaming search got stuck (see above);
+ * - STATUS_ERR_INVALID_ARGUMENT: band_rows == 0 or a non-positive size; STATUS_ERR_MEMORY on allocation failure.
+ * out_stats may be NULL. */
+StatusCode stream_solve(int width, int height, const TetrominoBag *bag, size_t band_rows, FILE *out,
+                        StreamStats *out_stats);
+
+#endif /* STREAM_H */
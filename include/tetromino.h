@@ -35,4 +35,11 @@ size_t tetro_rotation_count(TetrominoType type);
  * Coordinates/anchor/rotation follow the contract above. */
 size_t tetro_get_cells(TetrominoType type, size_t rotation, Cell out_cells[4]);
 
+/* Reflection across the main diagonal (x <-> y), used to search a board transposed:
+ * - tetro_transposed_type: the type of a reflected shape (S <-> Z, J <-> L, the others map to themselves);
+ * - tetro_transpose_placement: reflect p in place; the anchor becomes (y,x), the type its reflection and the
+ *   rotation the one whose cells are the reflected cells. p must hold a valid type and rotation. */
+TetrominoType tetro_transposed_type(TetrominoType type);
+void tetro_transpose_placement(Placement *p);
+
 #endif /* TETROMINO_H */
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef WORKUNIT_H
+#define WORKUNIT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "types.h"
+#include "board.h"
+
+/* Work units for spreading one search across independent processes:
+ * - workunit_split expands the search to a fixed depth and writes every open subtree as a unit file:
+ *   a checkpoint (see checkpoint.h) whose frames form a fixed prefix (board prefix, remaining counts,
+ *   and each frame's candidate list with its cursor). Units are numbered in sequential search order.
+ * - The split and the units search in cover mode (search.h), so the units partition every tiling: counts
+ *   add up to the exact total and a unit found unsolvable has no tiling at all.
+ * - A unit is solved or counted with the regular solver by resuming from it; its result is written
+ *   as a small text file with workunit_write_result.
+ * - workunit_merge combines result files: counted results are summed; otherwise the first solved
+ *   result in the given order wins (the first tiling of a cover-mode enumeration, as solver_count would
+ *   meet them, when the files are passed in unit order), and the instance is unsolvable if every unit is. */
+
+typedef enum WorkOutcome
+{
+    WORK_SOLVED = 0,
+    WORK_UNSOLVABLE,
+    WORK_COUNTED
+} WorkOutcome;
+
+typedef struct WorkResult
+{
+    WorkOutcome outcome;
+    int width;
+    int height;
+    uint64_t count;         /* WORK_COUNTED: number of tilings */
+    size_t placement_num;   /* WORK_SOLVED: number of placements */
+    Placement *placements;  /* WORK_SOLVED: heap array owned by the result */
+    bool *blocked;          /* width * height obstacle flags (row-major), NULL without obstacles; owned by
+                               the result when read or merged */
+} WorkResult;
+
+/* Write "<dir>/unit-NNNNNN.ckpt" for every subtree at the given depth (depth >= 1).
+ * Subtrees that close before the depth (full tilings) are written as units too.
+ * *out_units receives the number of files written. The board must be empty apart from obstacles. */
+StatusCode workunit_split(Board *board,
+                          const TetrominoBag *bag,
+                          size_t depth,
+                          const char *dir,
+                          size_t *out_units);
+
+/* Write/read one result file. Reading fills out (free with workunit_result_free). */
+StatusCode workunit_write_result(const char *path, const WorkResult *result);
+StatusCode workunit_read_result(const char *path, WorkResult *out);
+void workunit_result_free(WorkResult *result);
+
+/* Merge result files in the given order into out (free with workunit_result_free).
+ * STATUS_ERR_INPUT if a file is unreadable or the results disagree on board size, obstacles or mode. */
+StatusCode workunit_merge(const char *const *paths, size_t path_num, WorkResult *out);
+
+#endif /* WORKUNIT_H */
@@ -0,0 +1,306 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "bitkernel.h"
+#include "progress.h"
+
+/* Bitboard kernel implementation:
+ *   - Orientation masks as constant tables (row dy of the 4x4 box, bit dx), in candidate order.
+ *   - A direct-mapped cache of dead states shared by the kernels.
+ *   - Progress reports rebuild each frame's candidate count by peeling placements off a copy of the rows.
+ *   - bitkernel_tmpl.h instantiated for 8/16/32/64-bit rows, and a dispatcher by board width. */
+
+#define BIT_ORIENTATION_NUM 19
+#define DEAD_TABLE_LOG2 16
+#define MARK_NUM 26 // 26 letters from A-Z
+
+// orientation i: (type, rotation) in candidate order, and its four row masks
+static const TetrominoType BIT_TYPES[BIT_ORIENTATION_NUM] = {
+    TETRO_I, TETRO_I, TETRO_O, TETRO_T, TETRO_T, TETRO_T, TETRO_T, TETRO_S, TETRO_S, TETRO_Z,
+    TETRO_Z, TETRO_J, TETRO_J, TETRO_J, TETRO_J, TETRO_L, TETRO_L, TETRO_L, TETRO_L};
+static const size_t BIT_ROTATIONS[BIT_ORIENTATION_NUM] = {0, 1, 0, 0, 1, 2, 3, 0, 1, 0, 1, 0, 1, 2, 3, 0, 1, 2, 3};
+static const uint8_t BIT_MASKS[BIT_ORIENTATION_NUM][4] = {
+    {0xF, 0x0, 0x0, 0x0}, // I0
+    {0x1, 0x1, 0x1, 0x1}, // I1
+    {0x3, 0x3, 0x0, 0x0}, // O0
+    {0x7, 0x2, 0x0, 0x0}, // T0
+    {0x2, 0x3, 0x2, 0x0}, // T1
+    {0x2, 0x7, 0x0, 0x0}, // T2
+    {0x1, 0x3, 0x1, 0x0}, // T3
+    {0x6, 0x3, 0x0, 0x0}, // S0
+    {0x1, 0x3, 0x2, 0x0}, // S1
+    {0x3, 0x6, 0x0, 0x0}, // Z0
+    {0x2, 0x3, 0x1, 0x0}, // Z1
+    {0x1, 0x7, 0x0, 0x0}, // J0
+    {0x3, 0x1, 0x1, 0x0}, // J1
+    {0x7, 0x4, 0x0, 0x0}, // J2
+    {0x2, 0x2, 0x3, 0x0}, // J3
+    {0x4, 0x7, 0x0, 0x0}, // L0
+    {0x1, 0x1, 0x3, 0x0}, // L1
+    {0x7, 0x1, 0x0, 0x0}, // L2
+    {0x3, 0x2, 0x2, 0x0}, // L3
+};
+
+// a state proven to have no tiling
+typedef struct DeadEntry
+{
+    uint64_t rows[4]; // the four rows from the next empty cell down
+    int y;            // row of the next empty cell; -1 marks an unused slot
+    size_t counts[TETRO_TYPE_COUNT];
+} DeadEntry;
+
+typedef struct DeadTable
+{
+    size_t mask;
+    DeadEntry *entries;
+} DeadTable;
+
+// one search level: the anchor cell and the orientation cursor
+typedef struct BitFrame
+{
+    int x;
+    int y;
+    uint8_t orient; // orientation placed at this frame
+    uint8_t next;   // next orientation to try
+} BitFrame;
+
+// everything a kernel needs
+typedef struct BitJob
+{
+    const Board *board;
+    int width;
+    int height;
+    size_t counts[TETRO_TYPE_COUNT];
+    size_t total;
+    Placement *out;
+    uint64_t nodes;
+    uint64_t node_limit; // give up once nodes reaches it; 0 = unlimited
+    DeadTable *dead; // NULL disables the dead-state cache
+    const volatile sig_atomic_t *progress; // report request flag, NULL when reports are off
+    uint64_t *scratch;                     // height + BITKERNEL_ROW_PAD rows for progress reports
+} BitJob;
+
+// mix the state into a slot index
+static inline size_t dead_slot(const DeadTable *table, const uint64_t rows[4], int y, const size_t *counts)
+{
+    uint64_t h = (uint64_t)(unsigned)y * 0x9E3779B97F4A7C15ULL;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        h ^= rows[i];
+        h *= 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 31;
+    }
+    for (size_t t = 0; t < TETRO_TYPE_COUNT; ++t)
+    {
+        h ^= (uint64_t)counts[t];
+        h *= 0x94D049BB133111EBULL;
+        h ^= h >> 29;
+    }
+    return (size_t)h & table->mask;
+}
+
+static inline bool dead_lookup(const DeadTable *table, const uint64_t rows[4], int y, const size_t *counts)
+{
+    if (!table)
+        return false;
+    const DeadEntry *e = table->entries + dead_slot(table, rows, y, counts);
+    return e->y == y && memcmp(e->rows, rows, sizeof(e->rows)) == 0 &&
+           memcmp(e->counts, counts, sizeof(e->counts)) == 0;
+}
+
+static inline void dead_insert(DeadTable *table, const uint64_t rows[4], int y, const size_t *counts)
+{
+    if (!table)
+        return;
+    DeadEntry *e = table->entries + dead_slot(table, rows, y, counts);
+    memcpy(e->rows, rows, sizeof(e->rows));
+    memcpy(e->counts, counts, sizeof(e->counts));
+    e->y = y;
+}
+
+static DeadTable *dead_create(unsigned log2)
+{
+    DeadTable *table = malloc(sizeof(DeadTable));
+    if (!table)
+        return NULL;
+    size_t size = (size_t)1 << log2;
+    table->mask = size - 1;
+    table->entries = malloc(size * sizeof(DeadEntry));
+    if (!table->entries)
+    {
+        free(table);
+        return NULL;
+    }
+    for (size_t i = 0; i < size; ++i)
+        table->entries[i].y = -1;
+    return table;
+}
+
+static void dead_destroy(DeadTable *table)
+{
+    if (!table)
+        return;
+    free(table->entries);
+    free(table);
+}
+
+// report the search state; scratch holds the rows with frames[0..placed) on them and is consumed
+static void report_progress(BitJob *job, const BitFrame *frames, size_t placed)
+{
+    size_t counts[TETRO_TYPE_COUNT];
+    memcpy(counts, job->counts, sizeof(counts));
+    uint64_t *rows = job->scratch;
+
+    // from the top frame down: remove its piece, then count the orientations its anchor offered;
+    // explored = (done_0 + (done_1 + ...) / total_1) / total_0
+    double explored = 0.0;
+    for (size_t d = placed; d > 0; --d)
+    {
+        const BitFrame *frame = frames + d - 1;
+        uint64_t *at = rows + frame->y;
+        const uint8_t *pm = BIT_MASKS[frame->orient];
+        for (size_t i = 0; i < 4; ++i)
+            at[i] &= ~((uint64_t)pm[i] << frame->x);
+        counts[BIT_TYPES[frame->orient]]++;
+
+        size_t done = 0;
+        size_t total = 0;
+        for (unsigned o = 0; o < BIT_ORIENTATION_NUM; ++o)
+        {
+            const uint8_t *m = BIT_MASKS[o];
+            if (counts[BIT_TYPES[o]] == 0)
+                continue;
+            uint64_t hit = 0;
+            for (size_t i = 0; i < 4; ++i)
+                hit |= at[i] & ((uint64_t)m[i] << frame->x);
+            if (hit != 0)
+                continue;
+            total++;
+            if (o < frame->orient)
+                done++;
+        }
+        explored = total > 0 ? ((double)done + explored) / (double)total : explored;
+    }
+
+    ProgressSnapshot snap;
+    snap.kernel = bitkernel_name(job->width);
+    snap.depth = placed;
+    snap.piece_num = job->total;
+    snap.total_cells = (size_t)job->width * (size_t)job->height;
+    snap.filled_cells = snap.total_cells - 4 * (job->total - placed);
+    snap.nodes = job->nodes;
+    snap.explored = explored;
+    progress_report(&snap);
+}
+
+#define BK_ROW uint8_t
+#define BK_NAME kernel_row8
+#include "bitkernel_tmpl.h"
+
+#define BK_ROW uint16_t
+#define BK_NAME kernel_row16
+#include "bitkernel_tmpl.h"
+
+#define BK_ROW uint32_t
+#define BK_NAME kernel_row32
+#include "bitkernel_tmpl.h"
+
+#define BK_ROW uint64_t
+#define BK_NAME kernel_row64
+#include "bitkernel_tmpl.h"
+
+typedef StatusCode (*BitKernel)(BitJob *job);
+
+// narrowest row type that holds width + BITKERNEL_ROW_PAD bits
+static BitKernel select_kernel(int width, const char **out_name)
+{
+    static const struct
+    {
+        int bits;
+        BitKernel kernel;
+        const char *name;
+    } kernels[] = {
+        {8, kernel_row8, "row8"},
+        {16, kernel_row16, "row16"},
+        {32, kernel_row32, "row32"},
+        {64, kernel_row64, "row64"},
+    };
+    for (size_t i = 0; i < sizeof(kernels) / sizeof(kernels[0]); ++i)
+    {
+        if (width > 0 && width + BITKERNEL_ROW_PAD <= kernels[i].bits)
+        {
+            if (out_name)
+                *out_name = kernels[i].name;
+            return kernels[i].kernel;
+        }
+    }
+    return NULL;
+}
+
+bool bitkernel_supports(int width, int height)
+{
+    return height > 0 && height <= INT_MAX - BITKERNEL_ROW_PAD && select_kernel(width, NULL) != NULL;
+}
+
+const char *bitkernel_name(int width)
+{
+    const char *name = NULL;
+    select_kernel(width, &name);
+    return name;
+}
+
+StatusCode bitkernel_solve(Board *board,
+                           const TetrominoBag *bag,
+                           uint64_t node_limit,
+                           Placement *out_list,
+                           uint64_t *out_nodes)
+{
+    if (out_nodes)
+        *out_nodes = 0;
+    if (!board || !bag || !out_list)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    int width = board_width(board);
+    int height = board_height(board);
+    BitKernel kernel = select_kernel(width, NULL);
+    if (!kernel || !bitkernel_supports(width, height))
+        return STATUS_ERR_INVALID_ARGUMENT;
+    size_t cells = board_cell_count(board);
+    size_t filled = board_filled_count(board);
+    if (bag->total > SIZE_MAX / 4 || cells - filled != bag->total * 4)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    if (bag->total == 0)
+        return STATUS_OK; // nothing left to place
+
+    BitJob job;
+    memset(&job, 0, sizeof(job));
+    job.board = board;
+    job.width = width;
+    job.height = height;
+    memcpy(job.counts, bag->counts, sizeof(job.counts));
+    job.total = bag->total;
+    job.out = out_list;
+    job.node_limit = node_limit;
+    job.dead = dead_create(DEAD_TABLE_LOG2); // allocation failure only disables pruning
+    job.progress = progress_flag();
+    if (job.progress)
+    {
+        job.scratch = malloc(((size_t)height + BITKERNEL_ROW_PAD) * sizeof(uint64_t));
+        if (!job.scratch)
+            job.progress = NULL; // allocation failure only disables reports
+    }
+
+    StatusCode res = kernel(&job);
+    dead_destroy(job.dead);
+    free(job.scratch);
+    if (out_nodes)
+        *out_nodes = job.nodes;
+    if (res != STATUS_OK)
+        return res;
+
+    for (size_t i = 0; i < bag->total; ++i)
+    {
+        const Placement *p = out_list + i;
+        board_place(board, p->x, p->y, p->type, p->rotation, p->mark);
+    }
+    return STATUS_OK;
+}
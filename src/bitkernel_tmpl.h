@@ -0,0 +1,141 @@
+/* Bitboard kernel template, included by bitkernel.c once per row type.
+ * Expects BK_ROW (unsigned row type) and BK_NAME (kernel function name); both are undefined at the end. */
+
+static StatusCode BK_NAME(BitJob *job)
+{
+    const BK_ROW full = (BK_ROW)~(BK_ROW)0;
+    const BK_ROW outside = (BK_ROW)(full << job->width); // sentinel bits right of the board
+    size_t row_num = (size_t)job->height + BITKERNEL_ROW_PAD;
+    BK_ROW *rows = malloc(row_num * sizeof(BK_ROW));
+    BitFrame *frames = malloc(job->total * sizeof(BitFrame));
+    if (!rows || !frames)
+    {
+        free(rows);
+        free(frames);
+        return STATUS_ERR_MEMORY;
+    }
+
+    // load the board; filled cells and sentinels are 1 bits
+    for (int y = 0; y < job->height; ++y)
+    {
+        BK_ROW row = outside;
+        for (int x = 0; x < job->width; ++x)
+        {
+            if (!board_is_empty(job->board, x, y))
+                row = (BK_ROW)(row | ((BK_ROW)1 << x));
+        }
+        rows[y] = row;
+    }
+    for (size_t y = (size_t)job->height; y < row_num; ++y)
+        rows[y] = full;
+
+    size_t *counts = job->counts;
+    size_t depth = 0;
+    int first_y = 0;
+    while (rows[first_y] == full)
+        first_y++;
+    frames[0].x = __builtin_ctzll((unsigned long long)(BK_ROW)~rows[first_y]);
+    frames[0].y = first_y;
+    frames[0].next = 0;
+
+    StatusCode res = STATUS_ERR_UNSOLVABLE;
+    while (true)
+    {
+        BitFrame *frame = frames + depth;
+        const int x = frame->x;
+        BK_ROW *at = rows + frame->y;
+
+        // next orientation (in candidate order) with pieces left that fits at the anchor
+        unsigned o = frame->next;
+        for (; o < BIT_ORIENTATION_NUM; ++o)
+        {
+            const uint8_t *m = BIT_MASKS[o];
+            if (counts[BIT_TYPES[o]] == 0)
+                continue;
+            if (((at[0] & ((BK_ROW)m[0] << x)) | (at[1] & ((BK_ROW)m[1] << x)) |
+                 (at[2] & ((BK_ROW)m[2] << x)) | (at[3] & ((BK_ROW)m[3] << x))) == 0)
+                break;
+        }
+
+        if (o < BIT_ORIENTATION_NUM)
+        {
+            const uint8_t *m = BIT_MASKS[o];
+            for (size_t i = 0; i < 4; ++i)
+                at[i] = (BK_ROW)(at[i] | ((BK_ROW)m[i] << x));
+            counts[BIT_TYPES[o]]--;
+            frame->orient = (uint8_t)o;
+            frame->next = (uint8_t)(o + 1);
+            job->nodes++;
+            if (job->progress && *job->progress)
+            {
+                for (size_t i = 0; i < row_num; ++i)
+                    job->scratch[i] = rows[i];
+                report_progress(job, frames, depth + 1);
+            }
+            if (depth + 1 == job->total)
+            {
+                res = STATUS_OK;
+                break;
+            }
+            if (job->nodes == job->node_limit)
+                break; // out of budget: unsolved, and nothing proven dead
+
+            // the next empty cell never lies before this anchor
+            int next_y = frame->y;
+            while (rows[next_y] == full)
+                next_y++;
+            uint64_t key_rows[4];
+            for (size_t i = 0; i < 4; ++i)
+                key_rows[i] = rows[next_y + (int)i];
+            if (dead_lookup(job->dead, key_rows, next_y, counts))
+            {
+                // known dead state: undo and try the next orientation here
+                for (size_t i = 0; i < 4; ++i)
+                    at[i] = (BK_ROW)(at[i] & (BK_ROW)~((BK_ROW)m[i] << x));
+                counts[BIT_TYPES[o]]++;
+                continue;
+            }
+            BitFrame *child = frames + depth + 1;
+            child->x = __builtin_ctzll((unsigned long long)(BK_ROW)~rows[next_y]);
+            child->y = next_y;
+            child->next = 0;
+            depth++;
+            continue;
+        }
+
+        // frame exhausted: this state has no tiling
+        uint64_t key_rows[4];
+        for (size_t i = 0; i < 4; ++i)
+            key_rows[i] = at[i];
+        dead_insert(job->dead, key_rows, frame->y, counts);
+        if (depth == 0)
+            break;
+        depth--;
+        BitFrame *parent = frames + depth;
+        const uint8_t *pm = BIT_MASKS[parent->orient];
+        BK_ROW *pat = rows + parent->y;
+        for (size_t i = 0; i < 4; ++i)
+            pat[i] = (BK_ROW)(pat[i] & (BK_ROW)~((BK_ROW)pm[i] << parent->x));
+        counts[BIT_TYPES[parent->orient]]++;
+    }
+
+    if (res == STATUS_OK)
+    {
+        for (size_t d = 0; d < job->total; ++d)
+        {
+            const BitFrame *frame = frames + d;
+            Placement *p = job->out + d;
+            p->type = BIT_TYPES[frame->orient];
+            p->rotation = BIT_ROTATIONS[frame->orient];
+            p->x = frame->x;
+            p->y = frame->y;
+            p->mark = (char)('A' + (d % MARK_NUM));
+        }
+    }
+    free(rows);
+    free(frames);
+    return res;
+}
+
+#undef BK_ROW
+#undef BK_NAME
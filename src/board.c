@@ -7,10 +7,12 @@
  *   - Construction/destruction and size queries.
  *   - Bounds/occupancy checks.
  *   - Place/remove a given shape.
+ *   - Obstacles are cells holding BOARD_BLOCKED_MARK; only board_clear needs to know about them.
  *   - Stats and printing. */
 
 #define BOARD_SIZE sizeof(Board)
 #define EMPTY_MARK '.'
+#define WINDOW_SIZE 4 // window side of board_window_mask
 
 struct Board
 {
@@ -52,6 +54,33 @@ void board_destroy(Board *b)
     free(b);
 }
 
+Board *board_clone(const Board *b)
+{
+    if (!b)
+        return NULL;
+    size_t state_size = (size_t)b->W * (size_t)b->H;
+    Board *copy = malloc(BOARD_SIZE + state_size);
+    if (!copy)
+        return NULL;
+    memcpy(copy, b, BOARD_SIZE + state_size);
+    return copy;
+}
+
+Board *board_transpose(const Board *b)
+{
+    if (!b)
+        return NULL;
+    Board *t = board_create(b->H, b->W);
+    if (!t)
+        return NULL;
+    for (int y = 0; y < b->H; ++y)
+    {
+        for (int x = 0; x < b->W; ++x)
+            t->state[state_idx(t->W, y, x)] = b->state[state_idx(b->W, x, y)];
+    }
+    return t;
+}
+
 int board_width(const Board *b)
 {
     if (!b)
@@ -107,6 +136,68 @@ bool board_is_empty(const Board *b, int x, int y)
     return b->state[state_idx(b->W, x, y)] == EMPTY_MARK;
 }
 
+char board_cell_mark(const Board *b, int x, int y)
+{
+    if (!board_in_bounds(b, x, y))
+        return '\0';
+    return b->state[state_idx(b->W, x, y)];
+}
+
+bool board_fill_cell(Board *b, int x, int y, char mark)
+{
+    if (!board_is_empty(b, x, y) || mark == EMPTY_MARK || mark == BOARD_BLOCKED_MARK || mark == '\0')
+        return false;
+    b->state[state_idx(b->W, x, y)] = mark;
+    return true;
+}
+
+bool board_block_cell(Board *b, int x, int y)
+{
+    if (!board_is_empty(b, x, y))
+        return false;
+    b->state[state_idx(b->W, x, y)] = BOARD_BLOCKED_MARK;
+    return true;
+}
+
+bool board_is_blocked(const Board *b, int x, int y)
+{
+    return board_cell_mark(b, x, y) == BOARD_BLOCKED_MARK;
+}
+
+size_t board_blocked_count(const Board *b)
+{
+    if (!b)
+        return 0;
+    size_t cells = board_cell_count(b), count = 0;
+    for (size_t i = 0; i < cells; ++i)
+    {
+        if (b->state[i] == BOARD_BLOCKED_MARK)
+            count++;
+    }
+    return count;
+}
+
+uint16_t board_window_mask(const Board *b, int x, int y)
+{
+    if (!board_in_bounds(b, x, y))
+        return 0;
+
+    // clip the window to the board once, then scan whole rows
+    int w = b->W - x < WINDOW_SIZE ? b->W - x : WINDOW_SIZE;
+    int h = b->H - y < WINDOW_SIZE ? b->H - y : WINDOW_SIZE;
+    unsigned mask = 0;
+    for (int dy = 0; dy < h; ++dy)
+    {
+        const char *row = b->state + state_idx(b->W, x, y + dy);
+        for (int dx = 0; dx < w; ++dx)
+        {
+            if (row[dx] == EMPTY_MARK)
+                mask |= 1u << (dy * WINDOW_SIZE + dx);
+        }
+    }
+    return (uint16_t)mask;
+}
+
 bool board_place(Board *b, int x, int y, TetrominoType type, size_t rotation, char mark)
 {
     if (!b)
@@ -160,12 +251,18 @@ void board_remove(Board *b, int x, int y, TetrominoType type, size_t rotation)
 
 void board_print(const Board *b, FILE *out)
 {
-    if (!b || !out)
+    if (!b)
+        return;
+    board_print_rows(b, 0, b->H, out);
+}
+
+void board_print_rows(const Board *b, int first, int count, FILE *out)
+{
+    if (!b || !out || first < 0 || count < 0 || first > b->H || count > b->H - first)
         return;
 
     int W = b->W;
-    int H = b->H;
-    for (int row = 0; row < H; ++row)
+    for (int row = first; row < first + count; ++row)
     {
         for (int col = 0; col < W; ++col)
             fputc(b->state[state_idx(W, col, row)], out);
@@ -178,6 +275,16 @@ void board_clear(Board *b)
     if (!b)
         return;
 
-    // clear state
-    memset(b->state, EMPTY_MARK, (size_t)board_cell_count(b));
+    // clear state; obstacles stay
+    size_t cells = board_cell_count(b);
+    if (!memchr(b->state, BOARD_BLOCKED_MARK, cells))
+    {
+        memset(b->state, EMPTY_MARK, cells);
+        return;
+    }
+    for (size_t i = 0; i < cells; ++i)
+    {
+        if (b->state[i] != BOARD_BLOCKED_MARK)
+            b->state[i] = EMPTY_MARK;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,356 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "checkpoint.h"
+
+/* Checkpoint implementation:
+ *   - Fixed-width little-endian encoding through a tiny writer/reader with a sticky error flag.
+ *   - Header (magic, version, instance), counters, then the frames of the stack.
+ *   - The instance includes the obstacles: their number, then (if any) one bit per cell, row-major.
+ *   - Load replays frames through search_push_placed, which checks every stored candidate against the board
+ *     and counts of its frame, and cross-checks the saved counts. */
+
+#define CHECKPOINT_MAGIC "TETCKPT"
+#define CHECKPOINT_MAGIC_SIZE 8
+#define CHECKPOINT_VERSION 5u
+#define CHECKPOINT_TMP_SUFFIX ".tmp"
+
+// sequential encoder over a FILE with a sticky error flag
+typedef struct CkptIO
+{
+    FILE *fp;
+    bool ok;
+} CkptIO;
+
+static void put_bytes(CkptIO *io, const void *data, size_t size)
+{
+    if (io->ok && fwrite(data, 1, size, io->fp) != size)
+        io->ok = false;
+}
+
+static void put_u64(CkptIO *io, uint64_t v)
+{
+    unsigned char buf[8];
+    for (size_t i = 0; i < 8; ++i)
+        buf[i] = (unsigned char)(v >> (8 * i));
+    put_bytes(io, buf, sizeof(buf));
+}
+
+static void put_u32(CkptIO *io, uint32_t v)
+{
+    unsigned char buf[4];
+    for (size_t i = 0; i < 4; ++i)
+        buf[i] = (unsigned char)(v >> (8 * i));
+    put_bytes(io, buf, sizeof(buf));
+}
+
+static void put_u8(CkptIO *io, uint8_t v)
+{
+    put_bytes(io, &v, 1);
+}
+
+static void get_bytes(CkptIO *io, void *data, size_t size)
+{
+    if (io->ok && fread(data, 1, size, io->fp) != size)
+        io->ok = false;
+    if (!io->ok)
+        memset(data, 0, size);
+}
+
+static uint64_t get_u64(CkptIO *io)
+{
+    unsigned char buf[8];
+    get_bytes(io, buf, sizeof(buf));
+    uint64_t v = 0;
+    for (size_t i = 0; i < 8; ++i)
+        v |= (uint64_t)buf[i] << (8 * i);
+    return v;
+}
+
+static uint32_t get_u32(CkptIO *io)
+{
+    unsigned char buf[4];
+    get_bytes(io, buf, sizeof(buf));
+    uint32_t v = 0;
+    for (size_t i = 0; i < 4; ++i)
+        v |= (uint32_t)buf[i] << (8 * i);
+    return v;
+}
+
+static uint8_t get_u8(CkptIO *io)
+{
+    uint8_t v = 0;
+    get_bytes(io, &v, 1);
+    return v;
+}
+
+// obstacles of board: count, then a row-major bitmap when there are any
+static void put_obstacles(CkptIO *io, const Board *board)
+{
+    size_t blocked = board_blocked_count(board);
+    put_u64(io, blocked);
+    if (blocked == 0)
+        return;
+    size_t cells = board_cell_count(board);
+    int w = board_width(board);
+    for (size_t i = 0; i < cells; i += 8)
+    {
+        uint8_t byte = 0;
+        for (size_t k = 0; k < 8 && i + k < cells; ++k)
+        {
+            size_t cell = i + k;
+            if (board_is_blocked(board, (int)(cell % (size_t)w), (int)(cell / (size_t)w)))
+                byte = (uint8_t)(byte | (1u << k));
+        }
+        put_u8(io, byte);
+    }
+}
+
+// read the obstacles of a w x h board into a flag array (NULL when there are none); false if malformed
+static bool get_obstacles(CkptIO *io, uint32_t w, uint32_t h, bool **out_blocked)
+{
+    *out_blocked = NULL;
+    uint64_t blocked = get_u64(io);
+    if (!io->ok || blocked == 0)
+        return io->ok;
+    uint64_t cells = (uint64_t)w * (uint64_t)h;
+    if (w == 0 || h == 0 || cells > SIZE_MAX || blocked > cells)
+        return false;
+    bool *flags = calloc((size_t)cells, sizeof(bool));
+    if (!flags)
+        return false;
+    uint64_t seen = 0;
+    for (uint64_t i = 0; i < cells && io->ok; i += 8)
+    {
+        uint8_t byte = get_u8(io);
+        for (uint64_t k = 0; k < 8 && i + k < cells; ++k)
+        {
+            flags[i + k] = (byte >> k) & 1u;
+            seen += flags[i + k];
+        }
+    }
+    if (!io->ok || seen != blocked)
+    {
+        free(flags);
+        return false;
+    }
+    *out_blocked = flags;
+    return true;
+}
+
+StatusCode checkpoint_save(const char *path, const SearchContext *ctx, const TetrominoBag *bag)
+{
+    if (!path || !ctx || !ctx->stack || !bag)
+        return STATUS_ERR_INVALID_ARGUMENT;
+
+    size_t path_len = strlen(path);
+    char *tmp_path = malloc(path_len + sizeof(CHECKPOINT_TMP_SUFFIX));
+    if (!tmp_path)
+        return STATUS_ERR_MEMORY;
+    memcpy(tmp_path, path, path_len);
+    memcpy(tmp_path + path_len, CHECKPOINT_TMP_SUFFIX, sizeof(CHECKPOINT_TMP_SUFFIX));
+
+    CkptIO io = {fopen(tmp_path, "wb"), true};
+    if (!io.fp)
+    {
+        free(tmp_path);
+        return STATUS_ERR_INPUT;
+    }
+
+    // header: magic, version, instance
+    char magic[CHECKPOINT_MAGIC_SIZE] = CHECKPOINT_MAGIC;
+    put_bytes(&io, magic, sizeof(magic));
+    put_u32(&io, CHECKPOINT_VERSION);
+    put_u32(&io, (uint32_t)board_width(ctx->board));
+    put_u32(&io, (uint32_t)board_height(ctx->board));
+    for (size_t t = 0; t < TETRO_TYPE_COUNT; ++t)
+        put_u64(&io, bag->counts[t]);
+    put_obstacles(&io, ctx->board);
+
+    // counters and search mode
+    put_u64(&io, ctx->nodes);
+    put_u64(&io, ctx->rng);
+    put_u64(&io, ctx->node_limit);
+    put_u64(&io, ctx->restarts);
+    put_u64(&io, ctx->restart_base);
+    put_u64(&io, (uint64_t)ctx->floor);
+    put_u64(&io, ctx->solutions);
+    put_u8(&io, ctx->randomize ? 1 : 0);
+    put_u8(&io, (uint8_t)ctx->order);
+    put_u8(&io, ctx->cover ? 1 : 0);
+    put_u64(&io, ctx->filled_cells);
+    for (size_t t = 0; t < TETRO_TYPE_COUNT; ++t)
+        put_u64(&io, ctx->counts[t]);
+
+    // frames
+    size_t frame_num = (size_t)(ctx->stack->top + 1);
+    put_u64(&io, frame_num);
+    for (size_t i = 0; i < frame_num; ++i)
+    {
+        const SolverFrame *frame = ctx->stack->frames + i;
+        put_u8(&io, (uint8_t)frame->cands_size);
+        put_u32(&io, (uint32_t)frame->idx);
+        for (size_t c = 0; c < frame->cands_size; ++c)
+        {
+            const Placement *p = frame->cands + c;
+            put_u8(&io, (uint8_t)p->type);
+            put_u8(&io, (uint8_t)p->rotation);
+            put_u32(&io, (uint32_t)p->x);
+            put_u32(&io, (uint32_t)p->y);
+            put_u8(&io, (uint8_t)p->mark);
+        }
+    }
+
+    if (fflush(io.fp) != 0)
+        io.ok = false;
+    if (fclose(io.fp) != 0)
+        io.ok = false;
+    if (io.ok && rename(tmp_path, path) != 0)
+        io.ok = false;
+    if (!io.ok)
+        remove(tmp_path);
+    free(tmp_path);
+    return io.ok ? STATUS_OK : STATUS_ERR_INPUT;
+}
+
+StatusCode checkpoint_peek(const char *path, int *out_w, int *out_h, TetrominoBag *out_bag, bool **out_blocked)
+{
+    if (!path || !out_w || !out_h || !out_bag || !out_blocked)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    *out_blocked = NULL;
+    CkptIO io = {fopen(path, "rb"), true};
+    if (!io.fp)
+        return STATUS_ERR_INPUT;
+
+    char magic[CHECKPOINT_MAGIC_SIZE];
+    char expected_magic[CHECKPOINT_MAGIC_SIZE] = CHECKPOINT_MAGIC;
+    get_bytes(&io, magic, sizeof(magic));
+    bool match = io.ok && memcmp(magic, expected_magic, sizeof(magic)) == 0;
+    match = match && get_u32(&io) == CHECKPOINT_VERSION;
+    uint32_t w = get_u32(&io);
+    uint32_t h = get_u32(&io);
+    TetrominoBag bag = {{0}, 0};
+    for (size_t t = 0; t < TETRO_TYPE_COUNT; ++t)
+    {
+        bag.counts[t] = (size_t)get_u64(&io);
+        if (bag.total > SIZE_MAX - bag.counts[t])
+            match = false;
+        else
+            bag.total += bag.counts[t];
+    }
+    bool *blocked = NULL;
+    match = match && get_obstacles(&io, w, h, &blocked);
+    fclose(io.fp);
+    if (!match || !io.ok || w == 0 || h == 0 || w > INT_MAX || h > INT_MAX)
+    {
+        free(blocked);
+        return STATUS_ERR_INPUT;
+    }
+
+    *out_blocked = blocked;
+    *out_w = (int)w;
+    *out_h = (int)h;
+    *out_bag = bag;
+    return STATUS_OK;
+}
+
+StatusCode checkpoint_load(const char *path, SearchContext *ctx, const TetrominoBag *bag)
+{
+    if (!path || !ctx || !ctx->stack || !bag)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    if (ctx->stack->top != -1)
+        return STATUS_ERR_INVALID_ARGUMENT; // must start from a fresh search
+
+    CkptIO io = {fopen(path, "rb"), true};
+    if (!io.fp)
+        return STATUS_ERR_INPUT;
+
+    // header must describe this very instance
+    char magic[CHECKPOINT_MAGIC_SIZE];
+    char expected_magic[CHECKPOINT_MAGIC_SIZE] = CHECKPOINT_MAGIC;
+    get_bytes(&io, magic, sizeof(magic));
+    bool match = io.ok && memcmp(magic, expected_magic, sizeof(magic)) == 0;
+    match = match && get_u32(&io) == CHECKPOINT_VERSION;
+    match = match && get_u32(&io) == (uint32_t)board_width(ctx->board);
+    match = match && get_u32(&io) == (uint32_t)board_height(ctx->board);
+    for (size_t t = 0; t < TETRO_TYPE_COUNT && match; ++t)
+        match = get_u64(&io) == bag->counts[t];
+    bool *blocked = NULL;
+    match = match && get_obstacles(&io, (uint32_t)board_width(ctx->board), (uint32_t)board_height(ctx->board),
+                                   &blocked);
+    size_t cells = board_cell_count(ctx->board);
+    for (size_t i = 0; i < cells && match; ++i)
+    {
+        int x = (int)(i % (size_t)board_width(ctx->board)), y = (int)(i / (size_t)board_width(ctx->board));
+        match = (blocked && blocked[i]) == board_is_blocked(ctx->board, x, y);
+    }
+    free(blocked);
+
+    // counters and search mode
+    uint64_t nodes = get_u64(&io);
+    uint64_t rng = get_u64(&io);
+    uint64_t node_limit = get_u64(&io);
+    uint64_t restarts = get_u64(&io);
+    uint64_t restart_base = get_u64(&io);
+    uint64_t floor = get_u64(&io);
+    uint64_t solutions = get_u64(&io);
+    bool randomize = get_u8(&io) != 0;
+    uint8_t order = get_u8(&io);
+    bool cover = get_u8(&io) != 0;
+    uint64_t filled_cells = get_u64(&io);
+    uint64_t counts[TETRO_TYPE_COUNT];
+    for (size_t t = 0; t < TETRO_TYPE_COUNT; ++t)
+        counts[t] = get_u64(&io);
+    uint64_t frame_num = get_u64(&io);
+    match = match && io.ok && rng != 0 && order < SEARCH_ORDER_NUM && frame_num <= ctx->stack->capacity &&
+            floor <= frame_num;
+
+    // frames: replay each placed candidate onto the board
+    for (uint64_t i = 0; i < frame_num && match; ++i)
+    {
+        SolverFrame frame;
+        memset(&frame, 0, sizeof(frame));
+        frame.cands_size = get_u8(&io);
+        frame.idx = (int)get_u32(&io);
+        if (frame.cands_size == 0 || frame.cands_size > CANDS_MAX_SIZE)
+        {
+            match = false;
+            break;
+        }
+        for (size_t c = 0; c < frame.cands_size; ++c)
+        {
+            Placement *p = frame.cands + c;
+            uint8_t type = get_u8(&io);
+            p->type = type < TETRO_TYPE_COUNT ? (TetrominoType)type : TETRO_TYPE_COUNT;
+            p->rotation = get_u8(&io);
+            p->x = (int)get_u32(&io);
+            p->y = (int)get_u32(&io);
+            p->mark = (char)get_u8(&io);
+        }
+        match = io.ok && search_push_placed(ctx, &frame) == STATUS_OK;
+    }
+    fclose(io.fp);
+
+    // the replayed board must agree with what was saved
+    match = match && filled_cells == ctx->filled_cells;
+    for (size_t t = 0; t < TETRO_TYPE_COUNT && match; ++t)
+        match = counts[t] == ctx->counts[t];
+    if (!match)
+    {
+        search_unwind(ctx);
+        return STATUS_ERR_INPUT;
+    }
+
+    ctx->nodes = nodes;
+    ctx->rng = rng;
+    ctx->node_limit = node_limit;
+    ctx->restarts = restarts;
+    ctx->restart_base = (size_t)restart_base;
+    ctx->randomize = randomize;
+    ctx->order = (SearchOrder)order;
+    ctx->cover = cover;
+    ctx->floor = (int)floor;
+    ctx->solutions = solutions;
+    return STATUS_OK;
+}
@@ -0,0 +1,643 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "cnf.h"
+#include "tetromino.h"
+
+/* CNF encoding implementation:
+ *   - Placements are enumerated once; a cell -> covering placements index (CSR) drives the cell clauses.
+ *   - A pair of overlapping placements is excluded only at its first common cell, so it appears once.
+ *   - Sequential counter (Sinz) for each type whose placements outnumber its count.
+ *   - A checkerboard colouring bounds the T placements by colour, so parity-unsolvable bags fail fast.
+ *   - Column and row stripes fix the parity of the J/L/T pieces leaning across them, likewise. */
+
+#define MARK_NUM 26 // 26 letters from A-Z
+#define TOKEN_MAX 64
+
+// sort key for decoding: a chosen placement and its first cell in row-major order
+typedef struct ChosenPiece
+{
+    size_t first_cell;
+    size_t index;
+} ChosenPiece;
+
+static inline size_t cell_index(int width, int x, int y)
+{
+    return (size_t)y * (size_t)width + (size_t)x;
+}
+
+// the four cells of a placement as ascending row-major indices
+static void placement_cells(int width, const Placement *p, size_t out[4])
+{
+    Cell cells[4];
+    tetro_get_cells(p->type, p->rotation, cells);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        size_t c = cell_index(width, p->x + cells[i].x, p->y + cells[i].y);
+        size_t k = i;
+        while (k > 0 && out[k - 1] > c)
+        {
+            out[k] = out[k - 1];
+            k--;
+        }
+        out[k] = c;
+    }
+}
+
+// append one clause; false on allocation failure
+static bool emit(TilingCnf *cnf, const int *lits, size_t lit_num)
+{
+    if (cnf->lit_num + lit_num + 1 > cnf->lit_cap)
+    {
+        size_t cap = cnf->lit_cap ? cnf->lit_cap : 4096;
+        while (cap < cnf->lit_num + lit_num + 1)
+            cap *= 2;
+        int *grown = realloc(cnf->lits, cap * sizeof(int));
+        if (!grown)
+            return false;
+        cnf->lits = grown;
+        cnf->lit_cap = cap;
+    }
+    if (lit_num > 0)
+        memcpy(cnf->lits + cnf->lit_num, lits, lit_num * sizeof(int));
+    cnf->lit_num += lit_num;
+    cnf->lits[cnf->lit_num++] = 0;
+    cnf->clause_num++;
+    return true;
+}
+
+static bool emit2(TilingCnf *cnf, int a, int b)
+{
+    int lits[2] = {a, b};
+    return emit(cnf, lits, 2);
+}
+
+static bool emit3(TilingCnf *cnf, int a, int b, int c)
+{
+    int lits[3] = {a, b, c};
+    return emit(cnf, lits, 3);
+}
+
+// true if a placement at (x,y) lies on empty in-bounds cells
+static bool placement_fits(const Board *board, int x, int y, TetrominoType type, size_t rotation)
+{
+    Cell cells[4];
+    size_t cell_num = tetro_get_cells(type, rotation, cells);
+    for (size_t i = 0; i < cell_num; ++i)
+    {
+        if (!board_is_empty(board, x + cells[i].x, y + cells[i].y))
+            return false;
+    }
+    return cell_num == 4;
+}
+
+// at most k of vars[0..n): unit clauses for k == 0, else a sequential counter with (n-1)*k fresh variables
+static StatusCode emit_at_most(TilingCnf *cnf, const int *vars, size_t n, size_t k)
+{
+    if (n <= k)
+        return STATUS_OK;
+    if (k == 0)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            int unit = -vars[i];
+            if (!emit(cnf, &unit, 1))
+                return STATUS_ERR_MEMORY;
+        }
+        return STATUS_OK;
+    }
+    size_t aux = (n - 1) * k;
+    if (n - 1 > (size_t)INT_MAX / k || aux > (size_t)(INT_MAX - cnf->var_num))
+        return STATUS_ERR_INVALID_ARGUMENT;
+    int base = cnf->var_num;
+    cnf->var_num += (int)aux;
+// register s(i,j): at least j of vars[0..i] are true (1-based i in [1,n-1], j in [1,k])
+#define REG(i, j) (base + (int)(((i) - 1) * k + (j)))
+
+    bool ok = emit2(cnf, -vars[0], REG(1, 1));
+    for (size_t j = 2; j <= k && ok; ++j)
+    {
+        int unit = -REG(1, j);
+        ok = emit(cnf, &unit, 1);
+    }
+    for (size_t i = 2; i < n && ok; ++i)
+    {
+        int x = vars[i - 1];
+        ok = emit2(cnf, -x, REG(i, 1)) && emit2(cnf, -REG(i - 1, 1), REG(i, 1));
+        for (size_t j = 2; j <= k && ok; ++j)
+            ok = emit3(cnf, -x, -REG(i - 1, j - 1), REG(i, j)) && emit2(cnf, -REG(i - 1, j), REG(i, j));
+        ok = ok && emit2(cnf, -x, -REG(i - 1, k));
+    }
+    ok = ok && emit2(cnf, -vars[n - 1], -REG(n - 1, k));
+#undef REG
+    return ok ? STATUS_OK : STATUS_ERR_MEMORY;
+}
+
+// colour of a cell on a checkerboard: +1 or -1
+static inline int cell_colour(int x, int y)
+{
+    return ((x + y) & 1) ? -1 : 1;
+}
+
+// split the T placements by their majority colour and bound each side by the colour imbalance of
+// the empty area; an impossible imbalance yields the empty clause
+static StatusCode emit_colour_balance(TilingCnf *cnf, const Board *board, const TetrominoBag *bag, int *vars)
+{
+    long long balance = 0;
+    for (int y = 0; y < cnf->height; ++y)
+    {
+        for (int x = 0; x < cnf->width; ++x)
+        {
+            if (board_is_empty(board, x, y))
+                balance += cell_colour(x, y);
+        }
+    }
+
+    // a T leaning +1 adds +2, one leaning -1 adds -2: plus - minus = balance / 2, plus + minus = t
+    long long t = (long long)bag->counts[TETRO_T];
+    long long twice_plus = t + balance / 2;
+    if (balance % 2 != 0 || twice_plus % 2 != 0 || twice_plus < 0 || twice_plus > 2 * t)
+        return emit(cnf, NULL, 0) ? STATUS_OK : STATUS_ERR_MEMORY;
+    if (t == 0)
+        return STATUS_OK;
+
+    size_t plus_num = 0;
+    size_t minus_num = 0;
+    int *minus = vars + cnf->placement_num; // vars has room for 2 * placement_num entries
+    for (size_t i = 0; i < cnf->placement_num; ++i)
+    {
+        const Placement *p = cnf->placements + i;
+        if (p->type != TETRO_T)
+            continue;
+        Cell cells[4];
+        tetro_get_cells(p->type, p->rotation, cells);
+        int lean = 0;
+        for (size_t c = 0; c < 4; ++c)
+            lean += cell_colour(p->x + cells[c].x, p->y + cells[c].y);
+        if (lean > 0)
+            vars[plus_num++] = (int)i + 1;
+        else
+            minus[minus_num++] = (int)i + 1;
+    }
+    size_t plus_max = (size_t)(twice_plus / 2);
+    StatusCode res = emit_at_most(cnf, vars, plus_num, plus_max);
+    if (res == STATUS_OK)
+        res = emit_at_most(cnf, minus, minus_num, (size_t)t - plus_max);
+    return res;
+}
+
+// colour of a cell under stripes along columns (by_column) or rows: +1 or -1
+static inline int stripe_colour(int x, int y, bool by_column)
+{
+    return ((by_column ? x : y) & 1) ? -1 : 1;
+}
+
+// true if a rotation covers the two stripe colours 3:1 or 1:3 (a lean of 2 mod 4) rather than 2:2 or 4:0
+static bool leans_odd(TetrominoType type, size_t rotation, bool by_column)
+{
+    Cell cells[4];
+    tetro_get_cells(type, rotation, cells);
+    int lean = 0;
+    for (size_t c = 0; c < 4; ++c)
+        lean += stripe_colour(cells[c].x, cells[c].y, by_column);
+    return lean == 2 || lean == -2;
+}
+
+// under stripes every placement leans by 0, 2 or 4 (mod 4), so the number of odd-leaning pieces has the
+// parity of half the stripe imbalance; J and L always lean odd, T only across the stripes. Fixed types fold
+// into the expected parity, the others get an XOR chain over their odd-leaning placements
+static StatusCode emit_stripe_parity(TilingCnf *cnf, const Board *board, const TetrominoBag *bag, bool by_column)
+{
+    long long balance = 0;
+    for (int y = 0; y < cnf->height; ++y)
+    {
+        for (int x = 0; x < cnf->width; ++x)
+        {
+            if (board_is_empty(board, x, y))
+                balance += stripe_colour(x, y, by_column);
+        }
+    }
+    if (balance % 2 != 0)
+        return emit(cnf, NULL, 0) ? STATUS_OK : STATUS_ERR_MEMORY;
+
+    // parity still owed by the mixed types; chain holds the running XOR of their odd placements
+    bool parity = ((balance / 2) & 1) != 0;
+    bool mixed[TETRO_TYPE_COUNT] = {false};
+    for (TetrominoType type = 0; type < TETRO_TYPE_COUNT; ++type)
+    {
+        size_t rotation_count = tetro_rotation_count(type);
+        size_t odd = 0;
+        for (size_t rot = 0; rot < rotation_count; ++rot)
+            odd += leans_odd(type, rot, by_column);
+        if (odd == rotation_count)
+            parity ^= (bag->counts[type] & 1) != 0;
+        else if (odd > 0 && bag->counts[type] > 0)
+            mixed[type] = true;
+    }
+
+    int chain = 0;
+    for (size_t i = 0; i < cnf->placement_num; ++i)
+    {
+        const Placement *p = cnf->placements + i;
+        if (!mixed[p->type] || !leans_odd(p->type, p->rotation, by_column))
+            continue;
+        int v = (int)i + 1;
+        if (chain == 0)
+        {
+            chain = v;
+            continue;
+        }
+        if (cnf->var_num == INT_MAX)
+            return STATUS_ERR_INVALID_ARGUMENT;
+        int next = ++cnf->var_num; // next <-> chain XOR v
+        bool ok = emit3(cnf, -next, chain, v) && emit3(cnf, -next, -chain, -v) && emit3(cnf, next, -chain, v) &&
+                  emit3(cnf, next, chain, -v);
+        if (!ok)
+            return STATUS_ERR_MEMORY;
+        chain = next;
+    }
+    if (chain == 0)
+        return parity ? (emit(cnf, NULL, 0) ? STATUS_OK : STATUS_ERR_MEMORY) : STATUS_OK;
+    int unit = parity ? chain : -chain;
+    return emit(cnf, &unit, 1) ? STATUS_OK : STATUS_ERR_MEMORY;
+}
+
+StatusCode cnf_encode(const Board *board, const TetrominoBag *bag, TilingCnf *out)
+{
+    if (!board || !bag || !out)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    memset(out, 0, sizeof(*out));
+    int W = board_width(board);
+    int H = board_height(board);
+    size_t cells = board_cell_count(board);
+    size_t filled = board_filled_count(board);
+    if (bag->total > SIZE_MAX / 4 || cells - filled != bag->total * 4)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    out->width = W;
+    out->height = H;
+    out->piece_num = bag->total;
+
+    // 1) placements that fit, in anchor/type/rotation order
+    size_t num = 0;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (int y = 0; y < H; ++y)
+        {
+            for (int x = 0; x < W; ++x)
+            {
+                for (TetrominoType type = 0; type < TETRO_TYPE_COUNT; ++type)
+                {
+                    if (bag->counts[type] == 0)
+                        continue;
+                    size_t rotation_count = tetro_rotation_count(type);
+                    for (size_t rot = 0; rot < rotation_count; ++rot)
+                    {
+                        if (!placement_fits(board, x, y, type, rot))
+                            continue;
+                        if (pass == 1)
+                        {
+                            Placement *p = out->placements + num;
+                            p->type = type;
+                            p->rotation = rot;
+                            p->x = x;
+                            p->y = y;
+                            p->mark = 0;
+                        }
+                        num++;
+                    }
+                }
+            }
+        }
+        if (pass == 0)
+        {
+            if (num > (size_t)INT_MAX)
+                return STATUS_ERR_INVALID_ARGUMENT;
+            out->placements = malloc((num > 0 ? num : 1) * PLACEMENT_SIZE);
+            if (!out->placements)
+                return STATUS_ERR_MEMORY;
+            out->placement_num = num;
+            num = 0;
+        }
+    }
+    out->var_num = (int)out->placement_num;
+
+    // cell -> covering placements (CSR), and each placement's sorted cells
+    size_t *pcells = malloc((num > 0 ? num : 1) * 4 * sizeof(size_t));
+    size_t *start = calloc(cells + 1, sizeof(size_t));
+    int *cover = malloc((num > 0 ? num : 1) * 4 * sizeof(int));
+    int *vars = malloc((num > 0 ? num : 1) * 2 * sizeof(int));
+    StatusCode res = (pcells && start && cover && vars) ? STATUS_OK : STATUS_ERR_MEMORY;
+    if (res == STATUS_OK)
+    {
+        for (size_t i = 0; i < num; ++i)
+        {
+            placement_cells(W, out->placements + i, pcells + 4 * i);
+            for (size_t c = 0; c < 4; ++c)
+                start[pcells[4 * i + c] + 1]++;
+        }
+        for (size_t c = 0; c < cells; ++c)
+            start[c + 1] += start[c];
+        size_t *cursor = malloc((cells > 0 ? cells : 1) * sizeof(size_t));
+        if (!cursor)
+            res = STATUS_ERR_MEMORY;
+        else
+        {
+            memcpy(cursor, start, cells * sizeof(size_t));
+            for (size_t i = 0; i < num; ++i)
+            {
+                for (size_t c = 0; c < 4; ++c)
+                    cover[cursor[pcells[4 * i + c]]++] = (int)i + 1;
+            }
+            free(cursor);
+        }
+    }
+
+    // 2) exactly one placement per empty cell
+    for (int y = 0; y < H && res == STATUS_OK; ++y)
+    {
+        for (int x = 0; x < W && res == STATUS_OK; ++x)
+        {
+            if (!board_is_empty(board, x, y))
+                continue;
+            size_t c = cell_index(W, x, y);
+            const int *list = cover + start[c];
+            size_t list_num = start[c + 1] - start[c];
+            if (!emit(out, list, list_num))
+                res = STATUS_ERR_MEMORY;
+            for (size_t a = 0; a < list_num && res == STATUS_OK; ++a)
+            {
+                const size_t *ca = pcells + 4 * (size_t)(list[a] - 1);
+                for (size_t b = a + 1; b < list_num && res == STATUS_OK; ++b)
+                {
+                    // exclude the pair only at its first common cell
+                    const size_t *cb = pcells + 4 * (size_t)(list[b] - 1);
+                    size_t first = SIZE_MAX;
+                    for (size_t i = 0; i < 4 && first == SIZE_MAX; ++i)
+                    {
+                        for (size_t j = 0; j < 4; ++j)
+                        {
+                            if (ca[i] == cb[j])
+                            {
+                                first = ca[i];
+                                break;
+                            }
+                        }
+                    }
+                    if (first == c && !emit2(out, -list[a], -list[b]))
+                        res = STATUS_ERR_MEMORY;
+                }
+            }
+        }
+    }
+
+    // 3) at most counts[t] placements of each type
+    for (TetrominoType type = 0; type < TETRO_TYPE_COUNT && res == STATUS_OK; ++type)
+    {
+        size_t n = 0;
+        for (size_t i = 0; i < num; ++i)
+        {
+            if (out->placements[i].type == type)
+                vars[n++] = (int)i + 1;
+        }
+        res = emit_at_most(out, vars, n, bag->counts[type]);
+    }
+
+    // 4) checkerboard balance, implied by the above but hard for clause learning to discover:
+    // every piece except T covers two cells of each colour, a T covers three of one colour
+    if (res == STATUS_OK)
+        res = emit_colour_balance(out, board, bag, vars);
+
+    // 5) stripe parity along columns and rows, likewise implied: with no T, an odd number of J and L
+    // pieces cannot tile an area whose stripes balance (e.g. any full board)
+    if (res == STATUS_OK)
+        res = emit_stripe_parity(out, board, bag, true);
+    if (res == STATUS_OK)
+        res = emit_stripe_parity(out, board, bag, false);
+
+    free(pcells);
+    free(start);
+    free(cover);
+    free(vars);
+    if (res != STATUS_OK)
+        cnf_free(out);
+    return res;
+}
+
+void cnf_free(TilingCnf *cnf)
+{
+    if (!cnf)
+        return;
+    free(cnf->lits);
+    free(cnf->placements);
+    memset(cnf, 0, sizeof(*cnf));
+}
+
+StatusCode cnf_write_dimacs(const TilingCnf *cnf, FILE *out)
+{
+    if (!cnf || !out)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    fprintf(out, "c tetromino tiling %d x %d, %zu pieces\n", cnf->width, cnf->height, cnf->piece_num);
+    for (size_t i = 0; i < cnf->placement_num; ++i)
+    {
+        const Placement *p = cnf->placements + i;
+        fprintf(out, "c placement %zu %s %zu %d %d\n", i + 1, tetro_type_name(p->type), p->rotation, p->x, p->y);
+    }
+    fprintf(out, "p cnf %d %zu\n", cnf->var_num, cnf->clause_num);
+    for (size_t i = 0; i < cnf->lit_num; ++i)
+    {
+        int lit = cnf->lits[i];
+        fprintf(out, lit == 0 ? "0\n" : "%d ", lit);
+    }
+    return ferror(out) ? STATUS_ERR_INPUT : STATUS_OK;
+}
+
+StatusCode cnf_read_model(const TilingCnf *cnf, FILE *in, bool *model)
+{
+    if (!cnf || !in || !model)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    memset(model, 0, ((size_t)cnf->var_num + 1) * sizeof(bool));
+
+    char token[TOKEN_MAX];
+    bool have_status = false;
+    bool satisfiable = false;
+    bool have_lits = false;
+    while (fscanf(in, "%63s", token) == 1)
+    {
+        if (strcmp(token, "c") == 0)
+        {
+            int ch;
+            while ((ch = fgetc(in)) != EOF && ch != '\n')
+                ;
+            continue;
+        }
+        if (strcmp(token, "s") == 0 || strcmp(token, "v") == 0)
+            continue;
+        if (strcmp(token, "SATISFIABLE") == 0 || strcmp(token, "SAT") == 0)
+        {
+            have_status = true;
+            satisfiable = true;
+            continue;
+        }
+        if (strcmp(token, "UNSATISFIABLE") == 0 || strcmp(token, "UNSAT") == 0)
+        {
+            have_status = true;
+            satisfiable = false;
+            continue;
+        }
+
+        char *end = NULL;
+        long lit = strtol(token, &end, 10);
+        if (*end != '\0' || lit < -(long)cnf->var_num || lit > (long)cnf->var_num)
+            return STATUS_ERR_INPUT;
+        if (lit != 0)
+            model[lit > 0 ? lit : -lit] = lit > 0;
+        have_lits = true;
+    }
+    if (have_status && !satisfiable)
+        return STATUS_ERR_UNSOLVABLE;
+    return have_lits ? STATUS_OK : STATUS_ERR_INPUT;
+}
+
+static int cmp_chosen(const void *a, const void *b)
+{
+    const ChosenPiece *pa = a;
+    const ChosenPiece *pb = b;
+    return (pa->first_cell > pb->first_cell) - (pa->first_cell < pb->first_cell);
+}
+
+StatusCode cnf_apply_model(const TilingCnf *cnf, const bool *model, Board *board, Placement *out_list)
+{
+    if (!cnf || !model || !board || !out_list)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    if (board_width(board) != cnf->width || board_height(board) != cnf->height)
+        return STATUS_ERR_INPUT;
+
+    // the chosen placements, ordered by their first cell
+    ChosenPiece *chosen = malloc((cnf->piece_num > 0 ? cnf->piece_num : 1) * sizeof(ChosenPiece));
+    if (!chosen)
+        return STATUS_ERR_MEMORY;
+    size_t n = 0;
+    for (size_t i = 0; i < cnf->placement_num; ++i)
+    {
+        if (!model[i + 1])
+            continue;
+        if (n == cnf->piece_num)
+        {
+            free(chosen);
+            return STATUS_ERR_INPUT; // more pieces than the bag holds
+        }
+        size_t cells[4];
+        placement_cells(cnf->width, cnf->placements + i, cells);
+        chosen[n].first_cell = cells[0];
+        chosen[n].index = i;
+        n++;
+    }
+    if (n != cnf->piece_num)
+    {
+        free(chosen);
+        return STATUS_ERR_INPUT;
+    }
+    qsort(chosen, n, sizeof(ChosenPiece), cmp_chosen);
+
+    // place them; n disjoint pieces over an area of 4n empty cells form a tiling
+    StatusCode res = STATUS_OK;
+    size_t placed = 0;
+    for (; placed < n; ++placed)
+    {
+        Placement *p = out_list + placed;
+        *p = cnf->placements[chosen[placed].index];
+        p->mark = (char)('A' + (placed % MARK_NUM));
+        if (!board_place(board, p->x, p->y, p->type, p->rotation, p->mark))
+        {
+            res = STATUS_ERR_INPUT;
+            break;
+        }
+    }
+    if (res != STATUS_OK)
+    {
+        for (size_t i = placed; i > 0; --i)
+        {
+            const Placement *p = out_list + i - 1;
+            board_remove(board, p->x, p->y, p->type, p->rotation);
+        }
+    }
+    free(chosen);
+    return res;
+}
+
+StatusCode cnf_solve(Board *board,
+                     const TetrominoBag *bag,
+                     uint64_t conflict_limit,
+                     Placement *out_list,
+                     SatStats *out_stats,
+                     bool *out_limited)
+{
+    if (out_stats)
+        memset(out_stats, 0, sizeof(*out_stats));
+    if (out_limited)
+        *out_limited = false;
+    if (!board || !bag || !out_list)
+        return STATUS_ERR_INVALID_ARGUMENT;
+
+    TilingCnf cnf;
+    StatusCode res = cnf_encode(board, bag, &cnf);
+    if (res != STATUS_OK)
+        return res;
+    SatSolver *solver = sat_create(cnf.var_num);
+    if (!solver)
+    {
+        cnf_free(&cnf);
+        return STATUS_ERR_MEMORY;
+    }
+
+    // feed the 0-terminated clauses
+    size_t begin = 0;
+    for (size_t i = 0; i < cnf.lit_num && res == STATUS_OK; ++i)
+    {
+        if (cnf.lits[i] != 0)
+            continue;
+        res = sat_add_clause(solver, cnf.lits + begin, i - begin);
+        begin = i + 1;
+    }
+
+    if (res == STATUS_OK)
+    {
+        sat_set_conflict_limit(solver, conflict_limit);
+        SatResult sat = sat_solve(solver);
+        if (sat == SAT_UNSATISFIABLE)
+        {
+            res = STATUS_ERR_UNSOLVABLE;
+        }
+        else if (sat == SAT_UNKNOWN)
+        {
+            res = STATUS_ERR_UNSOLVABLE;
+            if (out_limited)
+                *out_limited = true;
+        }
+        else if (sat == SAT_ERROR)
+        {
+            res = STATUS_ERR_MEMORY;
+        }
+        else
+        {
+            bool *model = malloc(((size_t)cnf.var_num + 1) * sizeof(bool));
+            if (!model)
+            {
+                res = STATUS_ERR_MEMORY;
+            }
+            else
+            {
+                model[0] = false;
+                for (int v = 1; v <= cnf.var_num; ++v)
+                    model[v] = sat_model_value(solver, v);
+                res = cnf_apply_model(&cnf, model, board, out_list);
+                free(model);
+            }
+        }
+    }
+    if (out_stats)
+        sat_stats(solver, out_stats);
+    sat_destroy(solver);
+    cnf_free(&cnf);
+    return res;
+}
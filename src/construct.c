@@ -0,0 +1,334 @@
+#include <string.h>
+#include "construct.h"
+#include "tetromino.h"
+
+/* Constructive tiling implementation:
+ *   - A small library of tileable blocks (2x2, 4x1, 4x2/2x4 pairs, 4x4 quads).
+ *   - Allocate the bag to blocks with a greedy pass; reject when anything is left over.
+ *   - Lay the blocks out on a fixed rectangle decomposition of the board. */
+
+#define MARK_NUM 26 // 26 letters from A-Z
+#define BLOCK_MAX_PIECES 4
+
+// a piece inside a block, anchored relative to the block's top-left
+typedef struct BlockPiece
+{
+    TetrominoType type;
+    size_t rotation;
+    int x;
+    int y;
+} BlockPiece;
+
+// a small rectangle with a fixed tiling
+typedef struct TileBlock
+{
+    size_t piece_num;
+    BlockPiece pieces[BLOCK_MAX_PIECES];
+} TileBlock;
+
+// pair blocks: two pieces of the same type
+typedef enum PairKind
+{
+    PAIR_I = 0,
+    PAIR_O,
+    PAIR_J,
+    PAIR_L,
+    PAIR_KIND_COUNT
+} PairKind;
+
+static const TetrominoType PAIR_TYPES[PAIR_KIND_COUNT] = {TETRO_I, TETRO_O, TETRO_J, TETRO_L};
+
+// 4 wide x 2 high
+static const TileBlock PAIR_WIDE[PAIR_KIND_COUNT] = {
+    {2, {{TETRO_I, 0, 0, 0}, {TETRO_I, 0, 0, 1}}},
+    {2, {{TETRO_O, 0, 0, 0}, {TETRO_O, 0, 2, 0}}},
+    {2, {{TETRO_J, 0, 0, 0}, {TETRO_J, 2, 1, 0}}},
+    {2, {{TETRO_L, 2, 0, 0}, {TETRO_L, 0, 1, 0}}},
+};
+
+// 2 wide x 4 high
+static const TileBlock PAIR_TALL[PAIR_KIND_COUNT] = {
+    {2, {{TETRO_I, 1, 0, 0}, {TETRO_I, 1, 1, 0}}},
+    {2, {{TETRO_O, 0, 0, 0}, {TETRO_O, 0, 0, 2}}},
+    {2, {{TETRO_J, 1, 0, 0}, {TETRO_J, 3, 0, 1}}},
+    {2, {{TETRO_L, 3, 0, 0}, {TETRO_L, 1, 0, 1}}},
+};
+
+// quad blocks: 4x4 squares that absorb T, S and Z
+typedef enum QuadKind
+{
+    QUAD_TTTT = 0,
+    QUAD_JJSS,
+    QUAD_LLZZ,
+    QUAD_JSTT,
+    QUAD_IJLS,
+    QUAD_ILLS,
+    QUAD_LTTZ,
+    QUAD_IJLZ,
+    QUAD_IJJZ,
+    QUAD_KIND_COUNT
+} QuadKind;
+
+static const TileBlock QUADS[QUAD_KIND_COUNT] = {
+    {4, {{TETRO_T, 0, 0, 0}, {TETRO_T, 3, 0, 1}, {TETRO_T, 1, 2, 0}, {TETRO_T, 2, 1, 2}}},
+    {4, {{TETRO_S, 1, 0, 0}, {TETRO_J, 2, 1, 0}, {TETRO_S, 1, 2, 1}, {TETRO_J, 0, 0, 2}}},
+    {4, {{TETRO_Z, 0, 0, 0}, {TETRO_L, 3, 2, 0}, {TETRO_L, 1, 0, 1}, {TETRO_Z, 0, 1, 2}}},
+    {4, {{TETRO_T, 3, 0, 0}, {TETRO_T, 0, 1, 0}, {TETRO_J, 3, 2, 1}, {TETRO_S, 0, 0, 2}}},
+    {4, {{TETRO_I, 0, 0, 0}, {TETRO_J, 1, 0, 1}, {TETRO_S, 0, 1, 1}, {TETRO_L, 0, 1, 2}}},
+    {4, {{TETRO_I, 0, 0, 0}, {TETRO_L, 1, 0, 1}, {TETRO_S, 1, 1, 1}, {TETRO_L, 3, 2, 1}}},
+    {4, {{TETRO_T, 0, 0, 0}, {TETRO_T, 1, 2, 0}, {TETRO_L, 1, 0, 1}, {TETRO_Z, 0, 1, 2}}},
+    {4, {{TETRO_I, 0, 0, 0}, {TETRO_Z, 0, 0, 1}, {TETRO_L, 3, 2, 1}, {TETRO_J, 0, 0, 2}}},
+    {4, {{TETRO_I, 0, 0, 0}, {TETRO_J, 1, 0, 1}, {TETRO_Z, 1, 1, 1}, {TETRO_J, 3, 2, 1}}},
+};
+
+// block counts chosen for a bag
+typedef struct BlockPlan
+{
+    size_t quads[QUAD_KIND_COUNT];
+    size_t pairs[PAIR_KIND_COUNT];
+    size_t quad_total;
+} BlockPlan;
+
+// running state while laying blocks out
+typedef struct LayoutCursor
+{
+    Board *board;
+    Placement *out_list;
+    size_t capacity;
+    size_t placed;
+} LayoutCursor;
+
+// get mark based on placement index
+static inline char mark_at(size_t index)
+{
+    return (char)('A' + (index % MARK_NUM));
+}
+
+// place one piece and record it; false if the board rejects it or the list is full
+static bool emit_piece(LayoutCursor *cur, TetrominoType type, size_t rotation, int x, int y)
+{
+    if (cur->placed >= cur->capacity)
+        return false;
+    char mark = mark_at(cur->placed);
+    if (!board_place(cur->board, x, y, type, rotation, mark))
+        return false;
+    Placement *p = cur->out_list + cur->placed;
+    p->type = type;
+    p->rotation = rotation;
+    p->x = x;
+    p->y = y;
+    p->mark = mark;
+    cur->placed++;
+    return true;
+}
+
+// place all pieces of a block with its top-left at (ox,oy)
+static bool emit_block(LayoutCursor *cur, const TileBlock *block, int ox, int oy)
+{
+    for (size_t i = 0; i < block->piece_num; ++i)
+    {
+        const BlockPiece *bp = block->pieces + i;
+        if (!emit_piece(cur, bp->type, bp->rotation, ox + bp->x, oy + bp->y))
+            return false;
+    }
+    return true;
+}
+
+// consume one quad block from counts if the bag can afford it
+static bool take_quad(size_t counts[TETRO_TYPE_COUNT], BlockPlan *plan, QuadKind kind)
+{
+    size_t need[TETRO_TYPE_COUNT] = {0};
+    const TileBlock *block = QUADS + kind;
+    for (size_t i = 0; i < block->piece_num; ++i)
+        need[block->pieces[i].type]++;
+    for (size_t t = 0; t < TETRO_TYPE_COUNT; ++t)
+    {
+        if (counts[t] < need[t])
+            return false;
+    }
+    for (size_t t = 0; t < TETRO_TYPE_COUNT; ++t)
+        counts[t] -= need[t];
+    plan->quads[kind]++;
+    plan->quad_total++;
+    return true;
+}
+
+// greedy allocation of the bag to blocks; false if some pieces cannot be absorbed
+static bool plan_blocks(const TetrominoBag *bag, BlockPlan *plan)
+{
+    size_t counts[TETRO_TYPE_COUNT];
+    memcpy(counts, bag->counts, sizeof(counts));
+    memset(plan, 0, sizeof(*plan));
+
+    // S and Z in matching pairs first, then one at a time with helpers
+    while (counts[TETRO_S] >= 2 && take_quad(counts, plan, QUAD_JJSS))
+        ;
+    while (counts[TETRO_Z] >= 2 && take_quad(counts, plan, QUAD_LLZZ))
+        ;
+    while (counts[TETRO_S] > 0)
+    {
+        if (!take_quad(counts, plan, QUAD_JSTT) &&
+            !take_quad(counts, plan, QUAD_IJLS) &&
+            !take_quad(counts, plan, QUAD_ILLS))
+            return false;
+    }
+    while (counts[TETRO_Z] > 0)
+    {
+        if (!take_quad(counts, plan, QUAD_LTTZ) &&
+            !take_quad(counts, plan, QUAD_IJLZ) &&
+            !take_quad(counts, plan, QUAD_IJJZ))
+            return false;
+    }
+
+    // T only comes in fours
+    if (counts[TETRO_T] % 4 != 0)
+        return false;
+    plan->quads[QUAD_TTTT] += counts[TETRO_T] / 4;
+    plan->quad_total += counts[TETRO_T] / 4;
+    counts[TETRO_T] = 0;
+
+    // everything else must pair up
+    for (size_t k = 0; k < PAIR_KIND_COUNT; ++k)
+    {
+        size_t c = counts[PAIR_TYPES[k]];
+        if (c % 2 != 0)
+            return false;
+        plan->pairs[k] = c / 2;
+    }
+    return true;
+}
+
+// next block kind with remaining budget, or KIND_COUNT when exhausted
+static size_t next_kind(size_t *remaining, size_t kind_count)
+{
+    for (size_t k = 0; k < kind_count; ++k)
+    {
+        if (remaining[k] > 0)
+        {
+            remaining[k]--;
+            return k;
+        }
+    }
+    return kind_count;
+}
+
+// place the next pair block (wide or tall) at (x,y)
+static bool emit_next_pair(LayoutCursor *cur, BlockPlan *plan, bool wide, int x, int y)
+{
+    size_t k = next_kind(plan->pairs, PAIR_KIND_COUNT);
+    if (k == PAIR_KIND_COUNT)
+        return false;
+    return emit_block(cur, wide ? PAIR_WIDE + k : PAIR_TALL + k, x, y);
+}
+
+// single-type layouts: O on an even grid, I in rows or columns
+static bool layout_uniform(LayoutCursor *cur, const TetrominoBag *bag, int W, int H, bool *matched)
+{
+    *matched = false;
+    if (bag->counts[TETRO_O] == bag->total && W % 2 == 0 && H % 2 == 0)
+    {
+        *matched = true;
+        for (int y = 0; y < H; y += 2)
+            for (int x = 0; x < W; x += 2)
+                if (!emit_piece(cur, TETRO_O, 0, x, y))
+                    return false;
+        return true;
+    }
+    if (bag->counts[TETRO_I] == bag->total && (W % 4 == 0 || H % 4 == 0))
+    {
+        *matched = true;
+        bool rows = W % 4 == 0;
+        int step_x = rows ? 4 : 1;
+        int step_y = rows ? 1 : 4;
+        for (int y = 0; y < H; y += step_y)
+            for (int x = 0; x < W; x += step_x)
+                if (!emit_piece(cur, TETRO_I, rows ? 0 : 1, x, y))
+                    return false;
+        return true;
+    }
+    return true;
+}
+
+// block layout: 4x4 units (quad or two pairs) plus a leftover strip of pairs
+static bool layout_blocks(LayoutCursor *cur, BlockPlan *plan, int W, int H, bool wide)
+{
+    // 4x4 units in row-major order
+    for (int y = 0; y + 4 <= H; y += 4)
+    {
+        for (int x = 0; x + 4 <= W; x += 4)
+        {
+            size_t q = next_kind(plan->quads, QUAD_KIND_COUNT);
+            if (q != QUAD_KIND_COUNT)
+            {
+                if (!emit_block(cur, QUADS + q, x, y))
+                    return false;
+                continue;
+            }
+            if (!emit_next_pair(cur, plan, wide, x, y))
+                return false;
+            if (!emit_next_pair(cur, plan, wide, wide ? x : x + 2, wide ? y + 2 : y))
+                return false;
+        }
+    }
+
+    // leftover strip: bottom 4x2 row (wide) or right 2x4 column (tall)
+    if (wide && H % 4 == 2)
+    {
+        for (int x = 0; x < W; x += 4)
+            if (!emit_next_pair(cur, plan, true, x, H - 2))
+                return false;
+    }
+    else if (!wide && W % 4 == 2)
+    {
+        for (int y = 0; y < H; y += 4)
+            if (!emit_next_pair(cur, plan, false, W - 2, y))
+                return false;
+    }
+    return true;
+}
+
+bool construct_tiling(Board *board,
+                      const TetrominoBag *bag,
+                      Placement *out_list,
+                      size_t capacity)
+{
+    if (!board || !bag || !out_list)
+        return false;
+    if (capacity < bag->total || bag->total == 0)
+        return false;
+    int W = board_width(board);
+    int H = board_height(board);
+    if (bag->total > board_cell_count(board) / 4 || bag->total * 4 != board_cell_count(board))
+        return false;
+    if (board_filled_count(board) != 0)
+        return false;
+
+    LayoutCursor cur = {board, out_list, capacity, 0};
+
+    // single-type boards need no block planning
+    bool matched = false;
+    bool ok = layout_uniform(&cur, bag, W, H, &matched);
+    if (!matched)
+    {
+        // 4x2 pairs when W%4==0 && H even, otherwise 2x4 pairs when W even && H%4==0
+        bool wide = W % 4 == 0 && H % 2 == 0;
+        bool tall = W % 2 == 0 && H % 4 == 0;
+        if (!wide && !tall)
+            return false;
+        BlockPlan plan;
+        if (!plan_blocks(bag, &plan))
+            return false;
+        size_t quad_slots = (size_t)(W / 4) * (size_t)(H / 4);
+        if (plan.quad_total > quad_slots)
+            return false;
+        ok = layout_blocks(&cur, &plan, W, H, wide);
+    }
+
+    if (!ok || cur.placed != bag->total)
+    {
+        // defensive: a library block did not fit; leave the board as we found it
+        board_clear(board);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,219 @@
+#include <stdlib.h>
+#include <string.h>
+#include "endgame.h"
+#include "tetromino.h"
+
+/* Endgame table implementation:
+ *   - Normalize the residual region to offsets from its first empty cell.
+ *   - Key = offsets + remaining counts; direct-mapped cache of results.
+ *   - Misses are solved by a small recursive search over the region only. */
+
+#define ENDGAME_OFFSET_MIN (-128)
+#define ENDGAME_OFFSET_MAX 127
+
+// normalized residual region plus remaining counts
+typedef struct EndgameKey
+{
+    uint8_t cell_num;
+    uint8_t counts[TETRO_TYPE_COUNT];
+    int8_t cells[ENDGAME_MAX_CELLS][2]; // (dx,dy) in row-major order; cells[0] is (0,0)
+} EndgameKey;
+
+// a placement relative to the region's first cell
+typedef struct EndgamePiece
+{
+    uint8_t type;
+    uint8_t rotation;
+    int8_t dx;
+    int8_t dy;
+} EndgamePiece;
+
+typedef struct EndgameEntry
+{
+    bool used;
+    bool tileable;
+    uint8_t piece_num;
+    EndgameKey key;
+    EndgamePiece pieces[ENDGAME_MAX_PIECES];
+} EndgameEntry;
+
+struct EndgameTable
+{
+    size_t mask;
+    EndgameEntry entries[];
+};
+
+EndgameTable *endgame_create(unsigned capacity_log2)
+{
+    if (capacity_log2 < 1 || capacity_log2 > 24)
+        return NULL;
+    size_t capacity = (size_t)1 << capacity_log2;
+    EndgameTable *table = calloc(1, sizeof(EndgameTable) + capacity * sizeof(EndgameEntry));
+    if (!table)
+        return NULL;
+    table->mask = capacity - 1;
+    return table;
+}
+
+void endgame_destroy(EndgameTable *table)
+{
+    if (!table)
+        return;
+    free(table);
+}
+
+// FNV-1a over the key bytes (key is zero-initialized, so padding-free compare is safe)
+static size_t key_hash(const EndgameKey *key)
+{
+    const unsigned char *p = (const unsigned char *)key;
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < sizeof(*key); ++i)
+    {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return (size_t)h;
+}
+
+// collect the residual region; false when it cannot be represented
+static bool build_key(const Board *board, Cell first, const size_t counts[TETRO_TYPE_COUNT],
+                      size_t remaining, EndgameKey *key)
+{
+    memset(key, 0, sizeof(*key));
+    for (size_t t = 0; t < TETRO_TYPE_COUNT; ++t)
+    {
+        if (counts[t] > ENDGAME_MAX_PIECES)
+            return false;
+        key->counts[t] = (uint8_t)counts[t];
+    }
+
+    int W = board_width(board);
+    int H = board_height(board);
+    size_t n = 0;
+    for (int y = first.y; y < H && n < remaining; ++y)
+    {
+        for (int x = (y == first.y ? first.x : 0); x < W && n < remaining; ++x)
+        {
+            if (!board_is_empty(board, x, y))
+                continue;
+            int dx = x - first.x;
+            int dy = y - first.y;
+            if (dx < ENDGAME_OFFSET_MIN || dx > ENDGAME_OFFSET_MAX || dy > ENDGAME_OFFSET_MAX)
+                return false;
+            key->cells[n][0] = (int8_t)dx;
+            key->cells[n][1] = (int8_t)dy;
+            n++;
+        }
+    }
+    if (n != remaining)
+        return false; // empty cells before first_empty: caller broke the contract
+    key->cell_num = (uint8_t)n;
+    return true;
+}
+
+// index of region cell (dx,dy), or -1 if it is not part of the region
+static int region_index(const EndgameKey *key, int dx, int dy)
+{
+    for (int i = 0; i < (int)key->cell_num; ++i)
+    {
+        if (key->cells[i][0] == dx && key->cells[i][1] == dy)
+            return i;
+    }
+    return -1;
+}
+
+// depth-first search in the solver's try order; writes the first tiling found
+static bool solve_region(const EndgameKey *key, uint32_t covered, uint8_t counts[TETRO_TYPE_COUNT],
+                         EndgamePiece *out, size_t depth)
+{
+    uint32_t full = (key->cell_num >= 32) ? UINT32_MAX : ((1u << key->cell_num) - 1u);
+    if (covered == full)
+        return true;
+
+    // first uncovered cell in row-major order
+    int first = 0;
+    while (covered & (1u << first))
+        first++;
+    int ax = key->cells[first][0];
+    int ay = key->cells[first][1];
+
+    for (TetrominoType type = 0; type < TETRO_TYPE_COUNT; ++type)
+    {
+        if (counts[type] == 0)
+            continue;
+        size_t rotation_count = tetro_rotation_count(type);
+        for (size_t rot = 0; rot < rotation_count; ++rot)
+        {
+            Cell cells[4];
+            size_t cell_num = tetro_get_cells(type, rot, cells);
+            uint32_t piece = 0;
+            bool fits = cell_num == 4;
+            for (size_t i = 0; i < cell_num && fits; ++i)
+            {
+                int idx = region_index(key, ax + cells[i].x, ay + cells[i].y);
+                if (idx < 0 || (covered & (1u << idx)))
+                    fits = false;
+                else
+                    piece |= 1u << idx;
+            }
+            if (!fits)
+                continue;
+
+            counts[type]--;
+            out[depth].type = (uint8_t)type;
+            out[depth].rotation = (uint8_t)rot;
+            out[depth].dx = (int8_t)ax;
+            out[depth].dy = (int8_t)ay;
+            bool ok = solve_region(key, covered | piece, counts, out, depth + 1);
+            counts[type]++;
+            if (ok)
+                return true;
+        }
+    }
+    return false;
+}
+
+EndgameResult endgame_probe(EndgameTable *table,
+                            const Board *board,
+                            Cell first_empty,
+                            const size_t counts[TETRO_TYPE_COUNT],
+                            size_t remaining_cells,
+                            Placement *out_tail,
+                            size_t *out_num)
+{
+    if (!table || !board || !counts || !out_tail || !out_num)
+        return ENDGAME_SKIP;
+    if (remaining_cells == 0 || remaining_cells > ENDGAME_MAX_CELLS || remaining_cells % 4 != 0)
+        return ENDGAME_SKIP;
+
+    EndgameKey key;
+    if (!build_key(board, first_empty, counts, remaining_cells, &key))
+        return ENDGAME_SKIP;
+
+    EndgameEntry *entry = table->entries + (key_hash(&key) & table->mask);
+    if (!entry->used || memcmp(&entry->key, &key, sizeof(key)) != 0)
+    {
+        // miss: solve the region once and cache the outcome
+        uint8_t work_counts[TETRO_TYPE_COUNT];
+        memcpy(work_counts, key.counts, sizeof(work_counts));
+        entry->used = true;
+        entry->key = key;
+        entry->tileable = solve_region(&key, 0, work_counts, entry->pieces, 0);
+        entry->piece_num = entry->tileable ? (uint8_t)(remaining_cells / 4) : 0;
+    }
+
+    if (!entry->tileable)
+        return ENDGAME_DEAD;
+    for (size_t i = 0; i < entry->piece_num; ++i)
+    {
+        const EndgamePiece *ep = entry->pieces + i;
+        Placement *p = out_tail + i;
+        p->type = (TetrominoType)ep->type;
+        p->rotation = ep->rotation;
+        p->x = first_empty.x + ep->dx;
+        p->y = first_empty.y + ep->dy;
+        p->mark = '\0';
+    }
+    *out_num = entry->piece_num;
+    return ENDGAME_TILEABLE;
+}
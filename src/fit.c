@@ -0,0 +1,110 @@
+#include <pthread.h>
+#include "fit.h"
+
+/* Fit kernel implementation:
+ *   - One 16-bit mask per orientation, built from tetro_get_cells on first use.
+ *   - An orientation fits iff (mask & ~window) == 0; the SIMD kernels test 16 (AVX2) or 8 (SSE2)
+ *     masks per instruction and compress the lane results into one bit per orientation.
+ *   - Selection happens once under pthread_once, so concurrent portfolio workers share it safely. */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FIT_X86 1
+#include <immintrin.h>
+#endif
+
+#define FIT_SLOTS 32 // masks padded to two AVX2 vectors (four SSE2 vectors)
+
+typedef uint32_t (*FitKernel)(uint16_t window);
+
+static _Alignas(32) uint16_t fit_masks[FIT_SLOTS]; // padding slots stay 0 and are masked off
+static FitKernel fit_kernel;
+static const char *fit_name = "scalar";
+static pthread_once_t fit_once = PTHREAD_ONCE_INIT;
+
+static uint32_t fit_scalar(uint16_t window)
+{
+    uint32_t fits = 0;
+    uint16_t empty = (uint16_t)~window;
+    for (unsigned i = 0; i < FIT_ORIENTATION_NUM; ++i)
+    {
+        if ((fit_masks[i] & empty) == 0)
+            fits |= 1u << i;
+    }
+    return fits;
+}
+
+#ifdef FIT_X86
+__attribute__((target("sse2"))) static uint32_t fit_sse2(uint16_t window)
+{
+    __m128i win = _mm_set1_epi16((short)window);
+    __m128i zero = _mm_setzero_si128();
+    const __m128i *masks = (const __m128i *)fit_masks;
+    uint32_t fits = 0;
+    for (unsigned v = 0; v < FIT_SLOTS / 8; v += 2)
+    {
+        __m128i lo = _mm_cmpeq_epi16(_mm_andnot_si128(win, _mm_load_si128(masks + v)), zero);
+        __m128i hi = _mm_cmpeq_epi16(_mm_andnot_si128(win, _mm_load_si128(masks + v + 1)), zero);
+        // saturating pack keeps 0/-1 per lane, so one byte mask yields 16 orientation bits
+        fits |= (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(lo, hi)) << (v * 8);
+    }
+    return fits & FIT_ALL;
+}
+
+__attribute__((target("avx2"))) static uint32_t fit_avx2(uint16_t window)
+{
+    __m256i win = _mm256_set1_epi16((short)window);
+    __m256i zero = _mm256_setzero_si256();
+    const __m256i *masks = (const __m256i *)fit_masks;
+    __m256i lo = _mm256_cmpeq_epi16(_mm256_andnot_si256(win, _mm256_load_si256(masks)), zero);
+    __m256i hi = _mm256_cmpeq_epi16(_mm256_andnot_si256(win, _mm256_load_si256(masks + 1)), zero);
+    // the pack works per 128-bit lane; reorder the quadwords back to orientation order
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(lo, hi), 0xD8);
+    return (uint32_t)_mm256_movemask_epi8(packed) & FIT_ALL;
+}
+#endif
+
+// build the orientation masks and pick the widest kernel this CPU supports
+static void fit_setup(void)
+{
+    unsigned i = 0;
+    for (TetrominoType type = 0; type < TETRO_TYPE_COUNT; ++type)
+    {
+        size_t rotation_count = tetro_rotation_count(type);
+        for (size_t rot = 0; rot < rotation_count && i < FIT_ORIENTATION_NUM; ++rot, ++i)
+        {
+            Cell cells[4];
+            size_t cell_num = tetro_get_cells(type, rot, cells);
+            uint16_t mask = 0;
+            for (size_t c = 0; c < cell_num; ++c)
+                mask = (uint16_t)(mask | (1u << (cells[c].y * FIT_WINDOW + cells[c].x)));
+            fit_masks[i] = mask;
+        }
+    }
+
+    fit_kernel = fit_scalar;
+#ifdef FIT_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        fit_kernel = fit_avx2;
+        fit_name = "avx2";
+    }
+    else if (__builtin_cpu_supports("sse2"))
+    {
+        fit_kernel = fit_sse2;
+        fit_name = "sse2";
+    }
+#endif
+}
+
+uint32_t fit_orientations(uint16_t window)
+{
+    pthread_once(&fit_once, fit_setup);
+    return fit_kernel(window);
+}
+
+const char *fit_kernel_name(void)
+{
+    pthread_once(&fit_once, fit_setup);
+    return fit_name;
+}
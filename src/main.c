@@ -2,31 +2,490 @@
 #include <stdio.h>
 #include <errno.h>
 #include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include <limits.h>
 #include "types.h"
 #include "parser.h"
 #include "board.h"
 #include "solver.h"
+#include "checkpoint.h"
+#include "workunit.h"
+#include "cnf.h"
+#include "progress.h"
+#include "query.h"
+#include "perfcount.h"
+#include "stream.h"
+#include "resolve.h"
+#include "metrics.h"
 
 /* 程序入口：
  * - 原型：int main(int argc, char** argv);
- * - 输入：若提供 argv[1]，从该文件读取；否则从 stdin 读取。
- * - 流程：解析 → 创建棋盘 → 调用 solver → 输出 → 按 StatusCode 作为进程退出码返回。
+ * - 输入：若提供 INPUT_FILE，从该文件读取；否则从 stdin 读取。
+ * - 选项：--randomize / --seed N / --restarts N / --threads N / --deterministic /
+ *         --checkpoint FILE / --checkpoint-interval SECS / --resume FILE /
+ *         --engine NAME / --order NAME / --scan NAME / --count / --split DEPTH / --split-dir DIR / --work-unit FILE /
+ *         --result FILE / --merge FILES... / --dimacs FILE / --sat-model FILE / --progress SECS / --query FILE /
+ *         --perf / --stream ROWS / --previous FILE / --all / --limit N / --metrics FILE
+ *         （见 parser_print_usage）。
+ * - 性能计数：--perf 时在求解/计数/查询前后读取硬件计数器（perfcount.h），按搜索节点归一化后输出到 stderr；
+ *   计数器不可用（非 Linux、虚拟机、权限不足）时只输出一行说明，不影响求解。
+ * - 进度：求解与计数期间收到 SIGUSR1（或每隔 --progress 秒）时，向 stderr 输出一行进度（progress.h）。
+ * - 指标：--metrics FILE 时把本次运行的耗时与节点数按棋盘面积与结果记入直方图，退出前合并写入 FILE
+ *   （Prometheus 文本格式，多个批处理进程可共用同一文件，见 metrics.h）。
+ * - 障碍：输入可在尺寸行后给出障碍网格（见 parser.h），创建棋盘后把这些格子设为障碍（board_block_cell），
+ *   输出中显示为 '#'；分带流式求解不支持障碍。
+ * - 流程：解析 → 创建棋盘 → 调用 solver（或拆分/计数/合并） → 输出 → 按 StatusCode 作为进程退出码返回。
  * - 输出：
  *     成功：将解通过 board_print 输出到 stdout；返回 0。
  *     无解：输出 "No solution\n" 到 stdout；返回 3。
+ *     计数：输出 "Solutions: N\n"；N > 0 返回 0，否则返回 3。
+ *     枚举（--all / --limit N）：按覆盖模式的搜索顺序逐个输出全部铺法、各一次（空行分隔，每个解输出后立即刷新），
+ *       最后输出 "Solutions: K"（达到上限时附注 "(limit reached)"）；K > 0 返回 0，否则返回 3。
+ *     拆分：输出 "Units: N\n"；返回 0。
+ *     导出 DIMACS：输出 "DIMACS: V variables, C clauses\n"；返回 0。
+ *     读取外部 SAT 模型：与求解相同（铺法或 "No solution"）。
+ *     可行性查询：对查询文件中的每个背包输出 "<背包>: yes" 及铺法，或 "<背包>: no"，
+ *       最后输出 "Feasible: K of N"；K > 0 返回 0，否则返回 3（输入文件中的背包被忽略，只用其尺寸）。
+ *     分带流式求解（--stream ROWS）：不创建整块棋盘，每提交一个 ROWS 行的带就输出这些行；
+ *       全部完成返回 0；卡住时已输出的行保留，再输出 "No solution" 并返回 3（带不回溯，不代表实例无解）。
+ *     增量重解（--previous FILE）：读入上次的铺法（board_print 格式），保留仍然适用的块，只在改动附近拆除重铺
+ *       （邻域逐轮扩大，最后才整盘求解，见 resolve.h）；输出与求解相同，并向 stderr 输出一行保留情况。
  *     输入错误/资源错误等：将简要错误信息与用法说明输出到 stderr；分别返回相应错误码。 */
 
-int main(int argc, char **argv)
+// what the invocation does
+typedef enum CliMode
+{
+    CLI_SOLVE = 0, // solve (or count) the input instance
+    CLI_SPLIT,     // write work units for the input instance
+    CLI_WORK_UNIT, // solve (or count) one work unit
+    CLI_MERGE,     // merge result files
+    CLI_DIMACS,    // write the CNF encoding of the input instance
+    CLI_SAT_MODEL, // decode an external SAT solver's model for the input instance
+    CLI_QUERY,     // answer many bags for the input board
+    CLI_STREAM     // solve the input instance band by band, without holding the whole board
+} CliMode;
+
+// command line options
+typedef struct CliOptions
+{
+    CliMode mode;
+    const char *input_path; // NULL means stdin
+    SolverConfig config;
+    bool seed_given;
+    bool count;                     // count all tilings instead of finding one
+    bool all;                       // print every tiling (up to limit) instead of the first
+    uint64_t limit;                 // --all: stop after this many tilings; 0 = no limit
+    size_t split_depth;             // CLI_SPLIT: frames fixed per unit
+    size_t stream_rows;             // CLI_STREAM: rows per band
+    const char *split_dir;          // CLI_SPLIT: output directory
+    const char *unit_path;          // CLI_WORK_UNIT: unit file
+    const char *result_path;        // optional result file for solve/count runs
+    const char *const *merge_paths; // CLI_MERGE: result files in unit order
+    size_t merge_num;
+    const char *cnf_path; // CLI_DIMACS: output file; CLI_SAT_MODEL: model file; CLI_QUERY: query file
+    unsigned progress_interval; // seconds between progress lines; 0 = on SIGUSR1 only
+    bool perf;                  // report hardware counters around the solve
+    const char *previous_path;  // CLI_SOLVE: previous tiling to repair instead of solving from scratch
+    const char *metrics_path;   // histogram file merged across runs; NULL = no metrics
+} CliOptions;
+
+// parse a non-negative decimal integer that must fill the whole argument
+static bool parse_u64(const char *text, uint64_t *out)
+{
+    if (!text || *text < '0' || *text > '9')
+        return false;
+    uint64_t val = 0;
+    for (const char *p = text; *p; ++p)
+    {
+        if (*p < '0' || *p > '9')
+            return false;
+        uint64_t digit = (uint64_t)(*p - '0');
+        if (val > (UINT64_MAX - digit) / 10)
+            return false;
+        val = val * 10 + digit;
+    }
+    *out = val;
+    return true;
+}
+
+// fetch the value of an option that takes one argument
+static const char *option_value(int argc, char **argv, int *i)
+{
+    if (*i + 1 >= argc)
+    {
+        fprintf(stderr, "Error: option '%s' needs a value\n", argv[*i]);
+        return NULL;
+    }
+    return argv[++*i];
+}
+
+// parse a numeric option value into a size_t within [min,max]
+static bool option_size(int argc, char **argv, int *i, size_t min, size_t max, size_t *out)
+{
+    const char *name = argv[*i];
+    const char *text = option_value(argc, argv, i);
+    uint64_t val = 0;
+    if (!text)
+        return false;
+    if (!parse_u64(text, &val) || val < min || val > max)
+    {
+        fprintf(stderr, "Error: invalid value '%s' for option '%s'\n", text, name);
+        return false;
+    }
+    *out = (size_t)val;
+    return true;
+}
+
+// select the mode once; options of different modes cannot be combined
+static bool set_mode(CliOptions *opts, CliMode mode)
 {
+    if (opts->mode != CLI_SOLVE && opts->mode != mode)
+    {
+        fprintf(stderr, "Error: --split, --work-unit, --merge, --dimacs, --sat-model and --query are mutually exclusive\n");
+        return false;
+    }
+    opts->mode = mode;
+    return true;
+}
+
+static StatusCode parse_args(int argc, char **argv, CliOptions *opts)
+{
+    memset(opts, 0, sizeof(*opts));
+    solver_config_init(&opts->config);
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--randomize") == 0)
+        {
+            opts->config.randomize = true;
+        }
+        else if (strcmp(arg, "--seed") == 0)
+        {
+            const char *text = option_value(argc, argv, &i);
+            if (!text || !parse_u64(text, &opts->config.seed))
+            {
+                if (text)
+                    fprintf(stderr, "Error: invalid value '%s' for option '--seed'\n", text);
+                return STATUS_ERR_INVALID_ARGUMENT;
+            }
+            opts->seed_given = true;
+            opts->config.randomize = true;
+        }
+        else if (strcmp(arg, "--restarts") == 0)
+        {
+            if (!option_size(argc, argv, &i, 1, SIZE_MAX, &opts->config.restart_base))
+                return STATUS_ERR_INVALID_ARGUMENT;
+            opts->config.randomize = true;
+        }
+        else if (strcmp(arg, "--threads") == 0)
+        {
+            if (!option_size(argc, argv, &i, 1, SOLVER_MAX_THREADS, &opts->config.threads))
+                return STATUS_ERR_INVALID_ARGUMENT;
+        }
+        else if (strcmp(arg, "--deterministic") == 0)
+        {
+            opts->config.deterministic = true;
+        }
+        else if (strcmp(arg, "--checkpoint") == 0)
+        {
+            opts->config.checkpoint_path = option_value(argc, argv, &i);
+            if (!opts->config.checkpoint_path)
+                return STATUS_ERR_INVALID_ARGUMENT;
+        }
+        else if (strcmp(arg, "--checkpoint-interval") == 0)
+        {
+            size_t secs = 0;
+            if (!option_size(argc, argv, &i, 0, UINT_MAX, &secs))
+                return STATUS_ERR_INVALID_ARGUMENT;
+            opts->config.checkpoint_interval = (unsigned)secs;
+        }
+        else if (strcmp(arg, "--resume") == 0)
+        {
+            opts->config.resume_path = option_value(argc, argv, &i);
+            if (!opts->config.resume_path)
+                return STATUS_ERR_INVALID_ARGUMENT;
+        }
+        else if (strcmp(arg, "--engine") == 0)
+        {
+            const char *text = option_value(argc, argv, &i);
+            if (!text)
+                return STATUS_ERR_INVALID_ARGUMENT;
+            if (strcmp(text, "auto") == 0)
+                opts->config.engine = SOLVER_ENGINE_AUTO;
+            else if (strcmp(text, "generic") == 0)
+                opts->config.engine = SOLVER_ENGINE_GENERIC;
+            else if (strcmp(text, "sat") == 0)
+                opts->config.engine = SOLVER_ENGINE_SAT;
+            else
+            {
+                fprintf(stderr, "Error: invalid value '%s' for option '--engine'\n", text);
+                return STATUS_ERR_INVALID_ARGUMENT;
+            }
+        }
+        else if (strcmp(arg, "--order") == 0)
+        {
+            const char *text = option_value(argc, argv, &i);
+            if (!text)
+                return STATUS_ERR_INVALID_ARGUMENT;
+            opts->config.order = search_order_from_name(text);
+            if (opts->config.order == SEARCH_ORDER_NUM)
+            {
+                fprintf(stderr, "Error: invalid value '%s' for option '--order'\n", text);
+                return STATUS_ERR_INVALID_ARGUMENT;
+            }
+        }
+        else if (strcmp(arg, "--scan") == 0)
+        {
+            const char *text = option_value(argc, argv, &i);
+            if (!text)
+                return STATUS_ERR_INVALID_ARGUMENT;
+            if (strcmp(text, "auto") == 0)
+                opts->config.scan = SOLVER_SCAN_AUTO;
+            else if (strcmp(text, "row") == 0)
+                opts->config.scan = SOLVER_SCAN_ROW;
+            else if (strcmp(text, "column") == 0)
+                opts->config.scan = SOLVER_SCAN_COLUMN;
+            else
+            {
+                fprintf(stderr, "Error: invalid value '%s' for option '--scan'\n", text);
+                return STATUS_ERR_INVALID_ARGUMENT;
+            }
+        }
+        else if (strcmp(arg, "--progress") == 0)
+        {
+            size_t secs = 0;
+            if (!option_size(argc, argv, &i, 1, UINT_MAX, &secs))
+                return STATUS_ERR_INVALID_ARGUMENT;
+            opts->progress_interval = (unsigned)secs;
+        }
+        else if (strcmp(arg, "--metrics") == 0)
+        {
+            opts->metrics_path = option_value(argc, argv, &i);
+            if (!opts->metrics_path)
+                return STATUS_ERR_INVALID_ARGUMENT;
+        }
+        else if (strcmp(arg, "--count") == 0)
+        {
+            opts->count = true;
+        }
+        else if (strcmp(arg, "--all") == 0)
+        {
+            opts->all = true;
+        }
+        else if (strcmp(arg, "--limit") == 0)
+        {
+            const char *text = option_value(argc, argv, &i);
+            if (!text || !parse_u64(text, &opts->limit) || opts->limit == 0)
+            {
+                if (text)
+                    fprintf(stderr, "Error: invalid value '%s' for option '--limit'\n", text);
+                return STATUS_ERR_INVALID_ARGUMENT;
+            }
+            opts->all = true;
+        }
+        else if (strcmp(arg, "--perf") == 0)
+        {
+            opts->perf = true;
+        }
+        else if (strcmp(arg, "--split") == 0)
+        {
+            if (!option_size(argc, argv, &i, 1, INT32_MAX, &opts->split_depth))
+                return STATUS_ERR_INVALID_ARGUMENT;
+            if (!set_mode(opts, CLI_SPLIT))
+                return STATUS_ERR_INVALID_ARGUMENT;
+        }
+        else if (strcmp(arg, "--stream") == 0)
+        {
+            if (!option_size(argc, argv, &i, 1, INT32_MAX, &opts->stream_rows))
+                return STATUS_ERR_INVALID_ARGUMENT;
+            if (!set_mode(opts, CLI_STREAM))
+                return STATUS_ERR_INVALID_ARGUMENT;
+        }
+        else if (strcmp(arg, "--previous") == 0)
+        {
+            opts->previous_path = option_value(argc, argv, &i);
+            if (!opts->previous_path)
+                return STATUS_ERR_INVALID_ARGUMENT;
+        }
+        else if (strcmp(arg, "--split-dir") == 0)
+        {
+            opts->split_dir = option_value(argc, argv, &i);
+            if (!opts->split_dir)
+                return STATUS_ERR_INVALID_ARGUMENT;
+        }
+        else if (strcmp(arg, "--work-unit") == 0)
+        {
+            opts->unit_path = option_value(argc, argv, &i);
+            if (!opts->unit_path || !set_mode(opts, CLI_WORK_UNIT))
+                return STATUS_ERR_INVALID_ARGUMENT;
+        }
+        else if (strcmp(arg, "--result") == 0)
+        {
+            opts->result_path = option_value(argc, argv, &i);
+            if (!opts->result_path)
+                return STATUS_ERR_INVALID_ARGUMENT;
+        }
+        else if (strcmp(arg, "--dimacs") == 0 || strcmp(arg, "--sat-model") == 0 || strcmp(arg, "--query") == 0)
+        {
+            CliMode mode = arg[2] == 'd' ? CLI_DIMACS : (arg[2] == 's' ? CLI_SAT_MODEL : CLI_QUERY);
+            opts->cnf_path = option_value(argc, argv, &i);
+            if (!opts->cnf_path || !set_mode(opts, mode))
+                return STATUS_ERR_INVALID_ARGUMENT;
+        }
+        else if (strcmp(arg, "--merge") == 0)
+        {
+            // every remaining argument is a result file
+            if (!set_mode(opts, CLI_MERGE))
+                return STATUS_ERR_INVALID_ARGUMENT;
+            opts->merge_paths = (const char *const *)(argv + i + 1);
+            opts->merge_num = (size_t)(argc - i - 1);
+            if (opts->merge_num == 0)
+            {
+                fprintf(stderr, "Error: --merge needs at least one result file\n");
+                return STATUS_ERR_INVALID_ARGUMENT;
+            }
+            break;
+        }
+        else if (arg[0] == '-' && arg[1] != '\0')
+        {
+            fprintf(stderr, "Error: unknown option '%s'\n", arg);
+            return STATUS_ERR_INVALID_ARGUMENT;
+        }
+        else if (opts->input_path)
+        {
+            fprintf(stderr, "Error: more than one input file given\n");
+            return STATUS_ERR_INVALID_ARGUMENT;
+        }
+        else
+        {
+            opts->input_path = arg;
+        }
+    }
+
+    if (opts->config.threads > 1 && (opts->config.checkpoint_path || opts->config.resume_path))
+    {
+        fprintf(stderr, "Error: --checkpoint/--resume need a single-threaded search\n");
+        return STATUS_ERR_INVALID_ARGUMENT;
+    }
+    if (opts->config.deterministic && opts->config.randomize)
+    {
+        fprintf(stderr, "Error: --deterministic cannot be combined with --randomize, --seed or --restarts\n");
+        return STATUS_ERR_INVALID_ARGUMENT;
+    }
+    if (opts->count && opts->config.threads > 1)
+    {
+        fprintf(stderr, "Error: --count needs a single-threaded search\n");
+        return STATUS_ERR_INVALID_ARGUMENT;
+    }
+    if (opts->config.engine == SOLVER_ENGINE_SAT &&
+        (opts->count || opts->config.threads > 1 || opts->config.randomize || opts->config.checkpoint_path ||
+         opts->config.resume_path || opts->config.order != SEARCH_ORDER_TYPE || opts->mode != CLI_SOLVE))
+    {
+        fprintf(stderr, "Error: --engine sat solves a single instance: no --count, --threads, "
+                        "--randomize, --order, --checkpoint, --resume or other modes\n");
+        return STATUS_ERR_INVALID_ARGUMENT;
+    }
+    // counting, enumeration, checkpoints and work units always scan row-major; streams have their own scan
+    if (opts->config.scan != SOLVER_SCAN_AUTO &&
+        (opts->count || opts->all || opts->config.checkpoint_path || opts->config.resume_path ||
+         (opts->mode != CLI_SOLVE && opts->mode != CLI_QUERY)))
+    {
+        fprintf(stderr, "Error: --scan applies to solve and query runs only, without --checkpoint or --resume\n");
+        return STATUS_ERR_INVALID_ARGUMENT;
+    }
+    // split units and resumed runs search in the order saved with them
+    if (opts->config.order != SEARCH_ORDER_TYPE && (opts->mode != CLI_SOLVE || opts->config.resume_path))
+    {
+        fprintf(stderr, "Error: --order applies to fresh solve and count runs only\n");
+        return STATUS_ERR_INVALID_ARGUMENT;
+    }
+    if ((opts->mode == CLI_DIMACS || opts->mode == CLI_SAT_MODEL || opts->mode == CLI_QUERY) && opts->count)
+    {
+        fprintf(stderr, "Error: --dimacs, --sat-model and --query cannot be combined with --count\n");
+        return STATUS_ERR_INVALID_ARGUMENT;
+    }
+    if (opts->mode == CLI_STREAM &&
+        (opts->count || opts->config.threads > 1 || opts->config.randomize || opts->config.checkpoint_path ||
+         opts->config.resume_path || opts->result_path || opts->config.engine == SOLVER_ENGINE_SAT))
+    {
+        fprintf(stderr, "Error: --stream runs its own band search: no --count, --threads, --randomize, "
+                        "--checkpoint, --resume, --result or --engine sat\n");
+        return STATUS_ERR_INVALID_ARGUMENT;
+    }
+    if (opts->mode == CLI_QUERY &&
+        (opts->config.threads > 1 || opts->config.randomize || opts->config.checkpoint_path ||
+         opts->config.resume_path || opts->result_path))
+    {
+        fprintf(stderr, "Error: --query runs one plain search: no --threads, --randomize, --checkpoint, "
+                        "--resume or --result\n");
+        return STATUS_ERR_INVALID_ARGUMENT;
+    }
+    if (opts->all && (opts->mode != CLI_SOLVE || opts->count || opts->config.threads > 1 ||
+                      opts->config.checkpoint_path || opts->config.resume_path || opts->result_path ||
+                      opts->previous_path || opts->config.engine == SOLVER_ENGINE_SAT))
+    {
+        fprintf(stderr, "Error: --all/--limit enumerate with one plain search: no --count, --threads, "
+                        "--checkpoint, --resume, --result, --previous, --engine sat or other modes\n");
+        return STATUS_ERR_INVALID_ARGUMENT;
+    }
+    if (opts->previous_path &&
+        (opts->mode != CLI_SOLVE || opts->count || opts->config.checkpoint_path || opts->config.resume_path))
+    {
+        fprintf(stderr, "Error: --previous repairs a single solve: no --count, --checkpoint, --resume or other "
+                        "modes\n");
+        return STATUS_ERR_INVALID_ARGUMENT;
+    }
+    if (opts->mode == CLI_WORK_UNIT)
+    {
+        if (opts->config.resume_path || opts->config.threads > 1 || opts->input_path)
+        {
+            fprintf(stderr, "Error: --work-unit takes no input file and no --resume/--threads\n");
+            return STATUS_ERR_INVALID_ARGUMENT;
+        }
+        opts->config.resume_path = opts->unit_path; // a unit is resumed like a checkpoint
+    }
+    if ((opts->mode == CLI_SPLIT || opts->mode == CLI_MERGE || opts->mode == CLI_DIMACS) && opts->result_path)
+    {
+        fprintf(stderr, "Error: --result applies to solve and count runs only\n");
+        return STATUS_ERR_INVALID_ARGUMENT;
+    }
+    if (opts->metrics_path &&
+        (opts->mode == CLI_SPLIT || opts->mode == CLI_MERGE || opts->mode == CLI_DIMACS || opts->mode == CLI_SAT_MODEL))
+    {
+        fprintf(stderr, "Error: --metrics records solve, count, query and stream runs only\n");
+        return STATUS_ERR_INVALID_ARGUMENT;
+    }
+    if (!opts->split_dir)
+        opts->split_dir = ".";
+
+    // randomized searches need a seed; pick one and report it so the run can be reproduced
+    if ((opts->config.randomize || opts->config.threads > 1) && !opts->seed_given)
+        opts->config.seed = (uint64_t)time(NULL);
+    return STATUS_OK;
+}
+
+// read the instance (and its obstacle grid, if any) from the input file (or stdin), or from the header of a
+// work unit
+static StatusCode load_instance(const CliOptions *opts, int *w, int *h, TetrominoBag *bag, bool **blocked)
+{
+    if (opts->mode == CLI_WORK_UNIT)
+    {
+        StatusCode res = checkpoint_peek(opts->unit_path, w, h, bag, blocked);
+        if (res != STATUS_OK)
+            fprintf(stderr, "Error: cannot read work unit '%s'\n", opts->unit_path);
+        return res;
+    }
+
     // open input
     FILE *input;
-    if (argc > 1)
+    const char *input_name = opts->input_path ? opts->input_path : "stdin";
+    if (opts->input_path)
     {
-        input = fopen(argv[1], "r");
+        input = fopen(opts->input_path, "r");
         if (!input)
         {
-            fprintf(stderr, "Error: cannot open '%s': %s\n", argv[1], strerror(errno));
-            parser_print_usage(stderr);
+            fprintf(stderr, "Error: cannot open '%s': %s\n", opts->input_path, strerror(errno));
             return STATUS_ERR_INPUT;
         }
     }
@@ -36,45 +495,21 @@ int main(int argc, char **argv)
     }
 
     // parse
-    int w, h;
-    TetrominoBag bag;
-    StatusCode res = parse_from_stream(input, &w, &h, &bag);
-    if (argc > 1 && input && input != stdin)
+    StatusCode res = parse_from_stream(input, w, h, bag, blocked);
+    if (input && input != stdin)
         fclose(input);
     if (res != STATUS_OK)
-    {
-        fprintf(stderr, "Error: failed parsing '%s'\n", argc > 1 ? argv[1] : "stdin");
-        parser_print_usage(stderr);
-        return res;
-    }
-
-    // prepare for solving
-    Board *board = board_create(w, h);
-    if (!board)
-    {
-        fprintf(stderr, "Error: failed creating board\n");
-        return STATUS_ERR_MEMORY;
-    }
-    size_t inout_count = bag.total;
-    size_t alloc_count = inout_count > 0 ? inout_count : 1;
-    Placement *list = (Placement *)malloc(alloc_count * PLACEMENT_SIZE);
-    if (!list)
-    {
-        fprintf(stderr, "Error: failed allocating placements\n");
-        board_destroy(board);
-        return STATUS_ERR_MEMORY;
-    }
-    memset(list, 0, alloc_count * PLACEMENT_SIZE);
+        fprintf(stderr, "Error: failed parsing '%s'\n", input_name);
+    return res;
+}
 
-    // solve
-    res = solver_solve(board, &bag, list, &inout_count);
+// report a failed solve/count/split on stderr
+static void report_error(StatusCode res, const CliOptions *opts)
+{
     switch (res)
     {
     case STATUS_OK:
-        board_print(board, stdout);
-        break;
     case STATUS_ERR_UNSOLVABLE:
-        fprintf(stdout, "No solution\n");
         break;
     case STATUS_ERR_INVALID_ARGUMENT:
         fprintf(stderr, "Error: invalid argument while solving\n");
@@ -83,15 +518,553 @@ int main(int argc, char **argv)
         fprintf(stderr, "Error: memory error while solving\n");
         break;
     case STATUS_ERR_INPUT:
-        fprintf(stderr, "Error: input error while solving\n");
+        if (opts->config.resume_path)
+            fprintf(stderr, "Error: cannot resume from '%s' (missing, corrupt, another instance or, with --count, "
+                            "saved by a solve)\n",
+                    opts->config.resume_path);
+        else if (opts->mode == CLI_SPLIT)
+            fprintf(stderr, "Error: cannot write work units to '%s'\n", opts->split_dir);
+        else if (opts->previous_path)
+            fprintf(stderr, "Error: cannot read previous tiling '%s'\n", opts->previous_path);
+        else
+            fprintf(stderr, "Error: input error while solving\n");
         break;
     default:
         fprintf(stderr, "Error: unknown error while solving\n");
         break;
     }
+}
 
-    // exit
+// seed line and checkpoint warnings shared by solve and count runs
+static void report_stats(const CliOptions *opts, const SolverStats *stats)
+{
+    if (opts->config.randomize || opts->config.threads > 1)
+    {
+        if (stats->randomized)
+            fprintf(stderr, "seed: %" PRIu64 " (worker %zu, restart unit %zu, restarts %" PRIu64 ")\n",
+                    stats->seed, stats->worker, stats->restart_base, stats->restarts);
+        else
+            fprintf(stderr, "seed: none (worker %zu, enum order)\n", stats->worker);
+    }
+    if (stats->checkpoint_failures > 0)
+        fprintf(stderr, "Warning: %" PRIu64 " checkpoint write(s) to '%s' failed\n",
+                stats->checkpoint_failures, opts->config.checkpoint_path);
+}
+
+// write --result if requested
+static StatusCode write_result(const CliOptions *opts, const Board *board, WorkResult result)
+{
+    if (!opts->result_path)
+        return STATUS_OK;
+    result.width = board_width(board);
+    result.height = board_height(board);
+    result.blocked = NULL;
+    size_t cells = board_cell_count(board);
+    if (board_blocked_count(board) > 0)
+    {
+        result.blocked = malloc(cells * sizeof(bool));
+        if (!result.blocked)
+            return STATUS_ERR_MEMORY;
+        for (size_t i = 0; i < cells; ++i)
+            result.blocked[i] = board_is_blocked(board, (int)(i % (size_t)result.width),
+                                                 (int)(i / (size_t)result.width));
+    }
+    StatusCode res = workunit_write_result(opts->result_path, &result);
+    free(result.blocked);
+    if (res != STATUS_OK)
+        fprintf(stderr, "Error: cannot write result '%s'\n", opts->result_path);
+    return res;
+}
+
+// repair the --previous tiling; stats get the full solve's figures (if it ran) and the total node count
+static StatusCode solve_from_previous(const CliOptions *opts, Board *board, const TetrominoBag *bag,
+                                      Placement *list, size_t *inout_count, SolverStats *stats)
+{
+    FILE *fp = fopen(opts->previous_path, "r");
+    PreviousTiling prev;
+    StatusCode res = fp ? resolve_read_tiling(fp, &prev) : STATUS_ERR_INPUT;
+    if (fp)
+        fclose(fp);
+    if (res != STATUS_OK)
+    {
+        memset(stats, 0, sizeof(*stats));
+        return res; // reported by report_error
+    }
+    ResolveStats rs;
+    res = resolve_solve(board, bag, &prev, &opts->config, list, inout_count, &rs);
+    resolve_tiling_free(&prev);
+    *stats = rs.solver;
+    stats->nodes = rs.nodes;
+    if (rs.full_solve)
+        fprintf(stderr, "resolve: %u rounds failed, solved from scratch\n", rs.rounds);
+    else if (res == STATUS_OK)
+        fprintf(stderr, "resolve: kept %zu of %zu pieces, radius %d, %u rounds, %" PRIu64 " nodes\n", rs.kept,
+                rs.previous, rs.radius, rs.rounds, rs.nodes);
+    return res;
+}
+
+static StatusCode run_solve(const CliOptions *opts, Board *board, const TetrominoBag *bag, uint64_t *out_nodes)
+{
+    size_t inout_count = bag->total;
+    size_t alloc_count = inout_count > 0 ? inout_count : 1;
+    Placement *list = (Placement *)malloc(alloc_count * PLACEMENT_SIZE);
+    if (!list)
+    {
+        fprintf(stderr, "Error: failed allocating placements\n");
+        return STATUS_ERR_MEMORY;
+    }
+    memset(list, 0, alloc_count * PLACEMENT_SIZE);
+
+    SolverStats stats;
+    PerfCounters perf;
+    if (opts->perf)
+        perfcount_start(&perf);
+    StatusCode res = opts->previous_path ? solve_from_previous(opts, board, bag, list, &inout_count, &stats)
+                                         : solver_solve_config(board, bag, &opts->config, list, &inout_count, &stats);
+    if (opts->perf)
+    {
+        perfcount_stop(&perf);
+        perfcount_report(&perf, stats.nodes, stderr);
+    }
+    report_stats(opts, &stats);
+    *out_nodes = stats.nodes;
+    if (res == STATUS_OK || res == STATUS_ERR_UNSOLVABLE)
+    {
+        WorkResult result = {res == STATUS_OK ? WORK_SOLVED : WORK_UNSOLVABLE, 0, 0, 0, inout_count, list, NULL};
+        StatusCode write_res = write_result(opts, board, result);
+        if (res == STATUS_OK)
+            board_print(board, stdout);
+        else
+            fprintf(stdout, "No solution\n");
+        if (write_res != STATUS_OK)
+            res = write_res;
+    }
+    else
+    {
+        report_error(res, opts);
+    }
     free(list);
+    return res;
+}
+
+static StatusCode run_count(const CliOptions *opts, Board *board, const TetrominoBag *bag, uint64_t *out_nodes)
+{
+    uint64_t count = 0;
+    SolverStats stats;
+    PerfCounters perf;
+    if (opts->perf)
+        perfcount_start(&perf);
+    StatusCode res = solver_count(board, bag, &opts->config, &count, &stats);
+    if (opts->perf)
+    {
+        perfcount_stop(&perf);
+        perfcount_report(&perf, stats.nodes, stderr);
+    }
+    report_stats(opts, &stats);
+    *out_nodes = stats.nodes;
+    if (res != STATUS_OK)
+    {
+        report_error(res, opts);
+        return res;
+    }
+    WorkResult result = {WORK_COUNTED, 0, 0, count, 0, NULL, NULL};
+    res = write_result(opts, board, result);
+    fprintf(stdout, "Solutions: %" PRIu64 "\n", count);
+    if (res == STATUS_OK && count == 0)
+        res = STATUS_ERR_UNSOLVABLE;
+    return res;
+}
+
+static StatusCode run_all(const CliOptions *opts, Board *board, const TetrominoBag *bag, uint64_t *out_nodes)
+{
+    Placement *list = malloc((bag->total > 0 ? bag->total : 1) * PLACEMENT_SIZE);
+    SolverIter *iter = NULL;
+    StatusCode res = list ? solver_iter_begin(board, bag, &opts->config, &iter) : STATUS_ERR_MEMORY;
+    PerfCounters perf;
+    if (opts->perf)
+        perfcount_start(&perf);
+    uint64_t found = 0;
+    while (res == STATUS_OK && (opts->limit == 0 || found < opts->limit))
+    {
+        size_t count = bag->total;
+        res = solver_iter_next(iter, list, &count);
+        if (res != STATUS_OK)
+            break;
+        // one tiling per block, flushed so a consumer can start on it right away
+        if (found > 0)
+            fputc('\n', stdout);
+        board_print(board, stdout);
+        fflush(stdout);
+        found++;
+    }
+    if (opts->perf)
+    {
+        perfcount_stop(&perf);
+        perfcount_report(&perf, solver_iter_nodes(iter), stderr);
+    }
+    *out_nodes = solver_iter_nodes(iter);
+    SolverStats stats = {0};
+    stats.randomized = opts->config.randomize;
+    stats.seed = opts->config.seed;
+    report_stats(opts, &stats);
+    solver_iter_end(iter);
+    free(list);
+    if (res == STATUS_ERR_UNSOLVABLE)
+        res = STATUS_OK; // enumeration finished
+    if (res != STATUS_OK)
+    {
+        report_error(res, opts);
+        return res;
+    }
+    fprintf(stdout, "%sSolutions: %" PRIu64 "%s\n", found > 0 ? "\n" : "", found,
+            opts->limit > 0 && found == opts->limit ? " (limit reached)" : "");
+    return found > 0 ? STATUS_OK : STATUS_ERR_UNSOLVABLE;
+}
+
+static StatusCode run_split(const CliOptions *opts, Board *board, const TetrominoBag *bag)
+{
+    size_t units = 0;
+    StatusCode res = workunit_split(board, bag, opts->split_depth, opts->split_dir, &units);
+    if (res == STATUS_OK)
+        fprintf(stdout, "Units: %zu\n", units);
+    else
+        report_error(res, opts);
+    return res;
+}
+
+static StatusCode run_dimacs(const CliOptions *opts, const Board *board, const TetrominoBag *bag)
+{
+    TilingCnf cnf;
+    StatusCode res = cnf_encode(board, bag, &cnf);
+    if (res != STATUS_OK)
+    {
+        if (res == STATUS_ERR_INVALID_ARGUMENT)
+            fprintf(stderr, "Error: instance cannot be encoded (area mismatch or too many placements)\n");
+        else
+            report_error(res, opts);
+        return res;
+    }
+
+    FILE *out = fopen(opts->cnf_path, "w");
+    if (!out)
+    {
+        fprintf(stderr, "Error: cannot open '%s': %s\n", opts->cnf_path, strerror(errno));
+        cnf_free(&cnf);
+        return STATUS_ERR_INPUT;
+    }
+    res = cnf_write_dimacs(&cnf, out);
+    if (fclose(out) != 0)
+        res = STATUS_ERR_INPUT;
+    if (res == STATUS_OK)
+        fprintf(stdout, "DIMACS: %d variables, %zu clauses\n", cnf.var_num, cnf.clause_num);
+    else
+        fprintf(stderr, "Error: cannot write '%s'\n", opts->cnf_path);
+    cnf_free(&cnf);
+    return res;
+}
+
+// decode a model produced by an external solver for the DIMACS of this instance
+static StatusCode run_sat_model(const CliOptions *opts, Board *board, const TetrominoBag *bag)
+{
+    TilingCnf cnf;
+    StatusCode res = cnf_encode(board, bag, &cnf);
+    if (res == STATUS_ERR_INVALID_ARGUMENT && board_cell_count(board) - board_filled_count(board) != bag->total * 4)
+    {
+        fprintf(stdout, "No solution\n"); // open area mismatch, as a solve run reports it
+        return STATUS_ERR_UNSOLVABLE;
+    }
+    if (res != STATUS_OK)
+    {
+        report_error(res, opts);
+        return res;
+    }
+
+    FILE *in = fopen(opts->cnf_path, "r");
+    if (!in)
+    {
+        fprintf(stderr, "Error: cannot open '%s': %s\n", opts->cnf_path, strerror(errno));
+        cnf_free(&cnf);
+        return STATUS_ERR_INPUT;
+    }
+    size_t alloc_count = bag->total > 0 ? bag->total : 1;
+    bool *model = malloc(((size_t)cnf.var_num + 1) * sizeof(bool));
+    Placement *list = malloc(alloc_count * PLACEMENT_SIZE);
+    if (!model || !list)
+        res = STATUS_ERR_MEMORY;
+    else
+        res = cnf_read_model(&cnf, in, model);
+    if (res == STATUS_OK)
+        res = cnf_apply_model(&cnf, model, board, list);
+    fclose(in);
+
+    if (res == STATUS_OK || res == STATUS_ERR_UNSOLVABLE)
+    {
+        WorkResult result = {res == STATUS_OK ? WORK_SOLVED : WORK_UNSOLVABLE, 0, 0, 0,
+                             res == STATUS_OK ? bag->total : 0, list, NULL};
+        StatusCode write_res = write_result(opts, board, result);
+        if (res == STATUS_OK)
+            board_print(board, stdout);
+        else
+            fprintf(stdout, "No solution\n");
+        if (write_res != STATUS_OK)
+            res = write_res;
+    }
+    else if (res == STATUS_ERR_INPUT)
+    {
+        fprintf(stderr, "Error: '%s' is not a model of this instance's DIMACS\n", opts->cnf_path);
+    }
+    else
+    {
+        report_error(res, opts);
+    }
+    free(model);
+    free(list);
+    cnf_free(&cnf);
+    return res;
+}
+
+// answer every bag of the query file for the input board
+static StatusCode run_query(const CliOptions *opts, Board *board, uint64_t *out_nodes)
+{
+    FILE *in = fopen(opts->cnf_path, "r");
+    if (!in)
+    {
+        fprintf(stderr, "Error: cannot open '%s': %s\n", opts->cnf_path, strerror(errno));
+        return STATUS_ERR_INPUT;
+    }
+    QuerySet set;
+    memset(&set, 0, sizeof(set));
+    StatusCode res = query_read(in, board_cell_count(board) - board_filled_count(board), &set);
+    fclose(in);
+    if (res != STATUS_OK)
+    {
+        if (res == STATUS_ERR_INPUT)
+            fprintf(stderr, "Error: failed parsing query file '%s' (or more than %u bags)\n", opts->cnf_path,
+                    QUERY_MAX_BAGS);
+        else
+            report_error(res, opts);
+        query_free(&set);
+        return res;
+    }
+
+    uint64_t nodes = 0;
+    PerfCounters perf;
+    if (opts->perf)
+        perfcount_start(&perf);
+    res = query_solve(board, &set, opts->config.scan, &nodes);
+    *out_nodes = nodes;
+    if (opts->perf)
+    {
+        perfcount_stop(&perf);
+        perfcount_report(&perf, nodes, stderr);
+    }
+    if (res != STATUS_OK)
+    {
+        report_error(res, opts);
+        query_free(&set);
+        return res;
+    }
+
+    size_t feasible = 0;
+    char text[128];
+    for (size_t i = 0; i < set.num && res == STATUS_OK; ++i)
+    {
+        const BagQuery *q = set.items + i;
+        query_format_bag(&q->bag, text, sizeof(text));
+        fprintf(stdout, "%s: %s\n", text, q->feasible ? "yes" : "no");
+        if (!q->feasible)
+            continue;
+        feasible++;
+        for (size_t k = 0; k < q->bag.total; ++k)
+        {
+            const Placement *p = q->tiling + k;
+            board_place(board, p->x, p->y, p->type, p->rotation, p->mark);
+        }
+        board_print(board, stdout);
+        for (size_t k = 0; k < q->bag.total; ++k)
+        {
+            const Placement *p = q->tiling + k;
+            board_remove(board, p->x, p->y, p->type, p->rotation);
+        }
+    }
+    fprintf(stdout, "Feasible: %zu of %zu\n", feasible, set.num);
+    fprintf(stderr, "query: %" PRIu64 " nodes for %zu bags\n", nodes, set.num);
+    query_free(&set);
+    return feasible > 0 ? STATUS_OK : STATUS_ERR_UNSOLVABLE;
+}
+
+// print a merged result the way a direct run would have
+static StatusCode run_merge(const CliOptions *opts)
+{
+    WorkResult merged;
+    StatusCode res = workunit_merge(opts->merge_paths, opts->merge_num, &merged);
+    if (res != STATUS_OK)
+    {
+        fprintf(stderr, "Error: cannot merge results (unreadable file, or mixed sizes or modes)\n");
+        return res;
+    }
+
+    if (merged.outcome == WORK_COUNTED)
+    {
+        fprintf(stdout, "Solutions: %" PRIu64 "\n", merged.count);
+        res = merged.count > 0 ? STATUS_OK : STATUS_ERR_UNSOLVABLE;
+    }
+    else if (merged.outcome == WORK_UNSOLVABLE)
+    {
+        fprintf(stdout, "No solution\n");
+        res = STATUS_ERR_UNSOLVABLE;
+    }
+    else
+    {
+        // replay the winning tiling onto a fresh board with the same obstacles
+        Board *board = board_create(merged.width, merged.height);
+        if (!board)
+        {
+            fprintf(stderr, "Error: failed creating board\n");
+            workunit_result_free(&merged);
+            return STATUS_ERR_MEMORY;
+        }
+        for (size_t i = 0; merged.blocked && i < board_cell_count(board); ++i)
+        {
+            if (merged.blocked[i])
+                board_block_cell(board, (int)(i % (size_t)merged.width), (int)(i / (size_t)merged.width));
+        }
+        for (size_t i = 0; i < merged.placement_num && res == STATUS_OK; ++i)
+        {
+            const Placement *p = merged.placements + i;
+            if (!board_place(board, p->x, p->y, p->type, p->rotation, p->mark))
+                res = STATUS_ERR_INPUT;
+        }
+        if (res == STATUS_OK && board_filled_count(board) == board_cell_count(board))
+        {
+            board_print(board, stdout);
+        }
+        else
+        {
+            fprintf(stderr, "Error: merged tiling does not cover the board\n");
+            res = STATUS_ERR_INPUT;
+        }
+        board_destroy(board);
+    }
+    workunit_result_free(&merged);
+    return res;
+}
+
+static StatusCode run_stream(const CliOptions *opts, int w, int h, const TetrominoBag *bag, uint64_t *out_nodes)
+{
+    StreamStats stats;
+    StatusCode res = stream_solve(w, h, bag, opts->stream_rows, stdout, &stats);
+    *out_nodes = stats.nodes;
+    fprintf(stderr, "stream: %zu bands, %" PRIu64 " nodes, %zu of %d rows written\n", stats.bands, stats.nodes,
+            stats.rows_done, h);
+    if (res == STATUS_ERR_UNSOLVABLE)
+    {
+        if (stats.stuck_row >= 0)
+            fprintf(stderr, "stream: stuck at row %d (bands are not revisited; the instance may still be solvable)\n",
+                    stats.stuck_row);
+        fprintf(stdout, "No solution\n");
+    }
+    else if (res != STATUS_OK)
+    {
+        report_error(res, opts);
+    }
+    return res;
+}
+
+// load the instance and run the selected mode; *out_area and *out_nodes describe the run for --metrics
+static StatusCode run_instance(const CliOptions *opts, size_t *out_area, uint64_t *out_nodes)
+{
+    // read the instance
+    int w, h;
+    TetrominoBag bag;
+    bool *blocked = NULL;
+    StatusCode res = load_instance(opts, &w, &h, &bag, &blocked);
+    if (res != STATUS_OK)
+    {
+        parser_print_usage(stderr);
+        return res;
+    }
+    *out_area = (size_t)w * (size_t)h;
+
+    // streaming never holds the whole board
+    if (opts->mode == CLI_STREAM)
+    {
+        if (blocked)
+        {
+            free(blocked);
+            fprintf(stderr, "Error: --stream does not take an obstacle grid\n");
+            return STATUS_ERR_INVALID_ARGUMENT;
+        }
+        return run_stream(opts, w, h, &bag, out_nodes);
+    }
+
+    // prepare for solving
+    Board *board = board_create(w, h);
+    if (!board)
+    {
+        free(blocked);
+        fprintf(stderr, "Error: failed creating board\n");
+        return STATUS_ERR_MEMORY;
+    }
+    for (size_t i = 0; blocked && i < board_cell_count(board); ++i)
+    {
+        if (blocked[i])
+            board_block_cell(board, (int)(i % (size_t)w), (int)(i / (size_t)w));
+    }
+    free(blocked);
+
+    // searches answer SIGUSR1 (and the heartbeat) with a progress line
+    if ((opts->mode == CLI_SOLVE || opts->mode == CLI_WORK_UNIT) &&
+        progress_install(opts->progress_interval) != STATUS_OK)
+        fprintf(stderr, "Warning: progress reporting unavailable\n");
+
+    // solve, count, split or go through CNF
+    if (opts->mode == CLI_SPLIT)
+        res = run_split(opts, board, &bag);
+    else if (opts->mode == CLI_DIMACS)
+        res = run_dimacs(opts, board, &bag);
+    else if (opts->mode == CLI_SAT_MODEL)
+        res = run_sat_model(opts, board, &bag);
+    else if (opts->mode == CLI_QUERY)
+        res = run_query(opts, board, out_nodes);
+    else if (opts->count)
+        res = run_count(opts, board, &bag, out_nodes);
+    else if (opts->all)
+        res = run_all(opts, board, &bag, out_nodes);
+    else
+        res = run_solve(opts, board, &bag, out_nodes);
+
     board_destroy(board);
     return res;
-}
\ No newline at end of file
+}
+
+int main(int argc, char **argv)
+{
+    CliOptions opts;
+    StatusCode res = parse_args(argc, argv, &opts);
+    if (res != STATUS_OK)
+    {
+        parser_print_usage(stderr);
+        return res;
+    }
+    if (opts.mode == CLI_MERGE)
+        return run_merge(&opts);
+
+    // batch metrics: one observation per run, merged into the shared file at exit
+    uint64_t start_ns = metrics_clock_ns();
+    size_t area = 0;
+    uint64_t nodes = 0;
+    res = run_instance(&opts, &area, &nodes);
+    if (opts.metrics_path)
+    {
+        MetricsOutcome outcome = res == STATUS_OK              ? METRICS_SOLVED
+                                 : res == STATUS_ERR_UNSOLVABLE ? METRICS_UNSOLVABLE
+                                                                : METRICS_ERROR;
+        metrics_record(area, outcome, metrics_clock_ns() - start_ns, nodes);
+        if (metrics_write(opts.metrics_path) != STATUS_OK)
+            fprintf(stderr, "Warning: cannot write metrics to '%s'\n", opts.metrics_path);
+    }
+
+    // exit
+    return res;
+}
@@ -0,0 +1,360 @@
+#define _XOPEN_SOURCE 700 // clock_gettime, mkstemp, fchmod, fcntl record locks
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "metrics.h"
+
+/* Metrics implementation:
+ *   - Buckets are stored per bucket and printed cumulatively, as Prometheus histograms expect; the file is
+ *     read back by matching each series' labels and le bound against the strings this file prints.
+ *   - The lock file serializes the processes that share a file. */
+
+#define AREA_BUCKETS 8 // <= 64, 256, 1024, 4096, 16384, 65536, +Inf, unknown
+#define AREA_FINITE 6  // buckets with an upper bound
+#define AREA_UNKNOWN (AREA_BUCKETS - 1)
+#define LATENCY_BUCKETS 34 // le 2^0 .. 2^32 microseconds, then +Inf
+#define NODE_BUCKETS 26    // le 4^0 .. 4^24 nodes, then +Inf
+#define METRICS_LINE_MAX 512
+#define METRICS_BOUND_MAX 32
+
+typedef enum MetricsKind
+{
+    METRICS_LATENCY = 0,
+    METRICS_NODES,
+    METRICS_KIND_NUM
+} MetricsKind;
+
+static const char *const AREA_LABELS[AREA_BUCKETS] = {"64", "256", "1024", "4096", "16384", "65536", "+Inf",
+                                                      "unknown"};
+static const char *const OUTCOME_LABELS[METRICS_OUTCOME_NUM] = {"solved", "unsolvable", "error"};
+static const char *const KIND_NAMES[METRICS_KIND_NUM] = {"tetromino_run_seconds", "tetromino_run_nodes"};
+static const char *const KIND_HELP[METRICS_KIND_NUM] = {
+    "Wall-clock time of one solver run, by board area (cells) and outcome.",
+    "Search nodes (placements tried) of one solver run, by board area (cells) and outcome."};
+static const size_t KIND_BUCKETS[METRICS_KIND_NUM] = {LATENCY_BUCKETS, NODE_BUCKETS};
+
+// plain totals: what a write merges, reads back and remembers (rows sized for the larger kind)
+typedef struct MetricsTotals
+{
+    uint64_t buckets[METRICS_KIND_NUM][AREA_BUCKETS][METRICS_OUTCOME_NUM][LATENCY_BUCKETS];
+    uint64_t sums[METRICS_KIND_NUM][AREA_BUCKETS][METRICS_OUTCOME_NUM]; // nanoseconds / nodes
+} MetricsTotals;
+
+static MetricsTotals recorded; // observations not merged into a file yet
+
+uint64_t metrics_clock_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * UINT64_C(1000000000) + (uint64_t)ts.tv_nsec;
+}
+
+static size_t area_bucket(size_t area)
+{
+    if (area == 0)
+        return AREA_UNKNOWN;
+    size_t bound = 64;
+    for (size_t i = 0; i < AREA_FINITE; ++i, bound *= 4)
+    {
+        if (area <= bound)
+            return i;
+    }
+    return AREA_FINITE;
+}
+
+// smallest k with value <= 2^k (0 for value <= 1)
+static inline size_t ceil_log2(uint64_t value)
+{
+    return value <= 1 ? 0 : (size_t)(64 - __builtin_clzll(value - 1));
+}
+
+static size_t latency_bucket(uint64_t ns)
+{
+    size_t k = ceil_log2(ns / 1000 + (ns % 1000 != 0));
+    return k < LATENCY_BUCKETS - 1 ? k : LATENCY_BUCKETS - 1;
+}
+
+static size_t node_bucket(uint64_t nodes)
+{
+    size_t k = (ceil_log2(nodes) + 1) / 2;
+    return k < NODE_BUCKETS - 1 ? k : NODE_BUCKETS - 1;
+}
+
+// le label of bucket i of kind (the last one is +Inf)
+static void bucket_bound(MetricsKind kind, size_t i, char *out)
+{
+    if (i + 1 == KIND_BUCKETS[kind])
+        snprintf(out, METRICS_BOUND_MAX, "+Inf");
+    else if (kind == METRICS_LATENCY)
+        snprintf(out, METRICS_BOUND_MAX, "%.6f", (double)(UINT64_C(1) << i) / 1e6);
+    else
+        snprintf(out, METRICS_BOUND_MAX, "%" PRIu64, UINT64_C(1) << (2 * i));
+}
+
+void metrics_record(size_t area, MetricsOutcome outcome, uint64_t latency_ns, uint64_t nodes)
+{
+    if ((unsigned)outcome >= METRICS_OUTCOME_NUM)
+        return;
+    size_t a = area_bucket(area);
+    recorded.buckets[METRICS_LATENCY][a][outcome][latency_bucket(latency_ns)]++;
+    recorded.sums[METRICS_LATENCY][a][outcome] += latency_ns;
+    recorded.buckets[METRICS_NODES][a][outcome][node_bucket(nodes)]++;
+    recorded.sums[METRICS_NODES][a][outcome] += nodes;
+}
+
+// index of label among n names, or n
+static size_t label_index(const char *value, const char *const *names, size_t n)
+{
+    size_t i = 0;
+    while (i < n && strcmp(value, names[i]) != 0)
+        i++;
+    return i;
+}
+
+// copy the value of label name="..." in labels to out; false if missing or too long
+static bool label_value(const char *labels, const char *name, char *out)
+{
+    char key[METRICS_BOUND_MAX];
+    snprintf(key, sizeof(key), "%s=\"", name);
+    const char *start = strstr(labels, key);
+    if (!start)
+        return false;
+    start += strlen(key);
+    const char *end = strchr(start, '"');
+    if (!end || (size_t)(end - start) >= METRICS_BOUND_MAX)
+        return false;
+    memcpy(out, start, (size_t)(end - start));
+    out[end - start] = '\0';
+    return true;
+}
+
+// one sample line into totals (buckets still cumulative); comments and other metrics are skipped
+static bool parse_sample(const char *line, MetricsTotals *totals)
+{
+    const char *brace = strchr(line, '{');
+    const char *close = brace ? strchr(brace, '}') : NULL;
+    if (line[0] == '#' || !brace || !close)
+        return true;
+    size_t kind = METRICS_KIND_NUM;
+    const char *suffix = NULL;
+    for (size_t k = 0; k < METRICS_KIND_NUM; ++k)
+    {
+        size_t len = strlen(KIND_NAMES[k]);
+        if (strncmp(line, KIND_NAMES[k], len) == 0 && line[len] == '_')
+        {
+            kind = k;
+            suffix = line + len + 1;
+        }
+    }
+    if (kind == METRICS_KIND_NUM)
+        return true;
+
+    char area[METRICS_BOUND_MAX], outcome[METRICS_BOUND_MAX], le[METRICS_BOUND_MAX];
+    if (!label_value(brace, "area", area) || !label_value(brace, "outcome", outcome))
+        return false;
+    size_t a = label_index(area, AREA_LABELS, AREA_BUCKETS);
+    size_t o = label_index(outcome, OUTCOME_LABELS, METRICS_OUTCOME_NUM);
+    if (a == AREA_BUCKETS || o == METRICS_OUTCOME_NUM)
+        return false;
+    char *end = NULL;
+    errno = 0;
+    double value = strtod(close + 1, &end);
+    if (errno != 0 || end == close + 1 || value < 0.0)
+        return false;
+
+    if (strncmp(suffix, "bucket{", 7) == 0)
+    {
+        if (!label_value(brace, "le", le))
+            return false;
+        char bound[METRICS_BOUND_MAX];
+        size_t i = 0;
+        for (; i < KIND_BUCKETS[kind]; ++i)
+        {
+            bucket_bound((MetricsKind)kind, i, bound);
+            if (strcmp(bound, le) == 0)
+                break;
+        }
+        if (i == KIND_BUCKETS[kind])
+            return false;
+        totals->buckets[kind][a][o][i] = (uint64_t)value;
+    }
+    else if (strncmp(suffix, "sum{", 4) == 0)
+    {
+        totals->sums[kind][a][o] = kind == METRICS_LATENCY ? (uint64_t)(value * 1e9 + 0.5) : (uint64_t)value;
+    }
+    return true; // _count is derived from the buckets
+}
+
+// read the totals a previous write left in path (none if it does not exist yet)
+static StatusCode read_totals(const char *path, MetricsTotals *out)
+{
+    memset(out, 0, sizeof(*out));
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+        return errno == ENOENT ? STATUS_OK : STATUS_ERR_INPUT;
+    char line[METRICS_LINE_MAX];
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), fp))
+        ok = parse_sample(line, out);
+    fclose(fp);
+    if (!ok)
+        return STATUS_ERR_INPUT;
+
+    // cumulative buckets back to per-bucket counts
+    for (size_t k = 0; k < METRICS_KIND_NUM; ++k)
+    {
+        for (size_t a = 0; a < AREA_BUCKETS; ++a)
+        {
+            for (size_t o = 0; o < METRICS_OUTCOME_NUM; ++o)
+            {
+                uint64_t *b = out->buckets[k][a][o];
+                for (size_t i = KIND_BUCKETS[k]; i-- > 1;)
+                    b[i] = b[i] >= b[i - 1] ? b[i] - b[i - 1] : 0;
+            }
+        }
+    }
+    return STATUS_OK;
+}
+
+static void print_totals(FILE *fp, const MetricsTotals *totals)
+{
+    char bound[METRICS_BOUND_MAX];
+    for (size_t k = 0; k < METRICS_KIND_NUM; ++k)
+    {
+        fprintf(fp, "# HELP %s %s\n# TYPE %s histogram\n", KIND_NAMES[k], KIND_HELP[k], KIND_NAMES[k]);
+        for (size_t a = 0; a < AREA_BUCKETS; ++a)
+        {
+            for (size_t o = 0; o < METRICS_OUTCOME_NUM; ++o)
+            {
+                const uint64_t *b = totals->buckets[k][a][o];
+                uint64_t count = 0;
+                for (size_t i = 0; i < KIND_BUCKETS[k]; ++i)
+                    count += b[i];
+                if (count == 0)
+                    continue; // series that never saw a run stay out of the file
+                const char *labels_fmt = "area=\"%s\",outcome=\"%s\"";
+                uint64_t cumulative = 0;
+                for (size_t i = 0; i < KIND_BUCKETS[k]; ++i)
+                {
+                    cumulative += b[i];
+                    bucket_bound((MetricsKind)k, i, bound);
+                    fprintf(fp, "%s_bucket{", KIND_NAMES[k]);
+                    fprintf(fp, labels_fmt, AREA_LABELS[a], OUTCOME_LABELS[o]);
+                    fprintf(fp, ",le=\"%s\"} %" PRIu64 "\n", bound, cumulative);
+                }
+                fprintf(fp, "%s_sum{", KIND_NAMES[k]);
+                fprintf(fp, labels_fmt, AREA_LABELS[a], OUTCOME_LABELS[o]);
+                if (k == METRICS_LATENCY)
+                    fprintf(fp, "} %.9f\n", (double)totals->sums[k][a][o] / 1e9);
+                else
+                    fprintf(fp, "} %" PRIu64 "\n", totals->sums[k][a][o]);
+                fprintf(fp, "%s_count{", KIND_NAMES[k]);
+                fprintf(fp, labels_fmt, AREA_LABELS[a], OUTCOME_LABELS[o]);
+                fprintf(fp, "} %" PRIu64 "\n", count);
+            }
+        }
+    }
+}
+
+// write totals to a temporary file next to path and rename it over path
+static StatusCode replace_file(const char *path, const MetricsTotals *totals)
+{
+    size_t len = strlen(path);
+    char *tmp = malloc(len + sizeof(".XXXXXX"));
+    if (!tmp)
+        return STATUS_ERR_MEMORY;
+    memcpy(tmp, path, len);
+    memcpy(tmp + len, ".XXXXXX", sizeof(".XXXXXX"));
+    int fd = mkstemp(tmp);
+    FILE *fp = fd >= 0 ? fdopen(fd, "w") : NULL;
+    if (!fp)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+            unlink(tmp);
+        }
+        free(tmp);
+        return STATUS_ERR_INPUT;
+    }
+    fchmod(fd, 0644); // readable by the exporter, like any other output file
+    print_totals(fp, totals);
+    bool ok = !ferror(fp);
+    ok = fclose(fp) == 0 && ok;
+    ok = ok && rename(tmp, path) == 0;
+    if (!ok)
+        unlink(tmp);
+    free(tmp);
+    return ok ? STATUS_OK : STATUS_ERR_INPUT;
+}
+
+// exclusive lock on path.lock, held until the returned descriptor is closed; -1 on failure
+static int lock_file(const char *path)
+{
+    size_t len = strlen(path);
+    char *lock_path = malloc(len + sizeof(".lock"));
+    if (!lock_path)
+        return -1;
+    memcpy(lock_path, path, len);
+    memcpy(lock_path + len, ".lock", sizeof(".lock"));
+    int fd = open(lock_path, O_RDWR | O_CREAT, 0644);
+    free(lock_path);
+    if (fd < 0)
+        return -1;
+    struct flock lock;
+    memset(&lock, 0, sizeof(lock));
+    lock.l_type = F_WRLCK;
+    lock.l_whence = SEEK_SET;
+    int res;
+    while ((res = fcntl(fd, F_SETLKW, &lock)) == -1 && errno == EINTR)
+        ;
+    if (res == -1)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+StatusCode metrics_write(const char *path)
+{
+    if (!path)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    MetricsTotals *file = malloc(sizeof(MetricsTotals));
+    if (!file)
+        return STATUS_ERR_MEMORY;
+
+    StatusCode res = STATUS_ERR_INPUT;
+    int lock_fd = lock_file(path);
+    if (lock_fd >= 0)
+    {
+        res = read_totals(path, file);
+        if (res == STATUS_OK)
+        {
+            for (size_t k = 0; k < METRICS_KIND_NUM; ++k)
+            {
+                for (size_t a = 0; a < AREA_BUCKETS; ++a)
+                {
+                    for (size_t o = 0; o < METRICS_OUTCOME_NUM; ++o)
+                    {
+                        for (size_t i = 0; i < KIND_BUCKETS[k]; ++i)
+                            file->buckets[k][a][o][i] += recorded.buckets[k][a][o][i];
+                        file->sums[k][a][o] += recorded.sums[k][a][o];
+                    }
+                }
+            }
+            res = replace_file(path, file);
+        }
+        close(lock_fd);
+    }
+    if (res == STATUS_OK)
+        memset(&recorded, 0, sizeof(recorded)); // merged: a later write must not add them again
+    free(file);
+    return res;
+}
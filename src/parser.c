@@ -1,17 +1,107 @@
+#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include "parser.h"
 #include "tetromino.h"
 
 /* Input parsing implementation:
- *   - Read width/height.
+ *   - Read width/height, then an optional obstacle grid.
  *   - Parse shape tokens with optional multiplicity.
  *   - Handle comments and whitespace.
  *   - Populate TetrominoBag with basic consistency checks. */
 
 #define LINE_MAX_LENGTH 4096
 
-StatusCode parse_from_stream(FILE *in, int *out_w, int *out_h, TetrominoBag *out_bag)
+static inline bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+static inline bool is_grid_char(char c)
+{
+    return c == '.' || c == 'x' || c == 'X';
+}
+
+// piece tokens of one line (comment already stripped) into bag
+static StatusCode parse_tokens(const char *p, TetrominoBag *bag)
+{
+    while (*p)
+    {
+        // skip spaces between tokens
+        while (is_space(*p))
+            ++p;
+        if (*p == '\0')
+            break;
+
+        // token must begin with a letter (shape)
+        unsigned char ch = (unsigned char)*p;
+        if (!isalpha(ch))
+            return STATUS_ERR_INPUT;
+
+        // map letter to type (case-insensitive)
+        char tok[2];
+        tok[0] = (char)toupper(ch);
+        tok[1] = '\0';
+        TetrominoType t = tetro_type_from_token(tok);
+        if (t == TETRO_TYPE_COUNT)
+            return STATUS_ERR_INPUT;
+        ++p;
+
+        // optional "*<count>" with count as positive integer, no spaces inside
+        size_t count = 1;
+        if (*p == '*')
+        {
+            ++p;
+            // parse unsigned decimal > 0, manual to avoid extra headers
+            size_t val = 0;
+            if (!isdigit((unsigned char)*p))
+                return STATUS_ERR_INPUT;
+            while (isdigit((unsigned char)*p))
+            {
+                size_t digit = (size_t)(*p - '0');
+                // overflow check: val = val*10 + digit
+                if (val > (SIZE_MAX - digit) / 10)
+                    return STATUS_ERR_INPUT;
+                val = val * 10 + digit;
+                ++p;
+            }
+            if (val == 0)
+                return STATUS_ERR_INPUT;
+            count = val;
+        }
+
+        // accumulate into bag with overflow checks
+        if (bag->counts[t] > SIZE_MAX - count)
+            return STATUS_ERR_INPUT;
+        bag->counts[t] += count;
+        if (bag->total > SIZE_MAX - count)
+            return STATUS_ERR_INPUT;
+        bag->total += count;
+
+        // loop continues to next token (whitespace or end-of-line)
+    }
+    return STATUS_OK;
+}
+
+// one obstacle grid row (leading spaces skipped, comment stripped) into blocked[row * width ..]
+static StatusCode parse_grid_row(const char *p, int width, bool *blocked)
+{
+    size_t len = 0;
+    while (is_grid_char(p[len]))
+        len++;
+    for (const char *q = p + len; *q; ++q)
+    {
+        if (!is_space(*q))
+            return STATUS_ERR_INPUT;
+    }
+    if (len != (size_t)width)
+        return STATUS_ERR_INPUT;
+    for (size_t i = 0; i < len; ++i)
+        blocked[i] = p[i] != '.';
+    return STATUS_OK;
+}
+
+StatusCode parse_from_stream(FILE *in, int *out_w, int *out_h, TetrominoBag *out_bag, bool **out_blocked)
 {
     if (!in || !out_w || !out_h || !out_bag)
         return STATUS_ERR_INVALID_ARGUMENT;
@@ -22,13 +112,22 @@ StatusCode parse_from_stream(FILE *in, int *out_w, int *out_h, TetrominoBag *out
     out_bag->total = 0;
     *out_w = 0;
     *out_h = 0;
+    if (out_blocked)
+        *out_blocked = NULL;
 
     char line[LINE_MAX_LENGTH];
     int width = 0, height = 0;
     bool got_sizes = false;
+    bool got_tokens = false;
+    bool *blocked = NULL; // obstacle grid, once one starts
+    int grid_rows = 0;
+    StatusCode res = STATUS_OK;
 
-    while (fgets(line, (int)sizeof line, in))
+    while (res == STATUS_OK && fgets(line, (int)sizeof line, in))
     {
+        // a grid row must fit the line buffer; tokens may be split anywhere but inside one token
+        bool whole_line = strchr(line, '\n') || feof(in);
+
         // strip inline comment starting with '#'
         char *hash = strchr(line, '#');
         if (hash)
@@ -36,7 +135,7 @@ StatusCode parse_from_stream(FILE *in, int *out_w, int *out_h, TetrominoBag *out
 
         // skip leading spaces
         char *p = line;
-        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n' || *p == '\v' || *p == '\f')
+        while (is_space(*p))
             ++p;
         if (*p == '\0')
             continue; // blank line
@@ -51,10 +150,8 @@ StatusCode parse_from_stream(FILE *in, int *out_w, int *out_h, TetrominoBag *out
             // ensure nothing but whitespace after the two integers
             for (char *q = p + nconsumed; *q; ++q)
             {
-                if (!(*q == ' ' || *q == '\t' || *q == '\r' || *q == '\n' || *q == '\v' || *q == '\f'))
-                {
+                if (!is_space(*q))
                     return STATUS_ERR_INPUT;
-                }
             }
             if (w <= 0 || h <= 0)
                 return STATUS_ERR_INPUT;
@@ -64,69 +161,46 @@ StatusCode parse_from_stream(FILE *in, int *out_w, int *out_h, TetrominoBag *out
             continue;
         }
 
-        // after sizes: parse piece tokens until EOF. Tokens are whitespace-separated.
-        while (*p)
+        // an obstacle grid may directly follow the sizes: exactly height rows of width cells
+        if (!got_tokens && (blocked || is_grid_char(*p)) && grid_rows < height)
         {
-            // skip spaces between tokens
-            while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n' || *p == '\v' || *p == '\f')
-                ++p;
-            if (*p == '\0')
+            if (!out_blocked || !whole_line)
+            {
+                res = STATUS_ERR_INPUT;
                 break;
-
-            // token must begin with a letter (shape)
-            unsigned char ch = (unsigned char)*p;
-            if (!isalpha(ch))
-                return STATUS_ERR_INPUT;
-
-            // map letter to type (case-insensitive)
-            char tok[2];
-            tok[0] = (char)toupper(ch);
-            tok[1] = '\0';
-            TetrominoType t = tetro_type_from_token(tok);
-            if (t == TETRO_TYPE_COUNT)
-                return STATUS_ERR_INPUT;
-            ++p;
-
-            // optional "*<count>" with count as positive integer, no spaces inside
-            size_t count = 1;
-            if (*p == '*')
+            }
+            if (!blocked)
             {
-                ++p;
-                // parse unsigned decimal > 0, manual to avoid extra headers
-                size_t val = 0;
-                if (!isdigit((unsigned char)*p))
-                    return STATUS_ERR_INPUT;
-                while (isdigit((unsigned char)*p))
+                size_t cells = (size_t)width * (size_t)height;
+                blocked = calloc(cells, sizeof(bool));
+                if (!blocked)
                 {
-                    size_t digit = (size_t)(*p - '0');
-                    // overflow check: val = val*10 + digit
-                    if (val > (SIZE_MAX - digit) / 10)
-                        return STATUS_ERR_INPUT;
-                    val = val * 10 + digit;
-                    ++p;
+                    res = STATUS_ERR_MEMORY;
+                    break;
                 }
-                if (val == 0)
-                    return STATUS_ERR_INPUT;
-                count = val;
             }
-
-            // accumulate into bag with overflow checks
-            if (out_bag->counts[t] > SIZE_MAX - count)
-                return STATUS_ERR_INPUT;
-            out_bag->counts[t] += count;
-            if (out_bag->total > SIZE_MAX - count)
-                return STATUS_ERR_INPUT;
-            out_bag->total += count;
-
-            // loop continues to next token (whitespace or end-of-line)
+            res = parse_grid_row(p, width, blocked + (size_t)grid_rows * (size_t)width);
+            grid_rows++;
+            continue;
         }
+
+        // after sizes (and grid): parse piece tokens until EOF. Tokens are whitespace-separated.
+        got_tokens = true;
+        res = parse_tokens(p, out_bag);
     }
 
-    if (!got_sizes)
-        return STATUS_ERR_INPUT;
+    if (res == STATUS_OK && (!got_sizes || (blocked && grid_rows < height)))
+        res = STATUS_ERR_INPUT;
+    if (res != STATUS_OK)
+    {
+        free(blocked);
+        return res;
+    }
 
     *out_w = width;
     *out_h = height;
+    if (out_blocked)
+        *out_blocked = blocked;
 
     return STATUS_OK;
 }
@@ -137,10 +211,44 @@ void parser_print_usage(FILE *out)
         out = stderr;
 
     fprintf(out,
-            "Usage: %s [INPUT_FILE]\n"
+            "Usage: %s [OPTIONS] [INPUT_FILE]\n"
+            "\n"
+            "Options:\n"
+            "  --randomize      shuffle candidate order (seed reported on stderr)\n"
+            "  --seed N         seed for --randomize (implies --randomize)\n"
+            "  --restarts N     Luby restart unit in search nodes (implies --randomize)\n"
+            "  --threads N      portfolio of N differently seeded searches; first result wins\n"
+            "  --deterministic  with --threads: split the tree into ordered subtrees and return\n"
+            "                   exactly the tiling a single-threaded solve finds\n"
+            "  --checkpoint FILE            periodically save the search state to FILE\n"
+            "  --checkpoint-interval SECS   seconds between checkpoints (default 60)\n"
+            "  --resume FILE                continue a search from a checkpoint of the same input\n"
+            "  --engine auto|generic|sat    search backend (default auto: bitboard kernel when it applies;\n"
+            "                               sat: CNF/CDCL solve over all placements, may tile differently)\n"
+            "  --order type|scarce|fits     piece-type order at each cell (default type; scarce: fewest copies\n"
+            "                               left first; fits: fewest fitting orientations first)\n"
+            "  --scan auto|row|column       cell scan order (default auto: column-major on boards wider than\n"
+            "                               tall; solve and query runs)\n"
+            "  --progress SECS              print a progress line every SECS seconds (also on SIGUSR1)\n"
+            "  --perf                       report hardware counters (cycles, IPC, cache/branch misses) per node\n"
+            "  --metrics FILE               merge run latency/node histograms into FILE (Prometheus text)\n"
+            "  --count                      count all tilings instead of printing one\n"
+            "  --all                        print every tiling in search order (blank line between)\n"
+            "  --limit N                    print at most N tilings (implies --all)\n"
+            "  --stream ROWS                tile tall boards band by band, printing ROWS rows at a time\n"
+            "  --previous FILE              re-solve by repairing an earlier tiling (solver output) near the edit\n"
+            "  --split DEPTH                write one work unit per subtree at DEPTH placements\n"
+            "  --split-dir DIR              directory for --split units (default .)\n"
+            "  --work-unit FILE             solve (or --count) one work unit instead of INPUT_FILE\n"
+            "  --result FILE                also write the outcome as a result file for --merge\n"
+            "  --merge FILES...             combine result files (given in unit order)\n"
+            "  --dimacs FILE                write the instance as DIMACS CNF to FILE\n"
+            "  --sat-model FILE             print the tiling from an external SAT solver's output\n"
+            "  --query FILE                 report which bags in FILE (one per line, T*0..2 ranges) tile the board\n"
             "\n"
             "Input format:\n"
             "  First line: two positive integers <width> <height>\n"
+            "  Optional obstacle grid: <height> rows of <width> cells, '.' open, 'x' blocked\n"
             "  Following lines: tetromino list (case-insensitive), tokens separated by whitespace\n"
             "    - Single letters: I O T S Z J L   (each means one piece)\n"
             "    - Or counted form: I*3  t*2       ('*' followed by a positive integer)\n"
@@ -0,0 +1,158 @@
+#define _GNU_SOURCE // syscall
+#include <string.h>
+#include <inttypes.h>
+#include "perfcount.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+/* Perf counter implementation:
+ *   - One independent counter per event (no group), so the kernel can schedule whichever it supports.
+ *   - Counters start disabled and are enabled together right before the solve. */
+
+static const char *const EVENT_NAMES[PERF_EVENT_NUM] = {"cycles", "instructions", "L1D misses", "LLC misses",
+                                                        "branch misses"};
+
+#ifdef __linux__
+// (type, config) of each event
+static void event_config(PerfEvent event, uint32_t *type, uint64_t *config)
+{
+    *type = PERF_TYPE_HARDWARE;
+    switch (event)
+    {
+    case PERF_EVENT_CYCLES:
+        *config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case PERF_EVENT_INSTRUCTIONS:
+        *config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case PERF_EVENT_L1D_MISSES:
+        *type = PERF_TYPE_HW_CACHE;
+        *config = PERF_COUNT_HW_CACHE_L1D | ((uint64_t)PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  ((uint64_t)PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    case PERF_EVENT_LLC_MISSES:
+        *config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    case PERF_EVENT_BRANCH_MISSES:
+        *config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    case PERF_EVENT_NUM:
+    default:
+        *config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    }
+}
+
+static int open_event(PerfEvent event)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    uint32_t type = 0;
+    uint64_t config = 0;
+    event_config(event, &type, &config);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = 1; // count the portfolio threads too
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0UL);
+    return fd >= 0 ? (int)fd : -1;
+}
+#endif
+
+void perfcount_start(PerfCounters *pc)
+{
+    if (!pc)
+        return;
+    memset(pc, 0, sizeof(*pc));
+    for (size_t i = 0; i < PERF_EVENT_NUM; ++i)
+    {
+#ifdef __linux__
+        pc->fds[i] = open_event((PerfEvent)i);
+#else
+        pc->fds[i] = -1;
+#endif
+    }
+#ifdef __linux__
+    for (size_t i = 0; i < PERF_EVENT_NUM; ++i)
+    {
+        if (pc->fds[i] >= 0)
+            ioctl(pc->fds[i], PERF_EVENT_IOC_RESET, 0);
+    }
+    for (size_t i = 0; i < PERF_EVENT_NUM; ++i)
+    {
+        if (pc->fds[i] >= 0)
+            ioctl(pc->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+void perfcount_stop(PerfCounters *pc)
+{
+    if (!pc)
+        return;
+#ifdef __linux__
+    for (size_t i = 0; i < PERF_EVENT_NUM; ++i)
+    {
+        if (pc->fds[i] >= 0)
+            ioctl(pc->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for (size_t i = 0; i < PERF_EVENT_NUM; ++i)
+    {
+        if (pc->fds[i] < 0)
+            continue;
+        // value, time enabled, time running
+        uint64_t buf[3] = {0, 0, 0};
+        if (read(pc->fds[i], buf, sizeof(buf)) == (ssize_t)sizeof(buf) && buf[2] > 0)
+        {
+            pc->values[i] = buf[0];
+            if (buf[2] < buf[1])
+            {
+                pc->values[i] = (uint64_t)((double)buf[0] * (double)buf[1] / (double)buf[2]);
+                pc->scaled = true;
+            }
+            pc->valid[i] = true;
+        }
+        close(pc->fds[i]);
+        pc->fds[i] = -1;
+    }
+#endif
+}
+
+void perfcount_report(const PerfCounters *pc, uint64_t nodes, FILE *out)
+{
+    if (!pc || !out)
+        return;
+    bool any = false;
+    if (nodes > 0)
+        fprintf(out, "perf: %-13s %15" PRIu64 "\n", "search nodes", nodes);
+    for (size_t i = 0; i < PERF_EVENT_NUM; ++i)
+    {
+        if (!pc->valid[i])
+            continue;
+        any = true;
+        if (nodes > 0)
+            fprintf(out, "perf: %-13s %15" PRIu64 "  %12.2f/node\n", EVENT_NAMES[i], pc->values[i],
+                    (double)pc->values[i] / (double)nodes);
+        else
+            fprintf(out, "perf: %-13s %15" PRIu64 "\n", EVENT_NAMES[i], pc->values[i]);
+    }
+    if (!any)
+    {
+        fprintf(out, "perf: hardware counters unavailable\n");
+        return;
+    }
+    if (pc->valid[PERF_EVENT_CYCLES] && pc->valid[PERF_EVENT_INSTRUCTIONS] && pc->values[PERF_EVENT_CYCLES] > 0)
+        fprintf(out, "perf: %-13s %15.2f\n", "IPC",
+                (double)pc->values[PERF_EVENT_INSTRUCTIONS] / (double)pc->values[PERF_EVENT_CYCLES]);
+    if (pc->scaled)
+        fprintf(out, "perf: counters were multiplexed; values are scaled estimates\n");
+}
@@ -0,0 +1,88 @@
+#define _XOPEN_SOURCE 700 // sigaction, setitimer, clock_gettime
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <time.h>
+#include "progress.h"
+
+/* Progress implementation:
+ *   - Signal handlers store 1 into a sig_atomic_t and nothing else.
+ *   - Reports are serialized by a mutex, which also guards the previous report's time and node count. */
+
+static volatile sig_atomic_t progress_requested = 0;
+static bool progress_installed = false;
+
+static pthread_mutex_t report_lock = PTHREAD_MUTEX_INITIALIZER;
+static double last_time = 0.0;
+static uint64_t last_nodes = 0;
+
+// monotonic seconds
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    progress_requested = 1;
+}
+
+StatusCode progress_install(unsigned interval_secs)
+{
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(SIGUSR1, &sa, NULL) != 0)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    if (interval_secs > 0)
+    {
+        struct itimerval timer;
+        memset(&timer, 0, sizeof(timer));
+        timer.it_interval.tv_sec = (time_t)interval_secs;
+        timer.it_value.tv_sec = (time_t)interval_secs;
+        if (sigaction(SIGALRM, &sa, NULL) != 0 || setitimer(ITIMER_REAL, &timer, NULL) != 0)
+            return STATUS_ERR_INVALID_ARGUMENT;
+    }
+
+    pthread_mutex_lock(&report_lock);
+    last_time = now_seconds();
+    last_nodes = 0;
+    pthread_mutex_unlock(&report_lock);
+    progress_installed = true;
+    return STATUS_OK;
+}
+
+const volatile sig_atomic_t *progress_flag(void)
+{
+    return progress_installed ? &progress_requested : NULL;
+}
+
+void progress_report(const ProgressSnapshot *snap)
+{
+    progress_requested = 0;
+    if (!snap)
+        return;
+
+    pthread_mutex_lock(&report_lock);
+    double now = now_seconds();
+    double elapsed = now - last_time;
+    // another search (restart, portfolio worker) may have fewer nodes than the last report
+    uint64_t delta = snap->nodes >= last_nodes ? snap->nodes - last_nodes : snap->nodes;
+    double rate = elapsed > 0.0 ? (double)delta / elapsed : 0.0;
+    last_time = now;
+    last_nodes = snap->nodes;
+
+    fprintf(stderr,
+            "progress: depth %zu/%zu, filled %zu/%zu cells, %" PRIu64 " nodes, %.0f nodes/s, explored ~%.4f%% (%s)\n",
+            snap->depth, snap->piece_num, snap->filled_cells, snap->total_cells, snap->nodes, rate,
+            snap->explored * 100.0, snap->kernel ? snap->kernel : "?");
+    fflush(stderr);
+    pthread_mutex_unlock(&report_lock);
+}
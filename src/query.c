@@ -0,0 +1,548 @@
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "query.h"
+#include "search.h"
+#include "endgame.h"
+#include "construct.h"
+#include "tetromino.h"
+
+/* Query implementation:
+ *   - Query lines are parsed into per-type [lo, hi] ranges and expanded with a sum constraint, so only
+ *     combinations that fill the board are ever enumerated.
+ *   - The shared search is the general engine with an envelope bag and a prune hook; the pending list
+ *     keeps the bag that admitted the last placement in front, since neighbouring nodes share prefixes.
+ *   - A wide board is searched transposed: the bags are reflected in place for the search and back after. */
+
+#define LINE_MAX_LENGTH 4096
+#define MARK_NUM 26 // 26 letters from A-Z
+#define QUERY_ENDGAME_LOG2 14
+
+// counts allowed per type on one query line
+typedef struct BagRange
+{
+    size_t lo[TETRO_TYPE_COUNT];
+    size_t hi[TETRO_TYPE_COUNT];
+    bool ranged; // at least one token gave a range
+} BagRange;
+
+// state of one expansion
+typedef struct RangeExpansion
+{
+    const BagRange *range;
+    size_t suffix_lo[TETRO_TYPE_COUNT + 1]; // sum of lo[t..]
+    size_t suffix_hi[TETRO_TYPE_COUNT + 1]; // sum of hi[t..] (hi capped to the board)
+    TetrominoBag bag;
+    QuerySet *set;
+} RangeExpansion;
+
+// pending bags of a running query
+typedef struct QueryState
+{
+    QuerySet *set;
+    size_t envelope[TETRO_TYPE_COUNT];
+    size_t *pending; // indices of unanswered bags
+    size_t pending_num;
+    EndgameTable *endgame; // probed with each bag's own remaining counts; NULL disables lookups
+    Placement *prefix;     // scratch for the placements on the search stack
+    StatusCode error;      // failure inside the prune hook
+} QueryState;
+
+StatusCode query_add(QuerySet *set, const TetrominoBag *bag)
+{
+    if (!set || !bag)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    if (set->num == set->cap)
+    {
+        size_t cap = set->cap ? set->cap * 2 : 16;
+        BagQuery *grown = realloc(set->items, cap * sizeof(BagQuery));
+        if (!grown)
+            return STATUS_ERR_MEMORY;
+        set->items = grown;
+        set->cap = cap;
+    }
+    BagQuery *q = set->items + set->num++;
+    q->bag = *bag;
+    q->feasible = false;
+    q->tiling = NULL;
+    return STATUS_OK;
+}
+
+void query_free(QuerySet *set)
+{
+    if (!set)
+        return;
+    for (size_t i = 0; i < set->num; ++i)
+        free(set->items[i].tiling);
+    free(set->items);
+    memset(set, 0, sizeof(*set));
+}
+
+// parse a decimal count; false on overflow or no digits
+static bool parse_count(const char **p, size_t *out)
+{
+    const char *q = *p;
+    size_t val = 0;
+    if (!isdigit((unsigned char)*q))
+        return false;
+    while (isdigit((unsigned char)*q))
+    {
+        size_t digit = (size_t)(*q - '0');
+        if (val > (SIZE_MAX - digit) / 10)
+            return false;
+        val = val * 10 + digit;
+        ++q;
+    }
+    *p = q;
+    *out = val;
+    return true;
+}
+
+// parse one non-blank line: tokens "X", "X*n" or "X*lo..hi"
+static StatusCode parse_range_line(const char *p, BagRange *out)
+{
+    memset(out, 0, sizeof(*out));
+    while (*p)
+    {
+        while (isspace((unsigned char)*p))
+            ++p;
+        if (*p == '\0')
+            break;
+
+        char tok[2] = {(char)toupper((unsigned char)*p), '\0'};
+        TetrominoType t = tetro_type_from_token(tok);
+        if (t == TETRO_TYPE_COUNT)
+            return STATUS_ERR_INPUT;
+        ++p;
+
+        size_t lo = 1;
+        size_t hi = 1;
+        if (*p == '*')
+        {
+            ++p;
+            if (!parse_count(&p, &lo))
+                return STATUS_ERR_INPUT;
+            hi = lo;
+            if (p[0] == '.' && p[1] == '.')
+            {
+                p += 2;
+                if (!parse_count(&p, &hi) || hi < lo)
+                    return STATUS_ERR_INPUT;
+                out->ranged = true;
+            }
+            else if (lo == 0)
+            {
+                return STATUS_ERR_INPUT; // like the input file, a plain count is positive
+            }
+        }
+        if (*p != '\0' && !isspace((unsigned char)*p))
+            return STATUS_ERR_INPUT;
+        if (out->lo[t] > SIZE_MAX - lo || out->hi[t] > SIZE_MAX - hi)
+            return STATUS_ERR_INPUT;
+        out->lo[t] += lo;
+        out->hi[t] += hi;
+    }
+    return STATUS_OK;
+}
+
+// choose counts for types t.. so that they add up to left pieces
+static StatusCode expand_from(RangeExpansion *ex, size_t t, size_t left)
+{
+    if (t == TETRO_TYPE_COUNT)
+    {
+        if (ex->set->num >= QUERY_MAX_BAGS)
+            return STATUS_ERR_INPUT;
+        return query_add(ex->set, &ex->bag);
+    }
+    for (size_t v = ex->range->lo[t]; v <= ex->range->hi[t] && v <= left; ++v)
+    {
+        size_t rest = left - v;
+        if (rest < ex->suffix_lo[t + 1])
+            break;
+        if (rest > ex->suffix_hi[t + 1])
+            continue;
+        ex->bag.counts[t] = v;
+        StatusCode res = expand_from(ex, t + 1, rest);
+        if (res != STATUS_OK)
+            return res;
+    }
+    return STATUS_OK;
+}
+
+StatusCode query_read(FILE *in, size_t cell_num, QuerySet *set)
+{
+    if (!in || !set)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    char line[LINE_MAX_LENGTH];
+    while (fgets(line, (int)sizeof line, in))
+    {
+        char *hash = strchr(line, '#');
+        if (hash)
+            *hash = '\0';
+        const char *p = line;
+        while (isspace((unsigned char)*p))
+            ++p;
+        if (*p == '\0')
+            continue;
+
+        BagRange range;
+        StatusCode res = parse_range_line(p, &range);
+        if (res != STATUS_OK)
+            return res;
+
+        if (!range.ranged)
+        {
+            // a plain bag is reported whatever its area
+            TetrominoBag bag;
+            bag.total = 0;
+            for (size_t t = 0; t < TETRO_TYPE_COUNT; ++t)
+            {
+                bag.counts[t] = range.lo[t];
+                if (bag.total > SIZE_MAX - bag.counts[t])
+                    return STATUS_ERR_INPUT;
+                bag.total += bag.counts[t];
+            }
+            if (set->num >= QUERY_MAX_BAGS)
+                return STATUS_ERR_INPUT;
+            res = query_add(set, &bag);
+            if (res != STATUS_OK)
+                return res;
+            continue;
+        }
+
+        // a range keeps only the combinations that fill the board
+        if (cell_num % 4 != 0)
+            continue;
+        size_t pieces = cell_num / 4;
+        RangeExpansion ex;
+        memset(&ex, 0, sizeof(ex));
+        ex.range = &range;
+        ex.set = set;
+        ex.bag.total = pieces;
+        for (size_t t = TETRO_TYPE_COUNT; t > 0; --t)
+        {
+            size_t hi = range.hi[t - 1] < pieces ? range.hi[t - 1] : pieces;
+            size_t lo = range.lo[t - 1] <= pieces ? range.lo[t - 1] : pieces + 1; // pieces + 1: never fits
+            ex.suffix_lo[t - 1] = ex.suffix_lo[t] + lo;
+            ex.suffix_hi[t - 1] = ex.suffix_hi[t] + hi;
+            if (ex.suffix_lo[t - 1] > pieces)
+                ex.suffix_lo[t - 1] = pieces + 1; // saturate: the line cannot fill the board
+            if (ex.suffix_hi[t - 1] > pieces)
+                ex.suffix_hi[t - 1] = pieces;
+        }
+        if (ex.suffix_lo[0] > pieces || ex.suffix_hi[0] < pieces)
+            continue;
+        res = expand_from(&ex, 0, pieces);
+        if (res != STATUS_OK)
+            return res;
+    }
+    return ferror(in) ? STATUS_ERR_INPUT : STATUS_OK;
+}
+
+// record a tiling (prefix of the search stack + tail) for a bag and drop it from the pending list
+static StatusCode answer_at(QueryState *st, size_t k, const Placement *prefix, size_t prefix_num,
+                            const Placement *tail, size_t tail_num)
+{
+    BagQuery *q = st->set->items + st->pending[k];
+    size_t total = prefix_num + tail_num;
+    if (total > 0)
+    {
+        q->tiling = malloc(total * PLACEMENT_SIZE);
+        if (!q->tiling)
+            return STATUS_ERR_MEMORY;
+        if (prefix_num > 0)
+            memcpy(q->tiling, prefix, prefix_num * PLACEMENT_SIZE);
+        for (size_t i = 0; i < tail_num; ++i)
+        {
+            q->tiling[prefix_num + i] = tail[i];
+            q->tiling[prefix_num + i].mark = (char)('A' + ((prefix_num + i) % MARK_NUM));
+        }
+    }
+    q->feasible = true;
+    st->pending[k] = st->pending[--st->pending_num];
+    return STATUS_OK;
+}
+
+// true if bag holds every piece used so far
+static inline bool bag_admits(const QueryState *st, const TetrominoBag *bag, const size_t *counts)
+{
+    for (size_t t = 0; t < TETRO_TYPE_COUNT; ++t)
+    {
+        if (st->envelope[t] - counts[t] > bag->counts[t])
+            return false;
+    }
+    return true;
+}
+
+// the endgame step each bag's own search would take here: probe the residual region with that bag's
+// remaining counts. Returns false if the region is not representable (the search goes on as usual).
+static bool probe_endgame(QueryState *st, const SearchContext *ctx)
+{
+    size_t remaining = ctx->target_cells - ctx->filled_cells;
+    Cell pos = search_next_empty(ctx->board);
+    size_t prefix_num = search_placements(ctx, st->prefix);
+    size_t k = 0;
+    while (k < st->pending_num)
+    {
+        const TetrominoBag *bag = &st->set->items[st->pending[k]].bag;
+        if (!bag_admits(st, bag, ctx->counts))
+        {
+            k++;
+            continue;
+        }
+        size_t left[TETRO_TYPE_COUNT];
+        for (size_t t = 0; t < TETRO_TYPE_COUNT; ++t)
+            left[t] = bag->counts[t] - (st->envelope[t] - ctx->counts[t]);
+        Placement tail[ENDGAME_MAX_PIECES];
+        size_t tail_num = 0;
+        EndgameResult res = endgame_probe(st->endgame, ctx->board, pos, left, remaining, tail, &tail_num);
+        if (res == ENDGAME_SKIP)
+            return false; // depends on the region only, so it holds for every bag
+        if (res == ENDGAME_TILEABLE)
+        {
+            StatusCode status = answer_at(st, k, st->prefix, prefix_num, tail, tail_num);
+            if (status != STATUS_OK)
+            {
+                st->error = status;
+                return true;
+            }
+            continue; // pending[k] now holds another bag
+        }
+        k++; // dead for this bag: its own search backtracks here
+    }
+    return true;
+}
+
+// prune hook: keep a placement only while some pending bag holds every piece used so far; small
+// residual regions are settled by the endgame table, bag by bag
+static bool prune_unwanted(const SearchContext *ctx, void *arg)
+{
+    QueryState *st = arg;
+    if (st->error != STATUS_OK)
+        return true;
+    size_t k = 0;
+    while (k < st->pending_num && !bag_admits(st, &st->set->items[st->pending[k]].bag, ctx->counts))
+        k++;
+    if (k == st->pending_num)
+        return true;
+    if (k > 0)
+    {
+        // neighbouring nodes share prefixes: try this bag first next time
+        size_t tmp = st->pending[0];
+        st->pending[0] = st->pending[k];
+        st->pending[k] = tmp;
+    }
+
+    size_t remaining = ctx->target_cells - ctx->filled_cells;
+    if (st->endgame && remaining > 0 && remaining <= ENDGAME_MAX_CELLS)
+        return probe_endgame(st, ctx);
+    return false;
+}
+
+// a complete tiling answers every pending bag with exactly its piece counts
+static StatusCode answer_bags(QueryState *st, const SearchContext *ctx)
+{
+    size_t prefix_num = search_placements(ctx, st->prefix);
+    size_t k = 0;
+    while (k < st->pending_num)
+    {
+        const TetrominoBag *bag = &st->set->items[st->pending[k]].bag;
+        bool equal = true;
+        for (size_t t = 0; t < TETRO_TYPE_COUNT && equal; ++t)
+            equal = st->envelope[t] - ctx->counts[t] == bag->counts[t];
+        if (!equal)
+        {
+            k++;
+            continue;
+        }
+        StatusCode res = answer_at(st, k, st->prefix, prefix_num, NULL, 0);
+        if (res != STATUS_OK)
+            return res;
+    }
+    return STATUS_OK;
+}
+
+// bags the constructive fast path tiles without searching (board must be empty)
+static StatusCode answer_constructed(QueryState *st, Board *board)
+{
+    size_t k = 0;
+    while (k < st->pending_num)
+    {
+        BagQuery *q = st->set->items + st->pending[k];
+        size_t total = q->bag.total > 0 ? q->bag.total : 1;
+        Placement *tiling = malloc(total * PLACEMENT_SIZE);
+        if (!tiling)
+            return STATUS_ERR_MEMORY;
+        if (!construct_tiling(board, &q->bag, tiling, total))
+        {
+            free(tiling);
+            k++;
+            continue;
+        }
+        board_clear(board);
+        q->tiling = tiling;
+        q->feasible = true;
+        st->pending[k] = st->pending[--st->pending_num];
+    }
+    return STATUS_OK;
+}
+
+// the counts of the reflected shapes (S <-> Z, J <-> L); applying it twice restores bag
+static void reflect_bag(TetrominoBag *bag)
+{
+    size_t counts[TETRO_TYPE_COUNT];
+    for (TetrominoType t = 0; t < TETRO_TYPE_COUNT; ++t)
+        counts[tetro_transposed_type(t)] = bag->counts[t];
+    memcpy(bag->counts, counts, sizeof(counts));
+}
+
+StatusCode query_solve(Board *board, QuerySet *set, SolverScan scan, uint64_t *out_nodes)
+{
+    if (out_nodes)
+        *out_nodes = 0;
+    if (!board || !set)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    size_t empty = board_cell_count(board) - board_filled_count(board);
+
+    // bags whose area does not match are answered without searching
+    QueryState st;
+    memset(&st, 0, sizeof(st));
+    st.set = set;
+    st.error = STATUS_OK;
+    st.pending = malloc((set->num > 0 ? set->num : 1) * sizeof(size_t));
+    if (!st.pending)
+        return STATUS_ERR_MEMORY;
+    for (size_t i = 0; i < set->num; ++i)
+    {
+        BagQuery *q = set->items + i;
+        free(q->tiling);
+        q->tiling = NULL;
+        q->feasible = false;
+        if (q->bag.total > SIZE_MAX / 4 || q->bag.total * 4 != empty)
+            continue;
+        st.pending[st.pending_num++] = i;
+    }
+    // an empty board first goes through the constructive path, as a single solve would
+    if (board_filled_count(board) == 0)
+    {
+        StatusCode res = answer_constructed(&st, board);
+        if (res != STATUS_OK)
+        {
+            free(st.pending);
+            return res;
+        }
+    }
+    if (st.pending_num == 0)
+    {
+        free(st.pending);
+        return STATUS_OK;
+    }
+    // a wide board is searched transposed with reflected bags, as each single solve would be
+    bool transpose = scan == SOLVER_SCAN_COLUMN ||
+                     (scan == SOLVER_SCAN_AUTO && board_width(board) > board_height(board));
+    Board *search_board = board;
+    size_t *searched = NULL;
+    size_t searched_num = st.pending_num;
+    if (transpose)
+    {
+        search_board = board_transpose(board);
+        searched = malloc(searched_num * sizeof(size_t));
+        if (!search_board || !searched)
+        {
+            board_destroy(search_board);
+            free(searched);
+            free(st.pending);
+            return STATUS_ERR_MEMORY;
+        }
+        memcpy(searched, st.pending, searched_num * sizeof(size_t));
+        for (size_t k = 0; k < searched_num; ++k)
+            reflect_bag(&set->items[searched[k]].bag);
+    }
+    for (size_t k = 0; k < st.pending_num; ++k)
+    {
+        const TetrominoBag *bag = &set->items[st.pending[k]].bag;
+        for (size_t t = 0; t < TETRO_TYPE_COUNT; ++t)
+        {
+            if (bag->counts[t] > st.envelope[t])
+                st.envelope[t] = bag->counts[t];
+        }
+    }
+
+    // the engine's own endgame lookups would use the envelope counts, so they stay off; the prune
+    // hook probes a table of ours with each bag's counts instead
+    TetrominoBag envelope;
+    memcpy(envelope.counts, st.envelope, sizeof(envelope.counts));
+    envelope.total = empty / 4;
+    SearchContext ctx;
+    StatusCode res = search_init(&ctx, search_board, &envelope, NULL);
+    st.prefix = malloc((envelope.total > 0 ? envelope.total : 1) * PLACEMENT_SIZE);
+    st.endgame = endgame_create(QUERY_ENDGAME_LOG2); // allocation failure only disables lookups
+    if (res == STATUS_OK && !st.prefix)
+        res = STATUS_ERR_MEMORY;
+    ctx.prune = prune_unwanted;
+    ctx.prune_arg = &st;
+
+    // a small board is settled at the root, like the first frame of each bag's search
+    bool searching = res == STATUS_OK;
+    if (searching && st.endgame && empty > 0 && empty <= ENDGAME_MAX_CELLS)
+        searching = !probe_endgame(&st, &ctx);
+    while (searching && st.error == STATUS_OK && st.pending_num > 0)
+    {
+        SearchOutcome outcome = search_run(&ctx);
+        if (outcome == SEARCH_SOLVED)
+        {
+            res = answer_bags(&st, &ctx);
+            if (res != STATUS_OK || !search_backtrack(&ctx))
+                break;
+            continue;
+        }
+        if (outcome == SEARCH_ERROR)
+            res = ctx.error;
+        break; // exhausted: the remaining bags are infeasible
+    }
+    if (res == STATUS_OK)
+        res = st.error;
+
+    if (out_nodes)
+        *out_nodes = ctx.nodes;
+    search_unwind(&ctx);
+    search_release(&ctx);
+    for (size_t k = 0; transpose && k < searched_num; ++k)
+    {
+        BagQuery *q = set->items + searched[k];
+        reflect_bag(&q->bag);
+        for (size_t i = 0; q->feasible && i < q->bag.total; ++i)
+            tetro_transpose_placement(q->tiling + i);
+    }
+    if (transpose)
+        board_destroy(search_board);
+    free(searched);
+    endgame_destroy(st.endgame);
+    free(st.prefix);
+    free(st.pending);
+    return res;
+}
+
+void query_format_bag(const TetrominoBag *bag, char *buf, size_t size)
+{
+    if (!buf || size == 0)
+        return;
+    buf[0] = '\0';
+    if (!bag)
+        return;
+    size_t len = 0;
+    for (TetrominoType t = 0; t < TETRO_TYPE_COUNT && len < size; ++t)
+    {
+        size_t n = bag->counts[t];
+        if (n == 0)
+            continue;
+        const char *sep = len > 0 ? " " : "";
+        int written = n == 1 ? snprintf(buf + len, size - len, "%s%s", sep, tetro_type_name(t))
+                             : snprintf(buf + len, size - len, "%s%s*%zu", sep, tetro_type_name(t), n);
+        if (written < 0)
+            return;
+        len += (size_t)written;
+    }
+    if (len == 0)
+        snprintf(buf, size, "-");
+}
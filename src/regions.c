@@ -0,0 +1,565 @@
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "regions.h"
+
+/* Region decomposition implementation:
+ *   - Label the 4-connected components of empty cells with a breadth-first pass.
+ *   - Split the bag region by region (backtracking over memoized sub-bag results).
+ *   - Solve a region on a clipped board of its own; merge the pieces in anchor order. */
+
+#define MARK_NUM 26 // 26 letters from A-Z
+
+// one sub-bag tried on a region
+typedef struct RegionTry
+{
+    size_t counts[TETRO_TYPE_COUNT];
+    StatusCode res;
+    Placement *pieces; // board coordinates, set when res == STATUS_OK
+    bool visited;      // reached in split order (batches also solve ahead)
+} RegionTry;
+
+// a 4-connected component of empty cells
+typedef struct Region
+{
+    int label;
+    size_t cells;
+    size_t pieces; // cells / 4
+    int x0, y0, x1, y1; // bounding box, inclusive
+    int imbalance;      // checkerboard colour sum of the cells
+    RegionTry *tries;
+    size_t try_num;
+    size_t try_cap;
+} Region;
+
+// a candidate sub-bag and its rank in the enumeration
+typedef struct SubBag
+{
+    size_t counts[TETRO_TYPE_COUNT];
+    uint64_t distance; // to the proportional share; smaller first
+    size_t ordinal;    // enumeration order, breaks ties
+} SubBag;
+
+typedef struct SubBagList
+{
+    SubBag *items;
+    size_t num;
+    size_t cap;
+} SubBagList;
+
+typedef struct Decomposition
+{
+    const Board *board;
+    const int *labels;
+    const SolverConfig *config;
+    Region *regions; // smallest first
+    size_t num;
+    size_t *chosen; // per region: index of the try in the current split
+    size_t solves; // tries visited in split order
+    uint64_t nodes;
+    bool gave_up;
+    StatusCode error; // first error other than unsolvable
+    // endgame table per job slot of a batch: slot 0 borrows config->endgame, the others are created on first use
+    EndgameTable *endgames[SOLVER_MAX_THREADS];
+} Decomposition;
+
+// one region solve run on a thread of a batch
+typedef struct RegionJob
+{
+    const Decomposition *d;
+    const Region *region;
+    RegionTry *result;
+    EndgameTable *endgame;
+    uint64_t nodes;
+    pthread_t thread;
+    bool started;
+} RegionJob;
+
+// checkerboard colour of a cell: +1 or -1
+static inline int cell_colour(int x, int y)
+{
+    return ((x + y) & 1) ? -1 : 1;
+}
+
+// stop splitting: an error or a limit ends the decomposition
+static inline bool stopped(const Decomposition *d)
+{
+    return d->gave_up || d->error != STATUS_OK;
+}
+
+/* Only a T covers the two colours unequally (3:1, a contribution of +-2), so a region needs at least
+ * |imbalance|/2 of them, and a number of the same parity. */
+static inline bool t_balance_ok(const Region *r, size_t t_count)
+{
+    size_t need = (size_t)abs(r->imbalance) / 2;
+    return t_count >= need && (t_count - need) % 2 == 0;
+}
+
+// label the empty components and collect their statistics; STATUS_ERR_MEMORY on allocation failure
+static StatusCode label_regions(const Board *board, int *labels, Region **out_regions, size_t *out_num)
+{
+    int w = board_width(board);
+    int h = board_height(board);
+    size_t area = board_cell_count(board);
+    size_t *queue = malloc(area * sizeof(size_t));
+    if (!queue)
+        return STATUS_ERR_MEMORY;
+    for (size_t i = 0; i < area; ++i)
+        labels[i] = -1;
+
+    Region *regions = NULL;
+    size_t num = 0;
+    size_t cap = 0;
+    StatusCode res = STATUS_OK;
+    for (size_t start = 0; start < area && res == STATUS_OK; ++start)
+    {
+        if (labels[start] >= 0 || !board_is_empty(board, (int)(start % (size_t)w), (int)(start / (size_t)w)))
+            continue;
+        if (num == cap)
+        {
+            size_t next = cap ? cap * 2 : 4;
+            Region *grown = realloc(regions, next * sizeof(Region));
+            if (!grown)
+            {
+                res = STATUS_ERR_MEMORY;
+                break;
+            }
+            regions = grown;
+            cap = next;
+        }
+        Region *r = regions + num;
+        memset(r, 0, sizeof(Region));
+        r->label = (int)num++;
+        r->x0 = w;
+        r->y0 = h;
+        r->x1 = -1;
+        r->y1 = -1;
+
+        size_t head = 0;
+        size_t tail = 0;
+        labels[start] = r->label;
+        queue[tail++] = start;
+        while (head < tail)
+        {
+            size_t cell = queue[head++];
+            int x = (int)(cell % (size_t)w);
+            int y = (int)(cell / (size_t)w);
+            r->cells++;
+            r->imbalance += cell_colour(x, y);
+            r->x0 = x < r->x0 ? x : r->x0;
+            r->y0 = y < r->y0 ? y : r->y0;
+            r->x1 = x > r->x1 ? x : r->x1;
+            r->y1 = y > r->y1 ? y : r->y1;
+            static const int DX[4] = {1, -1, 0, 0};
+            static const int DY[4] = {0, 0, 1, -1};
+            for (int k = 0; k < 4; ++k)
+            {
+                int nx = x + DX[k];
+                int ny = y + DY[k];
+                if (!board_is_empty(board, nx, ny))
+                    continue; // out of bounds reads as not empty
+                size_t next = (size_t)ny * (size_t)w + (size_t)nx;
+                if (labels[next] >= 0)
+                    continue;
+                labels[next] = r->label;
+                queue[tail++] = next;
+            }
+        }
+        r->pieces = r->cells / 4;
+    }
+    free(queue);
+    *out_regions = regions;
+    *out_num = num;
+    return res;
+}
+
+// smallest region first, label order among equals
+static int region_cmp(const void *a, const void *b)
+{
+    const Region *ra = a;
+    const Region *rb = b;
+    if (ra->cells != rb->cells)
+        return ra->cells < rb->cells ? -1 : 1;
+    return ra->label < rb->label ? -1 : (ra->label > rb->label);
+}
+
+static int sub_bag_cmp(const void *a, const void *b)
+{
+    const SubBag *sa = a;
+    const SubBag *sb = b;
+    if (sa->distance != sb->distance)
+        return sa->distance < sb->distance ? -1 : 1;
+    return sa->ordinal < sb->ordinal ? -1 : (sa->ordinal > sb->ordinal);
+}
+
+// row-major order of anchors, the order the anchored search places pieces in
+static int placement_cmp(const void *a, const void *b)
+{
+    const Placement *pa = a;
+    const Placement *pb = b;
+    if (pa->y != pb->y)
+        return pa->y < pb->y ? -1 : 1;
+    return pa->x < pb->x ? -1 : (pa->x > pb->x);
+}
+
+// recursive enumeration of the sub-bags of left pieces over types type..; suffix[t] = sum of rem[t..]
+static void enumerate_types(Decomposition *d, const Region *r, const size_t *rem, const size_t *suffix,
+                            TetrominoType type, size_t left, size_t *cur, SubBagList *out)
+{
+    if (stopped(d))
+        return;
+    if (type == TETRO_TYPE_COUNT)
+    {
+        if (left != 0 || !t_balance_ok(r, cur[TETRO_T]))
+            return;
+        if (out->num == REGIONS_MAX_SUB_BAGS)
+        {
+            d->gave_up = true;
+            return;
+        }
+        if (out->num == out->cap)
+        {
+            size_t next = out->cap ? out->cap * 2 : 16;
+            SubBag *grown = realloc(out->items, next * sizeof(SubBag));
+            if (!grown)
+            {
+                d->error = STATUS_ERR_MEMORY;
+                return;
+            }
+            out->items = grown;
+            out->cap = next;
+        }
+        SubBag *bag = out->items + out->num;
+        memcpy(bag->counts, cur, sizeof(bag->counts));
+        bag->ordinal = out->num++;
+        return;
+    }
+    // the types after this one must still be able to supply what is left
+    size_t after = suffix[type + 1];
+    size_t lo = left > after ? left - after : 0;
+    size_t hi = rem[type] < left ? rem[type] : left;
+    for (size_t c = lo; c <= hi && !stopped(d); ++c)
+    {
+        cur[type] = c;
+        enumerate_types(d, r, rem, suffix, type + 1, left - c, cur, out);
+    }
+    cur[type] = 0;
+}
+
+// the sub-bags of r->pieces pieces out of rem, nearest to rem's proportions first
+static void enumerate_sub_bags(Decomposition *d, const Region *r, const size_t *rem, SubBagList *out)
+{
+    size_t suffix[TETRO_TYPE_COUNT + 1];
+    suffix[TETRO_TYPE_COUNT] = 0;
+    for (int t = TETRO_TYPE_COUNT - 1; t >= 0; --t)
+        suffix[t] = suffix[t + 1] + rem[t];
+    size_t cur[TETRO_TYPE_COUNT] = {0};
+    enumerate_types(d, r, rem, suffix, 0, r->pieces, cur, out);
+    if (stopped(d))
+        return;
+
+    // |c_t / n - rem_t / total|, scaled by n * total to stay integral
+    uint64_t total = suffix[0];
+    uint64_t n = r->pieces;
+    for (size_t i = 0; i < out->num; ++i)
+    {
+        SubBag *bag = out->items + i;
+        bag->distance = 0;
+        for (size_t t = 0; t < TETRO_TYPE_COUNT; ++t)
+        {
+            uint64_t have = (uint64_t)bag->counts[t] * total;
+            uint64_t share = (uint64_t)rem[t] * n;
+            bag->distance += have > share ? have - share : share - have;
+        }
+    }
+    qsort(out->items, out->num, sizeof(SubBag), sub_bag_cmp);
+}
+
+// index of the try of counts on r, or r->try_num if there is none
+static size_t find_try(const Region *r, const size_t *counts)
+{
+    size_t i = 0;
+    for (; i < r->try_num; ++i)
+    {
+        if (memcmp(r->tries[i].counts, counts, sizeof(r->tries[i].counts)) == 0)
+            break;
+    }
+    return i;
+}
+
+// solve one region with the given counts on a board of its bounding box
+static StatusCode solve_region(const Decomposition *d, const Region *r, RegionTry *t, EndgameTable *endgame,
+                               uint64_t *nodes)
+{
+    int w = board_width(d->board);
+    Board *sub = board_create(r->x1 - r->x0 + 1, r->y1 - r->y0 + 1);
+    t->pieces = malloc(r->pieces * PLACEMENT_SIZE);
+    if (!sub || !t->pieces)
+    {
+        board_destroy(sub);
+        return STATUS_ERR_MEMORY;
+    }
+    for (int y = r->y0; y <= r->y1; ++y)
+    {
+        for (int x = r->x0; x <= r->x1; ++x)
+        {
+            if (d->labels[(size_t)y * (size_t)w + (size_t)x] != r->label)
+                board_block_cell(sub, x - r->x0, y - r->y0);
+        }
+    }
+
+    TetrominoBag bag;
+    memcpy(bag.counts, t->counts, sizeof(bag.counts));
+    bag.total = r->pieces;
+    // one thread per region solve keeps the result independent of the thread count
+    SolverConfig config = *d->config;
+    config.threads = 1;
+    config.deterministic = false;
+    config.endgame = endgame;
+    size_t count = r->pieces;
+    SolverStats stats;
+    StatusCode res = solver_solve_config(sub, &bag, &config, t->pieces, &count, &stats);
+    *nodes = stats.nodes;
+    board_destroy(sub);
+    for (size_t i = 0; res == STATUS_OK && i < r->pieces; ++i)
+    {
+        t->pieces[i].x += r->x0;
+        t->pieces[i].y += r->y0;
+    }
+    return res;
+}
+
+static void *region_job_main(void *arg)
+{
+    RegionJob *job = arg;
+    job->result->res = solve_region(job->d, job->region, job->result, job->endgame, &job->nodes);
+    return NULL;
+}
+
+// append a try for counts to r; its index, or r->try_num on allocation failure
+static size_t add_try(Decomposition *d, Region *r, const size_t *counts)
+{
+    if (r->try_num == r->try_cap)
+    {
+        size_t next = r->try_cap ? r->try_cap * 2 : 8;
+        RegionTry *grown = realloc(r->tries, next * sizeof(RegionTry));
+        if (!grown)
+        {
+            d->error = STATUS_ERR_MEMORY;
+            return r->try_num;
+        }
+        r->tries = grown;
+        r->try_cap = next;
+    }
+    RegionTry *t = r->tries + r->try_num;
+    memcpy(t->counts, counts, sizeof(t->counts));
+    t->res = STATUS_ERR_UNSOLVABLE;
+    t->pieces = NULL;
+    t->visited = false;
+    return r->try_num++;
+}
+
+// solve the untried sub-bags among bags[0..num) on r, up to config->threads at once, and store the results
+static void solve_batch(Decomposition *d, Region *r, const SubBag *bags, size_t num)
+{
+    size_t threads = d->config->threads;
+    RegionJob jobs[SOLVER_MAX_THREADS];
+    size_t first = r->try_num;
+    size_t job_num = 0;
+    for (size_t i = 0; i < num && job_num < threads; ++i)
+    {
+        if (find_try(r, bags[i].counts) < r->try_num)
+            continue;
+        if (add_try(d, r, bags[i].counts) == r->try_num)
+            break;
+        job_num++;
+    }
+    // realloc is done: the tries stay put while the jobs run
+    for (size_t i = 0; i < job_num; ++i)
+    {
+        jobs[i].d = d;
+        jobs[i].region = r;
+        jobs[i].result = r->tries + first + i;
+        if (i > 0 && !d->endgames[i])
+            d->endgames[i] = endgame_create(ENDGAME_TABLE_LOG2); // NULL only disables lookups
+        jobs[i].endgame = d->endgames[i];
+        jobs[i].nodes = 0;
+        jobs[i].started = job_num > 1 && pthread_create(&jobs[i].thread, NULL, region_job_main, jobs + i) == 0;
+        if (!jobs[i].started)
+            region_job_main(jobs + i);
+    }
+    for (size_t i = 0; i < job_num; ++i)
+    {
+        if (jobs[i].started)
+            pthread_join(jobs[i].thread, NULL);
+        d->nodes += jobs[i].nodes;
+        StatusCode res = jobs[i].result->res;
+        if (res != STATUS_OK && res != STATUS_ERR_UNSOLVABLE && d->error == STATUS_OK)
+            d->error = res;
+    }
+}
+
+/* The try for bags[0] on r, solving it (and the next untried ones) if needed; r->try_num once stopped.
+ * Only visits count against REGIONS_MAX_SOLVES, so the thread count never changes where it gives up. */
+static size_t region_try(Decomposition *d, Region *r, const SubBag *bags, size_t num)
+{
+    size_t i = find_try(r, bags[0].counts);
+    if (i == r->try_num)
+    {
+        solve_batch(d, r, bags, num);
+        if (stopped(d))
+            return r->try_num;
+        i = find_try(r, bags[0].counts);
+    }
+    if (!r->tries[i].visited)
+    {
+        if (d->solves == REGIONS_MAX_SOLVES)
+        {
+            d->gave_up = true;
+            return r->try_num;
+        }
+        d->solves++;
+        r->tries[i].visited = true;
+    }
+    return i;
+}
+
+// split rem over regions j..; true once every region has a tiling, recorded in d->chosen
+static bool split_from(Decomposition *d, size_t j, size_t *rem)
+{
+    Region *r = d->regions + j;
+    if (j + 1 == d->num)
+    {
+        // the last (largest) region takes whatever is left
+        if (!t_balance_ok(r, rem[TETRO_T]))
+            return false;
+        SubBag last;
+        memcpy(last.counts, rem, sizeof(last.counts));
+        size_t t = region_try(d, r, &last, 1);
+        if (t == r->try_num || r->tries[t].res != STATUS_OK)
+            return false;
+        d->chosen[j] = t;
+        return true;
+    }
+
+    SubBagList list = {NULL, 0, 0};
+    enumerate_sub_bags(d, r, rem, &list);
+    bool found = false;
+    for (size_t i = 0; i < list.num && !found && !stopped(d); ++i)
+    {
+        size_t t = region_try(d, r, list.items + i, list.num - i);
+        if (t == r->try_num || r->tries[t].res != STATUS_OK)
+            continue;
+        for (size_t k = 0; k < TETRO_TYPE_COUNT; ++k)
+            rem[k] -= list.items[i].counts[k];
+        found = split_from(d, j + 1, rem);
+        for (size_t k = 0; k < TETRO_TYPE_COUNT; ++k)
+            rem[k] += list.items[i].counts[k];
+        if (found)
+            d->chosen[j] = t;
+    }
+    free(list.items);
+    return found;
+}
+
+// place the chosen sub-tilings on board and list them in anchor order
+static StatusCode merge_regions(const Decomposition *d, Board *board, Placement *out_list)
+{
+    size_t num = 0;
+    for (size_t j = 0; j < d->num; ++j)
+    {
+        const Region *r = d->regions + j;
+        memcpy(out_list + num, r->tries[d->chosen[j]].pieces, r->pieces * PLACEMENT_SIZE);
+        num += r->pieces;
+    }
+    qsort(out_list, num, PLACEMENT_SIZE, placement_cmp);
+    for (size_t i = 0; i < num; ++i)
+    {
+        Placement *p = out_list + i;
+        p->mark = (char)('A' + (int)(i % MARK_NUM));
+        if (!board_place(board, p->x, p->y, p->type, p->rotation, p->mark))
+        {
+            // regions are disjoint, so this cannot happen; undo rather than leave half a tiling
+            while (i-- > 0)
+                board_remove(board, out_list[i].x, out_list[i].y, out_list[i].type, out_list[i].rotation);
+            return STATUS_ERR_INVALID_ARGUMENT;
+        }
+    }
+    return STATUS_OK;
+}
+
+bool regions_solve(Board *board,
+                   const TetrominoBag *bag,
+                   const SolverConfig *config,
+                   Placement *out_list,
+                   SolverStats *stats,
+                   StatusCode *out_res)
+{
+    // an empty board is one region
+    if (board_filled_count(board) == 0 || bag->total == 0)
+        return false;
+    size_t bag_total = 0;
+    for (size_t t = 0; t < TETRO_TYPE_COUNT; ++t)
+        bag_total += bag->counts[t];
+    if (bag_total != bag->total)
+        return false;
+
+    int *labels = malloc(board_cell_count(board) * sizeof(int));
+    if (!labels)
+    {
+        *out_res = STATUS_ERR_MEMORY;
+        return true;
+    }
+    Decomposition d;
+    memset(&d, 0, sizeof(d));
+    d.board = board;
+    d.labels = labels;
+    d.config = config;
+    d.endgames[0] = config->endgame;
+    d.error = label_regions(board, labels, &d.regions, &d.num);
+
+    bool decided = true;
+    StatusCode res = d.error;
+    if (res == STATUS_OK && d.num < 2)
+        decided = false;
+    else if (res == STATUS_OK)
+    {
+        res = STATUS_ERR_UNSOLVABLE;
+        bool fits = true;
+        for (size_t j = 0; j < d.num; ++j)
+            fits = fits && d.regions[j].cells % 4 == 0;
+        qsort(d.regions, d.num, sizeof(Region), region_cmp);
+        d.chosen = calloc(d.num, sizeof(size_t));
+        size_t rem[TETRO_TYPE_COUNT];
+        memcpy(rem, bag->counts, sizeof(rem));
+        if (!d.chosen)
+            res = STATUS_ERR_MEMORY;
+        else if (fits && split_from(&d, 0, rem))
+            res = merge_regions(&d, board, out_list);
+        else if (d.error != STATUS_OK)
+            res = d.error;
+        else if (d.gave_up)
+            decided = false;
+    }
+
+    if (decided)
+    {
+        memset(stats, 0, sizeof(*stats));
+        stats->nodes = d.nodes;
+        stats->randomized = config->randomize;
+        stats->seed = config->seed;
+        *out_res = res;
+    }
+    for (size_t j = 0; j < d.num; ++j)
+    {
+        for (size_t i = 0; i < d.regions[j].try_num; ++i)
+            free(d.regions[j].tries[i].pieces);
+        free(d.regions[j].tries);
+    }
+    for (size_t i = 1; i < SOLVER_MAX_THREADS; ++i)
+        endgame_destroy(d.endgames[i]);
+    free(d.regions);
+    free(d.chosen);
+    free(labels);
+    return decided;
+}
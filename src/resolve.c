@@ -0,0 +1,589 @@
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include "resolve.h"
+#include "search.h"
+#include "tetromino.h"
+
+/* Resolve implementation:
+ *   - Distances to the repair come from one multi-source BFS over the board, so choosing what to rip up
+ *     costs O(area) per round however many pieces are kept.
+ *   - Kept pieces stay on the board while a round searches; the engine only sees the freed cells.
+ *   - Kept pieces keep their marks, so the output diffs cleanly against the previous tiling; new pieces
+ *     take the first letter none of their neighbours uses. */
+
+#define MARK_NUM 26 // 26 letters from A-Z
+
+// a piece with its first cell (row-major index) for ordering
+typedef struct OrderedPiece
+{
+    size_t first_cell;
+    bool fresh; // placed by a round; needs a mark
+    Placement piece;
+} OrderedPiece;
+
+// 4x4 occupancy of a shape, bit (y * 4 + x)
+static uint16_t shape_mask(const Cell cells[4])
+{
+    uint16_t mask = 0;
+    for (size_t i = 0; i < 4; ++i)
+        mask = (uint16_t)(mask | (1u << (cells[i].y * 4 + cells[i].x)));
+    return mask;
+}
+
+// the orientation whose cells are exactly these (any order); false if they form no tetromino
+static bool identify_piece(const Cell cells[4], char mark, Placement *out)
+{
+    int min_x = cells[0].x, min_y = cells[0].y;
+    for (size_t i = 1; i < 4; ++i)
+    {
+        if (cells[i].x < min_x)
+            min_x = cells[i].x;
+        if (cells[i].y < min_y)
+            min_y = cells[i].y;
+    }
+    Cell rel[4];
+    for (size_t i = 0; i < 4; ++i)
+    {
+        rel[i].x = cells[i].x - min_x;
+        rel[i].y = cells[i].y - min_y;
+        if (rel[i].x > 3 || rel[i].y > 3)
+            return false;
+    }
+    uint16_t mask = shape_mask(rel);
+    for (size_t t = 0; t < TETRO_TYPE_COUNT; ++t)
+    {
+        for (size_t r = 0; r < tetro_rotation_count((TetrominoType)t); ++r)
+        {
+            Cell shape[4];
+            tetro_get_cells((TetrominoType)t, r, shape);
+            if (shape_mask(shape) != mask)
+                continue;
+            out->type = (TetrominoType)t;
+            out->rotation = r;
+            out->x = min_x;
+            out->y = min_y;
+            out->mark = mark;
+            return true;
+        }
+    }
+    return false;
+}
+
+// whole stream into a NUL-terminated buffer
+static StatusCode read_all(FILE *in, char **out_text, size_t *out_len)
+{
+    size_t cap = 4096, len = 0;
+    char *text = malloc(cap);
+    if (!text)
+        return STATUS_ERR_MEMORY;
+    int ch;
+    while ((ch = getc(in)) != EOF)
+    {
+        if (len + 1 == cap)
+        {
+            char *grown = cap <= SIZE_MAX / 2 ? realloc(text, cap * 2) : NULL;
+            if (!grown)
+            {
+                free(text);
+                return STATUS_ERR_MEMORY;
+            }
+            text = grown;
+            cap *= 2;
+        }
+        text[len++] = (char)ch;
+    }
+    text[len] = '\0';
+    if (ferror(in))
+    {
+        free(text);
+        return STATUS_ERR_INPUT;
+    }
+    *out_text = text;
+    *out_len = len;
+    return STATUS_OK;
+}
+
+// cut the text into grid rows in place: grid[y * width + x]; rows are packed to the front of text
+static StatusCode pack_rows(char *text, size_t len, int *out_w, int *out_h)
+{
+    size_t width = 0, height = 0, out = 0, pos = 0;
+    while (pos < len)
+    {
+        size_t end = pos;
+        while (end < len && text[end] != '\n')
+            end++;
+        size_t line_end = end;
+        if (line_end > pos && text[line_end - 1] == '\r')
+            line_end--;
+        size_t line_len = line_end - pos;
+        if (line_len > 0)
+        {
+            if (height == 0)
+                width = line_len;
+            else if (line_len != width)
+                return STATUS_ERR_INPUT;
+            if (width > (size_t)INT_MAX || height == (size_t)INT_MAX)
+                return STATUS_ERR_INPUT;
+            for (size_t i = pos; i < line_end; ++i)
+            {
+                char c = text[i];
+                if (c != '.' && c != BOARD_BLOCKED_MARK && !isalpha((unsigned char)c))
+                    return STATUS_ERR_INPUT;
+                text[out++] = c;
+            }
+            height++;
+        }
+        pos = end + 1;
+    }
+    if (height == 0)
+        return STATUS_ERR_INPUT;
+    *out_w = (int)width;
+    *out_h = (int)height;
+    return STATUS_OK;
+}
+
+StatusCode resolve_read_tiling(FILE *in, PreviousTiling *out)
+{
+    if (!in || !out)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    memset(out, 0, sizeof(*out));
+    char *grid = NULL;
+    size_t len = 0;
+    StatusCode res = read_all(in, &grid, &len);
+    if (res != STATUS_OK)
+        return res;
+    int w = 0, h = 0;
+    res = pack_rows(grid, len, &w, &h);
+    if (res != STATUS_OK)
+    {
+        free(grid);
+        return res;
+    }
+
+    // 4-connected groups of one mark
+    size_t area = (size_t)w * (size_t)h;
+    bool *seen = calloc(area, sizeof(bool));
+    size_t *stack = malloc(area * sizeof(size_t));
+    Placement *pieces = malloc((area / 4 + 1) * PLACEMENT_SIZE);
+    if (!seen || !stack || !pieces)
+    {
+        free(grid);
+        free(seen);
+        free(stack);
+        free(pieces);
+        return STATUS_ERR_MEMORY;
+    }
+    size_t num = 0, lost = 0;
+    for (size_t start = 0; start < area; ++start)
+    {
+        char mark = grid[start];
+        if (mark == '.' || mark == BOARD_BLOCKED_MARK || seen[start])
+            continue; // obstacles come from the new instance, not from the previous tiling
+        Cell cells[4];
+        size_t size = 0, top = 0;
+        stack[top++] = start;
+        seen[start] = true;
+        while (top > 0)
+        {
+            size_t cur = stack[--top];
+            int x = (int)(cur % (size_t)w), y = (int)(cur / (size_t)w);
+            if (size < 4)
+            {
+                cells[size].x = x;
+                cells[size].y = y;
+            }
+            size++;
+            const int dx[4] = {1, -1, 0, 0};
+            const int dy[4] = {0, 0, 1, -1};
+            for (size_t k = 0; k < 4; ++k)
+            {
+                int nx = x + dx[k], ny = y + dy[k];
+                if (nx < 0 || ny < 0 || nx >= w || ny >= h)
+                    continue;
+                size_t next = (size_t)ny * (size_t)w + (size_t)nx;
+                if (!seen[next] && grid[next] == mark)
+                {
+                    seen[next] = true;
+                    stack[top++] = next;
+                }
+            }
+        }
+        if (size == 4 && identify_piece(cells, mark, pieces + num))
+            num++;
+        else
+            lost += size;
+    }
+    free(grid);
+    free(seen);
+    free(stack);
+
+    out->width = w;
+    out->height = h;
+    out->pieces = pieces;
+    out->num = num;
+    out->lost_cells = lost;
+    return STATUS_OK;
+}
+
+void resolve_tiling_free(PreviousTiling *prev)
+{
+    if (!prev)
+        return;
+    free(prev->pieces);
+    memset(prev, 0, sizeof(*prev));
+}
+
+// distance of every cell to the nearest empty cell (8-neighbour steps: Chebyshev on open ground, else
+// 4-neighbour: Manhattan); -1 everywhere when the board is full
+static void distance_to_empty(const Board *board, bool diagonal, int *dist, size_t *queue)
+{
+    int w = board_width(board), h = board_height(board);
+    size_t area = board_cell_count(board), head = 0, tail = 0;
+    for (size_t i = 0; i < area; ++i)
+    {
+        dist[i] = -1;
+        if (board_is_empty(board, (int)(i % (size_t)w), (int)(i / (size_t)w)))
+        {
+            dist[i] = 0;
+            queue[tail++] = i;
+        }
+    }
+    while (head < tail)
+    {
+        size_t cur = queue[head++];
+        int x = (int)(cur % (size_t)w), y = (int)(cur / (size_t)w);
+        for (int dy = -1; dy <= 1; ++dy)
+        {
+            for (int dx = -1; dx <= 1; ++dx)
+            {
+                if ((dx == 0 && dy == 0) || (!diagonal && dx != 0 && dy != 0))
+                    continue;
+                int nx = x + dx, ny = y + dy;
+                if (nx < 0 || ny < 0 || nx >= w || ny >= h)
+                    continue;
+                size_t next = (size_t)ny * (size_t)w + (size_t)nx;
+                if (dist[next] < 0)
+                {
+                    dist[next] = dist[cur] + 1;
+                    queue[tail++] = next;
+                }
+            }
+        }
+    }
+}
+
+// nearest distance over a piece's cells; INT_MAX if none is reached
+static int piece_distance(const Board *board, const int *dist, const Placement *p)
+{
+    Cell cells[4];
+    size_t n = tetro_get_cells(p->type, p->rotation, cells);
+    int best = INT_MAX;
+    for (size_t i = 0; i < n; ++i)
+    {
+        int d = dist[(size_t)(p->y + cells[i].y) * (size_t)board_width(board) + (size_t)(p->x + cells[i].x)];
+        if (d >= 0 && d < best)
+            best = d;
+    }
+    return best;
+}
+
+// row-major index of the first cell a piece covers
+static size_t first_cell(int width, const Placement *p)
+{
+    Cell cells[4];
+    size_t n = tetro_get_cells(p->type, p->rotation, cells);
+    size_t best = SIZE_MAX;
+    for (size_t i = 0; i < n; ++i)
+    {
+        size_t cell = (size_t)(p->y + cells[i].y) * (size_t)width + (size_t)(p->x + cells[i].x);
+        if (cell < best)
+            best = cell;
+    }
+    return best;
+}
+
+// excess candidates: nearest to the uncovered cells first, then last in row-major order
+typedef struct ExcessCand
+{
+    int distance;
+    size_t first_cell;
+    size_t index;
+} ExcessCand;
+
+static int cmp_excess(const void *a, const void *b)
+{
+    const ExcessCand *pa = a;
+    const ExcessCand *pb = b;
+    if (pa->distance != pb->distance)
+        return (pa->distance > pb->distance) - (pa->distance < pb->distance);
+    return (pa->first_cell < pb->first_cell) - (pa->first_cell > pb->first_cell);
+}
+
+static int cmp_ordered(const void *a, const void *b)
+{
+    const OrderedPiece *pa = a;
+    const OrderedPiece *pb = b;
+    return (pa->first_cell > pb->first_cell) - (pa->first_cell < pb->first_cell);
+}
+
+// take out the kept pieces that satisfy the filter; returns how many remain
+static size_t rip_up(Board *board, Placement *kept, size_t kept_num, const bool *rip)
+{
+    size_t out = 0;
+    for (size_t i = 0; i < kept_num; ++i)
+    {
+        if (rip[i])
+            board_remove(board, kept[i].x, kept[i].y, kept[i].type, kept[i].rotation);
+        else
+            kept[out++] = kept[i];
+    }
+    return out;
+}
+
+// rip up the kept pieces of every type the bag holds fewer of, nearest to the uncovered cells first
+static StatusCode rip_excess(Board *board, const TetrominoBag *bag, Placement *kept, size_t *kept_num,
+                             int *dist, size_t *queue)
+{
+    size_t have[TETRO_TYPE_COUNT] = {0};
+    for (size_t i = 0; i < *kept_num; ++i)
+        have[kept[i].type]++;
+    bool any = false;
+    for (size_t t = 0; t < TETRO_TYPE_COUNT; ++t)
+        any = any || have[t] > bag->counts[t];
+    if (!any)
+        return STATUS_OK;
+
+    distance_to_empty(board, false, dist, queue);
+    ExcessCand *cands = malloc(*kept_num * sizeof(ExcessCand));
+    bool *rip = calloc(*kept_num, sizeof(bool));
+    if (!cands || !rip)
+    {
+        free(cands);
+        free(rip);
+        return STATUS_ERR_MEMORY;
+    }
+    for (size_t t = 0; t < TETRO_TYPE_COUNT; ++t)
+    {
+        if (have[t] <= bag->counts[t])
+            continue;
+        size_t n = 0;
+        for (size_t i = 0; i < *kept_num; ++i)
+        {
+            if (kept[i].type != (TetrominoType)t)
+                continue;
+            cands[n].distance = piece_distance(board, dist, kept + i);
+            cands[n].first_cell = first_cell(board_width(board), kept + i);
+            cands[n].index = i;
+            n++;
+        }
+        qsort(cands, n, sizeof(ExcessCand), cmp_excess);
+        for (size_t k = 0; k < have[t] - bag->counts[t]; ++k)
+            rip[cands[k].index] = true;
+    }
+    *kept_num = rip_up(board, kept, *kept_num, rip);
+    free(cands);
+    free(rip);
+    return STATUS_OK;
+}
+
+// tile the empty cells with what the bag holds beyond the kept pieces, within the round limit
+static SearchOutcome search_round(Board *board, const TetrominoBag *bag, const Placement *kept, size_t kept_num,
+                                  EndgameTable *endgame, Placement *found, size_t *found_num, uint64_t *nodes,
+                                  StatusCode *error)
+{
+    TetrominoBag rest = *bag;
+    for (size_t i = 0; i < kept_num; ++i)
+        rest.counts[kept[i].type]--;
+    rest.total = bag->total - kept_num;
+
+    SearchContext ctx;
+    *error = search_init(&ctx, board, &rest, endgame);
+    if (*error != STATUS_OK)
+        return SEARCH_ERROR;
+    ctx.node_limit = RESOLVE_ROUND_NODE_LIMIT;
+    SearchOutcome outcome = search_run(&ctx);
+    *nodes += ctx.nodes;
+    if (outcome == SEARCH_SOLVED)
+        *found_num = search_placements(&ctx, found); // they stay on the board
+    else
+        search_unwind(&ctx);
+    if (outcome == SEARCH_ERROR)
+        *error = ctx.error;
+    search_release(&ctx);
+    return outcome;
+}
+
+// first letter that no piece touching p uses (p not placed yet)
+static char free_mark(const Board *board, const Placement *p)
+{
+    bool used[MARK_NUM] = {false};
+    Cell cells[4];
+    size_t n = tetro_get_cells(p->type, p->rotation, cells);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const int dx[4] = {1, -1, 0, 0};
+        const int dy[4] = {0, 0, 1, -1};
+        for (size_t k = 0; k < 4; ++k)
+        {
+            char mark = board_cell_mark(board, p->x + cells[i].x + dx[k], p->y + cells[i].y + dy[k]);
+            if (mark >= 'A' && mark <= 'Z')
+                used[mark - 'A'] = true;
+        }
+    }
+    for (size_t m = 0; m < MARK_NUM; ++m)
+    {
+        if (!used[m])
+            return (char)('A' + m);
+    }
+    return 'A'; // a tetromino has at most 10 neighbouring cells
+}
+
+// kept + found as one list ordered by first cell; found pieces get marks that stand out
+static StatusCode remark(Board *board, const Placement *kept, size_t kept_num, const Placement *found,
+                         size_t found_num, Placement *out_list)
+{
+    size_t n = kept_num + found_num;
+    OrderedPiece *order = malloc((n > 0 ? n : 1) * sizeof(OrderedPiece));
+    if (!order)
+        return STATUS_ERR_MEMORY;
+    for (size_t i = 0; i < n; ++i)
+    {
+        order[i].fresh = i >= kept_num;
+        order[i].piece = order[i].fresh ? found[i - kept_num] : kept[i];
+        order[i].first_cell = first_cell(board_width(board), &order[i].piece);
+        if (order[i].fresh)
+            board_remove(board, order[i].piece.x, order[i].piece.y, order[i].piece.type, order[i].piece.rotation);
+    }
+    qsort(order, n, sizeof(OrderedPiece), cmp_ordered);
+    for (size_t i = 0; i < n; ++i)
+    {
+        Placement *p = out_list + i;
+        *p = order[i].piece;
+        if (order[i].fresh)
+        {
+            p->mark = free_mark(board, p);
+            board_place(board, p->x, p->y, p->type, p->rotation, p->mark);
+        }
+    }
+    free(order);
+    return STATUS_OK;
+}
+
+StatusCode resolve_solve(Board *board,
+                         const TetrominoBag *bag,
+                         const PreviousTiling *prev,
+                         const SolverConfig *config,
+                         Placement *out_list,
+                         size_t *inout_count,
+                         ResolveStats *out_stats)
+{
+    if (!board || !bag || !prev || !out_list || !inout_count)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    if (bag->total > SIZE_MAX / 4 || bag->total > (size_t)INT_MAX || *inout_count < bag->total)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    ResolveStats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.previous = prev->num;
+    stats.radius = -1;
+    size_t area = board_cell_count(board);
+    size_t filled = board_filled_count(board);
+    if (filled > area || area - filled != bag->total * 4)
+    {
+        *inout_count = 0;
+        if (out_stats)
+            *out_stats = stats;
+        return STATUS_ERR_UNSOLVABLE;
+    }
+
+    Placement *kept = malloc((prev->num > 0 ? prev->num : 1) * PLACEMENT_SIZE);
+    Placement *found = malloc((bag->total > 0 ? bag->total : 1) * PLACEMENT_SIZE);
+    bool *rip = malloc((prev->num > 0 ? prev->num : 1) * sizeof(bool));
+    int *dist = malloc(area * sizeof(int));
+    size_t *queue = malloc(area * sizeof(size_t));
+    StatusCode res = kept && found && rip && dist && queue ? STATUS_OK : STATUS_ERR_MEMORY;
+
+    // the rounds and the full solve share one endgame table
+    SolverConfig full;
+    if (config)
+        full = *config;
+    else
+        solver_config_init(&full);
+    EndgameTable *owned = NULL;
+    if (!full.endgame)
+        full.endgame = owned = endgame_create(ENDGAME_TABLE_LOG2); // NULL only disables lookups
+
+    // keep every previous piece that still fits, then drop what the bag no longer holds
+    size_t kept_num = 0;
+    for (size_t i = 0; res == STATUS_OK && i < prev->num; ++i)
+    {
+        const Placement *p = prev->pieces + i;
+        if (board_place(board, p->x, p->y, p->type, p->rotation, p->mark))
+            kept[kept_num++] = *p;
+    }
+    if (res == STATUS_OK)
+        res = rip_excess(board, bag, kept, &kept_num, dist, queue);
+
+    // widen the neighbourhood of the freed cells until a round tiles it
+    bool solved = false;
+    size_t found_num = 0;
+    if (res == STATUS_OK)
+    {
+        distance_to_empty(board, true, dist, queue);
+        int span = board_width(board) > board_height(board) ? board_width(board) : board_height(board);
+        for (int radius = 0; radius < span; radius = radius > 0 ? radius * 2 : 1)
+        {
+            for (size_t i = 0; i < kept_num; ++i)
+                rip[i] = piece_distance(board, dist, kept + i) <= radius;
+            kept_num = rip_up(board, kept, kept_num, rip);
+            stats.rounds++;
+            SearchOutcome outcome =
+                search_round(board, bag, kept, kept_num, full.endgame, found, &found_num, &stats.nodes, &res);
+            if (outcome == SEARCH_SOLVED)
+            {
+                solved = true;
+                stats.radius = radius;
+                break;
+            }
+            if (outcome == SEARCH_ERROR)
+                break;
+        }
+    }
+
+    if (res == STATUS_OK && solved)
+    {
+        res = remark(board, kept, kept_num, found, found_num, out_list);
+        if (res == STATUS_OK)
+        {
+            stats.kept = kept_num;
+            *inout_count = bag->total;
+        }
+    }
+    else if (res == STATUS_OK)
+    {
+        // last resort: the whole board from scratch
+        for (size_t i = 0; i < kept_num; ++i)
+            rip[i] = true;
+        kept_num = rip_up(board, kept, kept_num, rip);
+        stats.full_solve = true;
+        res = solver_solve_config(board, bag, &full, out_list, inout_count, &stats.solver);
+        stats.nodes += stats.solver.nodes;
+    }
+    else
+    {
+        for (size_t i = 0; i < kept_num; ++i)
+            rip[i] = true;
+        rip_up(board, kept, kept_num, rip);
+    }
+
+    free(kept);
+    free(found);
+    free(rip);
+    free(dist);
+    free(queue);
+    endgame_destroy(owned);
+    if (out_stats)
+        *out_stats = stats;
+    return res;
+}
@@ -0,0 +1,802 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "sat.h"
+
+/* SAT solver implementation:
+ *   - Literal 2*(v-1) is v, 2*(v-1)+1 is -v; values are kept per variable (1 true, -1 false, 0 unset).
+ *   - Every clause watches lits[0] and lits[1]; a reason clause has its implied literal at lits[0].
+ *   - Learnt clauses are reduced at restarts (decision level 0), where no reason can point at them,
+ *     by compacting the clause arena and rebuilding the watch lists. */
+
+#define CLAUSE_NONE UINT32_MAX
+#define VAR_DECAY 0.95
+#define VAR_RESCALE_LIMIT 1e100
+#define RESTART_UNIT 100    // conflicts per Luby unit
+#define REDUCE_FIRST 2000   // learnt clauses kept before the first reduction
+#define REDUCE_GROWTH 300   // raise of the limit after each reduction
+#define GLUE_KEEP 2         // learnt clauses with LBD <= GLUE_KEEP are never removed
+#define INITIAL_VAR_CAP 16
+
+typedef uint32_t Lit;
+
+typedef struct Watch
+{
+    uint32_t clause;
+    Lit blocker; // if true the clause is satisfied and need not be visited
+} Watch;
+
+typedef struct WatchList
+{
+    Watch *items;
+    size_t size;
+    size_t cap;
+} WatchList;
+
+typedef struct Clause
+{
+    size_t start; // offset of the literals in the arena
+    uint32_t size;
+    uint32_t lbd;
+    bool learnt;
+    bool deleted;
+} Clause;
+
+struct SatSolver
+{
+    uint32_t var_num;
+    uint32_t var_cap;
+
+    // per variable
+    int8_t *vals;
+    int8_t *phase;
+    uint32_t *level;
+    uint32_t *reason;
+    double *activity;
+    uint8_t *seen;
+    uint32_t *level_stamp; // indexed by decision level, for LBD
+    uint32_t *heap;
+    int32_t *heap_pos; // -1 when not in the heap
+    Lit *trail;
+    size_t *trail_lim;
+    Lit *learnt; // scratch for conflict analysis
+
+    // per literal
+    WatchList *watches;
+
+    // clauses
+    Clause *clauses;
+    size_t clause_num;
+    size_t clause_cap;
+    Lit *arena;
+    size_t arena_size;
+    size_t arena_cap;
+    size_t learnt_num;
+
+    uint32_t heap_size;
+    size_t trail_size;
+    size_t qhead;
+    uint32_t level_num;
+    uint32_t stamp;
+    double var_inc;
+    bool unsat;
+    bool oom; // an allocation failed while solving
+    uint64_t conflict_limit; // 0: none
+    SatStats stats;
+};
+
+static inline Lit lit_neg(Lit l)
+{
+    return l ^ 1u;
+}
+
+static inline uint32_t lit_var(Lit l)
+{
+    return l >> 1;
+}
+
+static inline int lit_value(const SatSolver *s, Lit l)
+{
+    int v = s->vals[lit_var(l)];
+    return (l & 1u) ? -v : v;
+}
+
+// reallocate an array to cap elements of elem_size bytes; NULL on failure (array left intact)
+static void *resize(void *array, size_t cap, size_t elem_size)
+{
+    if (cap > SIZE_MAX / elem_size)
+        return NULL;
+    return realloc(array, cap * elem_size);
+}
+
+// grow the array field of s to cap elements or make the enclosing function return false
+#define GROW_FIELD(s, field, cap)                                        \
+    do                                                                   \
+    {                                                                    \
+        void *grown_ = resize((s)->field, (cap), sizeof(*(s)->field));   \
+        if (!grown_)                                                     \
+            return false;                                                \
+        (s)->field = grown_;                                             \
+    } while (0)
+
+// make room for cap variables (all per-variable and per-literal arrays)
+static bool grow_vars(SatSolver *s, uint32_t cap)
+{
+    if (cap <= s->var_cap)
+        return true;
+    if (cap > (UINT32_MAX - 1) / 2)
+        return false;
+    GROW_FIELD(s, vals, cap);
+    GROW_FIELD(s, phase, cap);
+    GROW_FIELD(s, level, cap);
+    GROW_FIELD(s, reason, cap);
+    GROW_FIELD(s, activity, cap);
+    GROW_FIELD(s, seen, cap);
+    GROW_FIELD(s, level_stamp, (size_t)cap + 1);
+    GROW_FIELD(s, heap, cap);
+    GROW_FIELD(s, heap_pos, cap);
+    GROW_FIELD(s, trail, cap);
+    GROW_FIELD(s, trail_lim, (size_t)cap + 1);
+    GROW_FIELD(s, learnt, cap);
+    GROW_FIELD(s, watches, 2 * (size_t)cap);
+    memset(s->watches + 2 * (size_t)s->var_cap, 0, 2 * (size_t)(cap - s->var_cap) * sizeof(WatchList));
+    memset(s->level_stamp, 0, ((size_t)cap + 1) * sizeof(uint32_t));
+    s->stamp = 0;
+    s->var_cap = cap;
+    return true;
+}
+
+static void heap_up(SatSolver *s, uint32_t i)
+{
+    uint32_t v = s->heap[i];
+    while (i > 0)
+    {
+        uint32_t parent = (i - 1) / 2;
+        if (s->activity[s->heap[parent]] >= s->activity[v])
+            break;
+        s->heap[i] = s->heap[parent];
+        s->heap_pos[s->heap[i]] = (int32_t)i;
+        i = parent;
+    }
+    s->heap[i] = v;
+    s->heap_pos[v] = (int32_t)i;
+}
+
+static void heap_down(SatSolver *s, uint32_t i)
+{
+    uint32_t v = s->heap[i];
+    while (true)
+    {
+        uint32_t child = 2 * i + 1;
+        if (child >= s->heap_size)
+            break;
+        if (child + 1 < s->heap_size && s->activity[s->heap[child + 1]] > s->activity[s->heap[child]])
+            child++;
+        if (s->activity[s->heap[child]] <= s->activity[v])
+            break;
+        s->heap[i] = s->heap[child];
+        s->heap_pos[s->heap[i]] = (int32_t)i;
+        i = child;
+    }
+    s->heap[i] = v;
+    s->heap_pos[v] = (int32_t)i;
+}
+
+static void heap_insert(SatSolver *s, uint32_t v)
+{
+    if (s->heap_pos[v] >= 0)
+        return;
+    s->heap[s->heap_size] = v;
+    s->heap_pos[v] = (int32_t)s->heap_size;
+    heap_up(s, s->heap_size++);
+}
+
+static uint32_t heap_pop(SatSolver *s)
+{
+    uint32_t v = s->heap[0];
+    s->heap_pos[v] = -1;
+    s->heap_size--;
+    if (s->heap_size > 0)
+    {
+        s->heap[0] = s->heap[s->heap_size];
+        s->heap_pos[s->heap[0]] = 0;
+        heap_down(s, 0);
+    }
+    return v;
+}
+
+static void bump_var(SatSolver *s, uint32_t v)
+{
+    s->activity[v] += s->var_inc;
+    if (s->activity[v] > VAR_RESCALE_LIMIT)
+    {
+        for (uint32_t i = 0; i < s->var_num; ++i)
+            s->activity[i] /= VAR_RESCALE_LIMIT;
+        s->var_inc /= VAR_RESCALE_LIMIT;
+    }
+    if (s->heap_pos[v] >= 0)
+        heap_up(s, (uint32_t)s->heap_pos[v]);
+}
+
+static bool watch_push(WatchList *list, uint32_t clause, Lit blocker)
+{
+    if (list->size == list->cap)
+    {
+        size_t cap = list->cap ? list->cap * 2 : 4;
+        GROW_FIELD(list, items, cap);
+        list->cap = cap;
+    }
+    list->items[list->size].clause = clause;
+    list->items[list->size].blocker = blocker;
+    list->size++;
+    return true;
+}
+
+// store a clause of size >= 2 and watch its first two literals; CLAUSE_NONE on allocation failure
+static uint32_t attach_clause(SatSolver *s, const Lit *lits, uint32_t size, bool learnt, uint32_t lbd)
+{
+    if (s->clause_num >= CLAUSE_NONE)
+        return CLAUSE_NONE;
+    if (s->clause_num == s->clause_cap)
+    {
+        size_t cap = s->clause_cap ? s->clause_cap * 2 : 1024;
+        Clause *grown = resize(s->clauses, cap, sizeof(Clause));
+        if (!grown)
+            return CLAUSE_NONE;
+        s->clauses = grown;
+        s->clause_cap = cap;
+    }
+    if (s->arena_size + size > s->arena_cap)
+    {
+        size_t cap = s->arena_cap ? s->arena_cap : 4096;
+        while (cap < s->arena_size + size)
+            cap *= 2;
+        Lit *grown = resize(s->arena, cap, sizeof(Lit));
+        if (!grown)
+            return CLAUSE_NONE;
+        s->arena = grown;
+        s->arena_cap = cap;
+    }
+
+    uint32_t idx = (uint32_t)s->clause_num;
+    Clause *c = s->clauses + idx;
+    c->start = s->arena_size;
+    c->size = size;
+    c->lbd = lbd;
+    c->learnt = learnt;
+    c->deleted = false;
+    memcpy(s->arena + s->arena_size, lits, size * sizeof(Lit));
+    if (!watch_push(s->watches + lits[0], idx, lits[1]) || !watch_push(s->watches + lits[1], idx, lits[0]))
+        return CLAUSE_NONE;
+    s->arena_size += size;
+    s->clause_num++;
+    return idx;
+}
+
+static inline void assign(SatSolver *s, Lit l, uint32_t reason)
+{
+    uint32_t v = lit_var(l);
+    s->vals[v] = (l & 1u) ? -1 : 1;
+    s->level[v] = s->level_num;
+    s->reason[v] = reason;
+    s->trail[s->trail_size++] = l;
+}
+
+// unit propagation; returns the conflicting clause or CLAUSE_NONE
+static uint32_t propagate(SatSolver *s)
+{
+    while (s->qhead < s->trail_size)
+    {
+        Lit false_lit = lit_neg(s->trail[s->qhead++]);
+        WatchList *ws = s->watches + false_lit;
+        size_t i = 0;
+        size_t j = 0;
+        s->stats.propagations++;
+        while (i < ws->size)
+        {
+            Watch w = ws->items[i++];
+            if (lit_value(s, w.blocker) > 0)
+            {
+                ws->items[j++] = w;
+                continue;
+            }
+
+            // keep the false literal at lits[1]
+            Clause *c = s->clauses + w.clause;
+            Lit *lits = s->arena + c->start;
+            if (lits[0] == false_lit)
+            {
+                lits[0] = lits[1];
+                lits[1] = false_lit;
+            }
+            Lit first = lits[0];
+            if (first != w.blocker && lit_value(s, first) > 0)
+            {
+                ws->items[j].clause = w.clause;
+                ws->items[j].blocker = first;
+                j++;
+                continue;
+            }
+
+            // look for a new literal to watch
+            bool moved = false;
+            for (uint32_t k = 2; k < c->size; ++k)
+            {
+                if (lit_value(s, lits[k]) >= 0)
+                {
+                    if (!watch_push(s->watches + lits[k], w.clause, first))
+                    {
+                        s->oom = true; // keep the old watch; sat_solve gives up
+                        break;
+                    }
+                    lits[1] = lits[k];
+                    lits[k] = false_lit;
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved)
+                continue;
+
+            // clause is unit or conflicting under the current assignment
+            ws->items[j].clause = w.clause;
+            ws->items[j].blocker = first;
+            j++;
+            if (lit_value(s, first) < 0)
+            {
+                while (i < ws->size)
+                    ws->items[j++] = ws->items[i++];
+                ws->size = j;
+                s->qhead = s->trail_size;
+                return w.clause;
+            }
+            assign(s, first, w.clause);
+        }
+        ws->size = j;
+    }
+    return CLAUSE_NONE;
+}
+
+// undo every assignment above the given decision level
+static void backtrack(SatSolver *s, uint32_t level)
+{
+    if (s->level_num <= level)
+        return;
+    size_t bottom = s->trail_lim[level];
+    for (size_t i = s->trail_size; i > bottom; --i)
+    {
+        uint32_t v = lit_var(s->trail[i - 1]);
+        s->phase[v] = s->vals[v];
+        s->vals[v] = 0;
+        s->reason[v] = CLAUSE_NONE;
+        heap_insert(s, v);
+    }
+    s->trail_size = bottom;
+    s->qhead = bottom;
+    s->level_num = level;
+}
+
+// a learnt literal is redundant if its reason is covered by the clause (or level 0)
+static bool lit_redundant(const SatSolver *s, Lit l)
+{
+    uint32_t reason = s->reason[lit_var(l)];
+    if (reason == CLAUSE_NONE)
+        return false;
+    const Clause *c = s->clauses + reason;
+    const Lit *lits = s->arena + c->start;
+    for (uint32_t k = 1; k < c->size; ++k)
+    {
+        uint32_t v = lit_var(lits[k]);
+        if (!s->seen[v] && s->level[v] > 0)
+            return false;
+    }
+    return true;
+}
+
+// first-UIP analysis; fills s->learnt (asserting literal first) and returns its size
+static uint32_t analyze(SatSolver *s, uint32_t confl, uint32_t *out_level, uint32_t *out_lbd)
+{
+    uint32_t size = 1; // learnt[0] is the asserting literal, filled at the end
+    uint32_t path = 0;
+    size_t index = s->trail_size;
+    Lit p = 0;
+    bool have_p = false;
+
+    do
+    {
+        const Clause *c = s->clauses + confl;
+        const Lit *lits = s->arena + c->start;
+        for (uint32_t k = have_p ? 1 : 0; k < c->size; ++k)
+        {
+            uint32_t v = lit_var(lits[k]);
+            if (s->seen[v] || s->level[v] == 0)
+                continue;
+            s->seen[v] = 1;
+            bump_var(s, v);
+            if (s->level[v] >= s->level_num)
+                path++;
+            else
+                s->learnt[size++] = lits[k];
+        }
+        // next literal of the current level on the trail
+        while (!s->seen[lit_var(s->trail[index - 1])])
+            index--;
+        p = s->trail[--index];
+        have_p = true;
+        confl = s->reason[lit_var(p)];
+        s->seen[lit_var(p)] = 0;
+        path--;
+    } while (path > 0);
+    s->learnt[0] = lit_neg(p);
+
+    // drop literals implied by the rest of the clause
+    // (kept literals are swapped to the front so every original one is still there to clear)
+    uint32_t kept = 1;
+    for (uint32_t k = 1; k < size; ++k)
+    {
+        if (!lit_redundant(s, s->learnt[k]))
+        {
+            Lit tmp = s->learnt[kept];
+            s->learnt[kept++] = s->learnt[k];
+            s->learnt[k] = tmp;
+        }
+    }
+    for (uint32_t k = 1; k < size; ++k)
+        s->seen[lit_var(s->learnt[k])] = 0;
+    size = kept;
+
+    // backjump level: the highest level after the asserting one, moved to learnt[1]
+    uint32_t level = 0;
+    for (uint32_t k = 1; k < size; ++k)
+    {
+        uint32_t lv = s->level[lit_var(s->learnt[k])];
+        if (lv > level)
+        {
+            level = lv;
+            Lit tmp = s->learnt[1];
+            s->learnt[1] = s->learnt[k];
+            s->learnt[k] = tmp;
+        }
+    }
+
+    // literal block distance: number of distinct decision levels
+    s->stamp++;
+    uint32_t lbd = 0;
+    for (uint32_t k = 0; k < size; ++k)
+    {
+        uint32_t lv = s->level[lit_var(s->learnt[k])];
+        if (s->level_stamp[lv] != s->stamp)
+        {
+            s->level_stamp[lv] = s->stamp;
+            lbd++;
+        }
+    }
+    *out_level = level;
+    *out_lbd = lbd;
+    return size;
+}
+
+// a learnt clause considered for removal
+typedef struct ReduceCand
+{
+    uint32_t lbd;
+    uint32_t clause;
+} ReduceCand;
+
+// worst (highest LBD) first; older clauses first among equals
+static int cmp_removal(const void *a, const void *b)
+{
+    const ReduceCand *ca = a;
+    const ReduceCand *cb = b;
+    if (ca->lbd != cb->lbd)
+        return ca->lbd < cb->lbd ? 1 : -1;
+    return (ca->clause > cb->clause) - (ca->clause < cb->clause);
+}
+
+// remove about half of the learnt clauses; only called at decision level 0
+static bool reduce_learnts(SatSolver *s)
+{
+    size_t cand_num = 0;
+    ReduceCand *cands = malloc((s->learnt_num > 0 ? s->learnt_num : 1) * sizeof(ReduceCand));
+    if (!cands)
+        return false;
+    for (size_t i = 0; i < s->clause_num; ++i)
+    {
+        const Clause *c = s->clauses + i;
+        if (c->learnt && !c->deleted && c->lbd > GLUE_KEEP)
+        {
+            cands[cand_num].lbd = c->lbd;
+            cands[cand_num].clause = (uint32_t)i;
+            cand_num++;
+        }
+    }
+    qsort(cands, cand_num, sizeof(ReduceCand), cmp_removal);
+    for (size_t i = 0; i < cand_num / 2; ++i)
+        s->clauses[cands[i].clause].deleted = true;
+    free(cands);
+
+    // compact the arena and the clause list; level-0 reasons are never analyzed, so drop them
+    for (size_t i = 0; i < s->trail_size; ++i)
+        s->reason[lit_var(s->trail[i])] = CLAUSE_NONE;
+    size_t out = 0;
+    size_t arena_out = 0;
+    s->learnt_num = 0;
+    for (size_t i = 0; i < s->clause_num; ++i)
+    {
+        Clause c = s->clauses[i];
+        if (c.deleted)
+            continue;
+        memmove(s->arena + arena_out, s->arena + c.start, c.size * sizeof(Lit));
+        c.start = arena_out;
+        arena_out += c.size;
+        s->clauses[out++] = c;
+        if (c.learnt)
+            s->learnt_num++;
+    }
+    s->clause_num = out;
+    s->arena_size = arena_out;
+
+    // watches always sit on lits[0] and lits[1], so rebuilding restores the same scheme
+    for (size_t l = 0; l < 2 * (size_t)s->var_num; ++l)
+        s->watches[l].size = 0;
+    for (size_t i = 0; i < s->clause_num; ++i)
+    {
+        const Lit *lits = s->arena + s->clauses[i].start;
+        if (!watch_push(s->watches + lits[0], (uint32_t)i, lits[1]) ||
+            !watch_push(s->watches + lits[1], (uint32_t)i, lits[0]))
+            return false;
+    }
+    return true;
+}
+
+// Luby sequence 1,1,2,1,1,2,4,... for i >= 1
+static uint64_t luby(uint64_t i)
+{
+    while (true)
+    {
+        unsigned k = 1;
+        while (k < 63 && ((UINT64_C(1) << k) - 1) < i)
+            k++;
+        if (i == (UINT64_C(1) << k) - 1)
+            return UINT64_C(1) << (k - 1);
+        i -= (UINT64_C(1) << (k - 1)) - 1;
+    }
+}
+
+SatSolver *sat_create(int var_num)
+{
+    if (var_num < 0)
+        return NULL;
+    SatSolver *s = calloc(1, sizeof(SatSolver));
+    if (!s)
+        return NULL;
+    s->var_inc = 1.0;
+    uint32_t cap = (uint32_t)var_num > INITIAL_VAR_CAP ? (uint32_t)var_num : INITIAL_VAR_CAP;
+    if (!grow_vars(s, cap))
+    {
+        sat_destroy(s);
+        return NULL;
+    }
+    for (int i = 0; i < var_num; ++i)
+    {
+        if (sat_new_var(s) == 0)
+        {
+            sat_destroy(s);
+            return NULL;
+        }
+    }
+    return s;
+}
+
+void sat_destroy(SatSolver *s)
+{
+    if (!s)
+        return;
+    if (s->watches)
+    {
+        for (size_t l = 0; l < 2 * (size_t)s->var_cap; ++l)
+            free(s->watches[l].items);
+    }
+    free(s->vals);
+    free(s->phase);
+    free(s->level);
+    free(s->reason);
+    free(s->activity);
+    free(s->seen);
+    free(s->level_stamp);
+    free(s->heap);
+    free(s->heap_pos);
+    free(s->trail);
+    free(s->trail_lim);
+    free(s->learnt);
+    free(s->watches);
+    free(s->clauses);
+    free(s->arena);
+    free(s);
+}
+
+int sat_new_var(SatSolver *s)
+{
+    if (!s || s->var_num >= (uint32_t)INT_MAX)
+        return 0;
+    if (s->var_num == s->var_cap && !grow_vars(s, s->var_cap * 2))
+        return 0;
+    uint32_t v = s->var_num++;
+    s->vals[v] = 0;
+    s->phase[v] = -1; // exactly-one encodings: most variables end up false
+    s->level[v] = 0;
+    s->reason[v] = CLAUSE_NONE;
+    s->activity[v] = 0.0;
+    s->seen[v] = 0;
+    s->heap_pos[v] = -1;
+    heap_insert(s, v);
+    return (int)v + 1;
+}
+
+int sat_var_count(const SatSolver *s)
+{
+    return s ? (int)s->var_num : 0;
+}
+
+StatusCode sat_add_clause(SatSolver *s, const int *lits, size_t lit_num)
+{
+    if (!s || (!lits && lit_num > 0))
+        return STATUS_ERR_INVALID_ARGUMENT;
+    if (s->unsat)
+        return STATUS_OK;
+    Lit *buf = malloc((lit_num > 0 ? lit_num : 1) * sizeof(Lit));
+    if (!buf)
+        return STATUS_ERR_MEMORY;
+
+    // normalize: drop duplicates and level-0 false literals; skip tautologies and satisfied clauses
+    uint32_t size = 0;
+    bool satisfied = false;
+    for (size_t i = 0; i < lit_num && !satisfied; ++i)
+    {
+        int d = lits[i];
+        if (d == 0 || d == INT_MIN || (uint32_t)(d < 0 ? -d : d) > s->var_num)
+        {
+            free(buf);
+            return STATUS_ERR_INVALID_ARGUMENT;
+        }
+        Lit l = (Lit)(2 * ((uint32_t)(d < 0 ? -d : d) - 1) + (d < 0 ? 1u : 0u));
+        int val = lit_value(s, l);
+        if (val > 0)
+        {
+            satisfied = true;
+            break;
+        }
+        if (val < 0)
+            continue;
+        bool dup = false;
+        for (uint32_t k = 0; k < size; ++k)
+        {
+            if (buf[k] == l)
+                dup = true;
+            else if (buf[k] == lit_neg(l))
+                satisfied = true;
+        }
+        if (!dup)
+            buf[size++] = l;
+    }
+
+    StatusCode res = STATUS_OK;
+    if (satisfied)
+        res = STATUS_OK;
+    else if (size == 0)
+        s->unsat = true;
+    else if (size == 1)
+        assign(s, buf[0], CLAUSE_NONE);
+    else if (attach_clause(s, buf, size, false, 0) == CLAUSE_NONE)
+        res = STATUS_ERR_MEMORY;
+    free(buf);
+    return res;
+}
+
+void sat_set_conflict_limit(SatSolver *s, uint64_t limit)
+{
+    if (s)
+        s->conflict_limit = limit;
+}
+
+SatResult sat_solve(SatSolver *s)
+{
+    if (!s)
+        return SAT_ERROR;
+    if (s->unsat || propagate(s) != CLAUSE_NONE)
+    {
+        s->unsat = true;
+        return SAT_UNSATISFIABLE;
+    }
+
+    uint64_t restart_index = 1;
+    uint64_t restart_limit = luby(restart_index) * RESTART_UNIT;
+    uint64_t conflicts_here = 0;
+    size_t max_learnts = REDUCE_FIRST;
+    while (true)
+    {
+        uint32_t confl = propagate(s);
+        if (s->oom)
+            return SAT_ERROR;
+        if (confl != CLAUSE_NONE)
+        {
+            s->stats.conflicts++;
+            conflicts_here++;
+            if (s->level_num == 0)
+            {
+                s->unsat = true;
+                return SAT_UNSATISFIABLE;
+            }
+            if (s->conflict_limit != 0 && s->stats.conflicts >= s->conflict_limit)
+            {
+                backtrack(s, 0);
+                return SAT_UNKNOWN;
+            }
+            uint32_t level = 0;
+            uint32_t lbd = 0;
+            uint32_t size = analyze(s, confl, &level, &lbd);
+            backtrack(s, level);
+            if (size == 1)
+            {
+                assign(s, s->learnt[0], CLAUSE_NONE);
+            }
+            else
+            {
+                uint32_t idx = attach_clause(s, s->learnt, size, true, lbd);
+                if (idx == CLAUSE_NONE)
+                    return SAT_ERROR;
+                s->learnt_num++;
+                assign(s, s->learnt[0], idx);
+            }
+            s->var_inc /= VAR_DECAY;
+            continue;
+        }
+
+        if (conflicts_here >= restart_limit)
+        {
+            s->stats.restarts++;
+            conflicts_here = 0;
+            restart_limit = luby(++restart_index) * RESTART_UNIT;
+            backtrack(s, 0);
+            if (s->learnt_num >= max_learnts)
+            {
+                if (!reduce_learnts(s))
+                    return SAT_ERROR;
+                max_learnts += REDUCE_GROWTH;
+            }
+            continue;
+        }
+
+        // decide on the most active unassigned variable, with its saved phase
+        uint32_t next = UINT32_MAX;
+        while (s->heap_size > 0)
+        {
+            uint32_t v = heap_pop(s);
+            if (s->vals[v] == 0)
+            {
+                next = v;
+                break;
+            }
+        }
+        if (next == UINT32_MAX)
+            return SAT_SATISFIABLE; // every variable assigned without conflict
+        s->stats.decisions++;
+        s->trail_lim[s->level_num++] = s->trail_size;
+        assign(s, 2 * next + (s->phase[next] > 0 ? 0u : 1u), CLAUSE_NONE);
+    }
+}
+
+bool sat_model_value(const SatSolver *s, int var)
+{
+    if (!s || var <= 0 || (uint32_t)var > s->var_num)
+        return false;
+    return s->vals[var - 1] > 0;
+}
+
+void sat_stats(const SatSolver *s, SatStats *out)
+{
+    if (!s || !out)
+        return;
+    *out = s->stats;
+    out->learnts = s->learnt_num;
+}
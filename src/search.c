@@ -0,0 +1,657 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "search.h"
+#include "fit.h"
+#include "progress.h"
+
+/* Search engine implementation:
+ *   - Explicit frame stack; each frame tries its candidates in order.
+ *   - Candidates are pre-filtered by the fit kernel, so every frame holds only placements that fit.
+ *   - In cover mode each orientation is anchored so that its first cell lands on the target cell.
+ *   - Optional candidate shuffling, node limits and cancellation for restarts/portfolios.
+ *   - Endgame table lookups once the residual region is small. */
+
+#define SOLVER_FRAME_SIZE sizeof(SolverFrame)
+#define SOLVER_STACK_SIZE sizeof(SolverStack)
+#define MARK_NUM 26 // 26 letters from A-Z
+#define CANCEL_POLL_MASK 1023u // poll the cancel flag every 1024 nodes
+#define RNG_FALLBACK_STATE 0x9E3779B97F4A7C15ULL
+
+// create stack
+static inline SolverStack *create_stack(size_t max_frame_num)
+{
+    // guard against overflow in allocation size
+    if (max_frame_num > 0 && max_frame_num > (SIZE_MAX - SOLVER_STACK_SIZE) / SOLVER_FRAME_SIZE)
+        return NULL;
+    size_t bytes = SOLVER_STACK_SIZE + max_frame_num * SOLVER_FRAME_SIZE;
+    SolverStack *stack = calloc(1, bytes);
+    if (!stack)
+        return NULL;
+    stack->capacity = max_frame_num;
+    stack->top = -1;
+    return stack;
+}
+
+// destroy stack
+static inline void destroy_stack(SolverStack *stack)
+{
+    if (!stack)
+        return;
+    free(stack);
+}
+
+// stack empty or not
+static inline bool stack_is_empty(SolverStack *stack)
+{
+    return stack->top == -1;
+}
+
+// stack full or not
+static inline bool stack_is_full(SolverStack *stack)
+{
+    return stack->top == (int)stack->capacity - 1;
+}
+
+// undo the placement represented by the current top frame (if any)
+static inline bool undo_top_placement(Board *board,
+                                      SolverStack *stack,
+                                      size_t counts[TETRO_TYPE_COUNT],
+                                      size_t *filled_cells)
+{
+    if (stack_is_empty(stack))
+        return false;
+    SolverFrame *frame = stack->frames + stack->top;
+    if (frame->idx < 0)
+        return false; // nothing placed at this frame yet
+    Placement *prev_placement = frame->cands + frame->idx;
+    board_remove(board, prev_placement->x, prev_placement->y, prev_placement->type, prev_placement->rotation);
+    counts[prev_placement->type]++;
+    if (*filled_cells >= 4)
+        *filled_cells -= 4;
+    return true;
+}
+
+// push a new frame to stack
+static inline StatusCode push_frame(size_t cands_size, Placement *cands, SolverStack *stack)
+{
+    if (!cands)
+        return STATUS_ERR_MEMORY;
+
+    if (stack_is_full(stack))
+        return STATUS_ERR_MEMORY;
+
+    stack->top++;
+    SolverFrame *frame = stack->frames + stack->top;
+    frame->cands_size = cands_size;
+    frame->idx = -1;
+    memcpy(frame->cands, cands, cands_size * PLACEMENT_SIZE);
+    return STATUS_OK;
+}
+
+// pop a frame from stack, return top frame after popping
+static inline SolverFrame *pop_frame(SolverStack *stack)
+{
+    if (!stack)
+        return NULL;
+    if (stack->top == -1)
+        return NULL; // already empty
+    stack->top--;
+    if (stack->top == -1)
+        return NULL;                   // no previous frame
+    return stack->frames + stack->top; // new top (previous frame)
+}
+
+// xorshift64* step
+static inline uint64_t rng_next(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+// Fisher-Yates shuffle of a candidate list
+static inline void shuffle_candidates(Placement *cands, size_t cands_size, uint64_t *rng)
+{
+    for (size_t i = cands_size; i > 1; --i)
+    {
+        size_t j = (size_t)(rng_next(rng) % i);
+        Placement tmp = cands[i - 1];
+        cands[i - 1] = cands[j];
+        cands[j] = tmp;
+    }
+}
+
+// first fit-kernel orientation index of each type (orientations are type-major)
+static const size_t ORIENTATION_BASE[TETRO_TYPE_COUNT] = {0, 2, 3, 7, 9, 11, 15};
+
+/* cover mode: orientations by the column of their first cell (in row-major order) within the bounding box;
+ * to cover the target cell such an orientation is anchored that many cells to its left */
+#define COVER_SHIFT_NUM 3
+static const uint32_t COVER_MASKS[COVER_SHIFT_NUM] = {
+    FIT_ALL & ~0xC4B0u, // the rest: the top-left cell of the box
+    0x44B0u,            // T1, T2, S0, Z1, J3
+    0x8000u,            // L0
+};
+
+// how far left of the target cell an orientation is anchored in cover mode
+static inline int cover_shift(size_t orientation)
+{
+    for (int shift = 1; shift < COVER_SHIFT_NUM; ++shift)
+    {
+        if (COVER_MASKS[shift] >> orientation & 1u)
+            return shift;
+    }
+    return 0;
+}
+
+// value-ordering policies: a rank per type, lower ranks are tried first and ties keep enum order
+typedef size_t (*OrderRank)(TetrominoType type, const size_t *counts, uint32_t fits);
+
+static size_t rank_by_type(TetrominoType type, const size_t *counts, uint32_t fits)
+{
+    (void)counts;
+    (void)fits;
+    return (size_t)type;
+}
+
+static size_t rank_by_scarcity(TetrominoType type, const size_t *counts, uint32_t fits)
+{
+    (void)fits;
+    return counts[type];
+}
+
+// fewest fitting orientations here first, then the scarcer type
+static size_t rank_by_fits(TetrominoType type, const size_t *counts, uint32_t fits)
+{
+    uint32_t mask = ((1u << tetro_rotation_count(type)) - 1u) << ORIENTATION_BASE[type];
+    size_t fit_num = (size_t)__builtin_popcount(fits & mask);
+    size_t scarcity = counts[type] < SIZE_MAX / 8 ? counts[type] : SIZE_MAX / 8 - 1;
+    return fit_num * (SIZE_MAX / 8) + scarcity;
+}
+
+static const OrderRank ORDER_RANKS[SEARCH_ORDER_NUM] = {rank_by_type, rank_by_scarcity, rank_by_fits};
+static const char *const ORDER_NAMES[SEARCH_ORDER_NUM] = {"type", "scarce", "fits"};
+
+// append the fitting rotations of one type to out_cands (shifted left of (x,y) in cover mode)
+static inline size_t append_type(TetrominoType type, uint32_t fits, int x, int y, char mark, bool cover,
+                                 Placement *out_cands, size_t idx)
+{
+    size_t rotation_count = tetro_rotation_count(type);
+    size_t orientation = ORIENTATION_BASE[type];
+    for (size_t rot = 0; rot < rotation_count; ++rot)
+    {
+        if (idx < CANDS_MAX_SIZE && (fits >> (orientation + rot) & 1u))
+        {
+            Placement *cand = out_cands + idx;
+            cand->type = type;
+            cand->rotation = rot;
+            cand->x = cover ? x - cover_shift(orientation + rot) : x;
+            cand->y = y;
+            cand->mark = mark;
+            idx++;
+        }
+    }
+    return idx;
+}
+
+// orientations anchored at (x,y) that fit the board and the static index (NULL: no index)
+static inline uint32_t anchor_fits(const Board *board, int x, int y, const uint32_t *static_fits)
+{
+    // one window load and one kernel call decide all orientations, so no candidate fails board_place later;
+    // an anchor the static index rules out entirely skips the window load
+    uint32_t allowed = static_fits ? static_fits[(size_t)y * (size_t)board_width(board) + (size_t)x] : FIT_ALL;
+    return allowed ? allowed & fit_orientations(board_window_mask(board, x, y)) : 0;
+}
+
+// generate the candidate placements at cell that fit the board, types in the given order
+static inline size_t generate_candidates(const Board *board, int x, int y, char mark, const size_t *counts,
+                                         SearchOrder order, const uint32_t *static_fits, bool cover,
+                                         Placement *out_cands)
+{
+    uint32_t fits = anchor_fits(board, x, y, static_fits);
+    if (cover)
+    {
+        // one more window per shift: the orientations whose first cell lies that far right of their anchor
+        fits &= COVER_MASKS[0];
+        for (int shift = 1; shift < COVER_SHIFT_NUM && shift <= x; ++shift)
+            fits |= anchor_fits(board, x - shift, y, static_fits) & COVER_MASKS[shift];
+    }
+    TetrominoType types[TETRO_TYPE_COUNT];
+    size_t ranks[TETRO_TYPE_COUNT];
+    size_t type_num = 0;
+    for (TetrominoType type = 0; type < TETRO_TYPE_COUNT; ++type)
+    {
+        if (counts[type] == 0)
+            continue;
+        // insertion by rank; equal ranks stay in enum order
+        size_t rank = order == SEARCH_ORDER_TYPE ? (size_t)type : ORDER_RANKS[order](type, counts, fits);
+        size_t i = type_num++;
+        for (; i > 0 && ranks[i - 1] > rank; --i)
+        {
+            types[i] = types[i - 1];
+            ranks[i] = ranks[i - 1];
+        }
+        types[i] = type;
+        ranks[i] = rank;
+    }
+
+    size_t idx = 0;
+    for (size_t i = 0; i < type_num; ++i)
+        idx = append_type(types[i], fits, x, y, mark, cover, out_cands, idx);
+    return idx;
+}
+
+// frame has remaining candidates or not
+static inline bool has_candidate(SolverFrame *frame)
+{
+    return frame->idx + 1 < (int)frame->cands_size;
+}
+
+// find next empty cell on board
+static inline Cell find_next_empty(const Board *board)
+{
+    Cell cell = {-1, -1};
+    int H = board_height(board);
+    int W = board_width(board);
+    for (int y = 0; y < H; ++y)
+    {
+        for (int x = 0; x < W; ++x)
+        {
+            if (board_is_empty(board, x, y))
+            {
+                cell.x = x;
+                cell.y = y;
+                return cell;
+            }
+        }
+    }
+    return cell;
+}
+
+// get mark based on index in stack
+static inline char mark_at(int depth)
+{
+    return (char)('A' + (depth % MARK_NUM));
+}
+
+// push the endgame tiling as single-candidate frames and apply it to the board
+static StatusCode push_endgame_tail(SearchContext *ctx, Placement *tail, size_t tail_num)
+{
+    SolverStack *stack = ctx->stack;
+    for (size_t i = 0; i < tail_num; ++i)
+    {
+        Placement *p = tail + i;
+        p->mark = mark_at(stack->top + 1);
+        StatusCode res = push_frame(1, p, stack);
+        if (res != STATUS_OK)
+            return res;
+        stack->frames[stack->top].idx = 0;
+        if (!board_place(ctx->board, p->x, p->y, p->type, p->rotation, p->mark))
+            return STATUS_ERR_INVALID_ARGUMENT; // table and board disagree; should not happen
+        ctx->counts[p->type]--;
+        ctx->filled_cells += 4;
+    }
+    return STATUS_OK;
+}
+
+/* Per-cell orientations that fit the board as it is at init. Cells filled then stay filled for the whole
+ * search, so a placement ruled out here is never possible later. STATUS_ERR_UNSOLVABLE (and nothing
+ * allocated) if some empty cell is not covered by any of them. */
+static StatusCode build_static_fits(const Board *board, uint32_t **out_fits)
+{
+    *out_fits = NULL;
+    int W = board_width(board);
+    int H = board_height(board);
+    size_t cells = board_cell_count(board);
+    uint32_t *fits = malloc(cells * sizeof(uint32_t));
+    bool *covered = calloc(cells, sizeof(bool));
+    if (!fits || !covered)
+    {
+        free(fits);
+        free(covered);
+        return STATUS_ERR_MEMORY;
+    }
+    for (int y = 0; y < H; ++y)
+    {
+        for (int x = 0; x < W; ++x)
+        {
+            size_t idx = (size_t)y * (size_t)W + (size_t)x;
+            fits[idx] = fit_orientations(board_window_mask(board, x, y));
+            for (TetrominoType type = 0; type < TETRO_TYPE_COUNT; ++type)
+            {
+                for (size_t rot = 0; rot < tetro_rotation_count(type); ++rot)
+                {
+                    if (!(fits[idx] >> (ORIENTATION_BASE[type] + rot) & 1u))
+                        continue;
+                    Cell shape[4];
+                    size_t n = tetro_get_cells(type, rot, shape);
+                    for (size_t i = 0; i < n; ++i)
+                        covered[(size_t)(y + shape[i].y) * (size_t)W + (size_t)(x + shape[i].x)] = true;
+                }
+            }
+        }
+    }
+    StatusCode res = STATUS_OK;
+    for (int y = 0; y < H && res == STATUS_OK; ++y)
+    {
+        for (int x = 0; x < W; ++x)
+        {
+            if (board_is_empty(board, x, y) && !covered[(size_t)y * (size_t)W + (size_t)x])
+            {
+                res = STATUS_ERR_UNSOLVABLE; // an isolated pocket: no piece can ever fill it
+                break;
+            }
+        }
+    }
+    free(covered);
+    if (res != STATUS_OK)
+    {
+        free(fits);
+        return res;
+    }
+    *out_fits = fits;
+    return STATUS_OK;
+}
+
+StatusCode search_init(SearchContext *ctx, Board *board, const TetrominoBag *bag, EndgameTable *endgame)
+{
+    if (!ctx || !board || !bag)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    memset(ctx, 0, sizeof(*ctx));
+    if (bag->total > SIZE_MAX / 4 || bag->total > (size_t)INT_MAX)
+        return STATUS_ERR_INVALID_ARGUMENT;
+
+    // compute initial filled cells once; the pieces must cover exactly the rest
+    size_t board_cells = board_cell_count(board);
+    size_t filled_cells = board_filled_count(board);
+    if (filled_cells > board_cells || board_cells - filled_cells != bag->total * 4)
+        return STATUS_ERR_UNSOLVABLE;
+
+    if (board_blocked_count(board) > 0)
+    {
+        StatusCode res = build_static_fits(board, &ctx->static_fits);
+        if (res != STATUS_OK)
+            return res;
+    }
+    ctx->stack = create_stack(bag->total);
+    if (!ctx->stack)
+    {
+        free(ctx->static_fits);
+        ctx->static_fits = NULL;
+        return STATUS_ERR_MEMORY;
+    }
+    ctx->endgame = endgame;
+    ctx->board = board;
+    memcpy(ctx->counts, bag->counts, sizeof(ctx->counts));
+    ctx->filled_cells = filled_cells;
+    ctx->target_cells = board_cells;
+    ctx->need_new_frame = true;
+    ctx->rng = RNG_FALLBACK_STATE;
+    ctx->error = STATUS_OK;
+    return STATUS_OK;
+}
+
+void search_release(SearchContext *ctx)
+{
+    if (!ctx)
+        return;
+    destroy_stack(ctx->stack);
+    free(ctx->static_fits);
+    ctx->stack = NULL;
+    ctx->endgame = NULL;
+    ctx->static_fits = NULL;
+}
+
+Cell search_next_empty(const Board *board)
+{
+    Cell none = {-1, -1};
+    return board ? find_next_empty(board) : none;
+}
+
+size_t search_candidates(const Board *board, int x, int y, char mark, const size_t *counts, bool cover,
+                         Placement *out_cands)
+{
+    if (!board || !counts || !out_cands)
+        return 0;
+    return generate_candidates(board, x, y, mark, counts, SEARCH_ORDER_TYPE, NULL, cover, out_cands);
+}
+
+double search_explored(const SearchContext *ctx)
+{
+    double explored = 0.0;
+    double share = 1.0;
+    if (!ctx || !ctx->stack)
+        return explored;
+    // a frame's cursor points at the candidate being searched: idx siblings before it are finished
+    for (int i = ctx->floor; i <= ctx->stack->top; ++i)
+    {
+        const SolverFrame *frame = ctx->stack->frames + i;
+        progress_descend(&explored, &share, frame->idx > 0 ? (size_t)frame->idx : 0, frame->cands_size);
+    }
+    return explored;
+}
+
+const char *search_order_name(SearchOrder order)
+{
+    return (unsigned)order < SEARCH_ORDER_NUM ? ORDER_NAMES[order] : "";
+}
+
+SearchOrder search_order_from_name(const char *name)
+{
+    for (size_t i = 0; name && i < SEARCH_ORDER_NUM; ++i)
+    {
+        if (strcmp(name, ORDER_NAMES[i]) == 0)
+            return (SearchOrder)i;
+    }
+    return SEARCH_ORDER_NUM;
+}
+
+void search_seed(SearchContext *ctx, uint64_t seed)
+{
+    if (!ctx)
+        return;
+    ctx->rng = seed != 0 ? seed : RNG_FALLBACK_STATE;
+}
+
+void search_unwind(SearchContext *ctx)
+{
+    if (!ctx || !ctx->stack)
+        return;
+    // frames below a freshly expanded top are all placed; a top with idx < 0 has nothing to undo
+    while (ctx->stack->top >= ctx->floor)
+    {
+        undo_top_placement(ctx->board, ctx->stack, ctx->counts, &ctx->filled_cells);
+        pop_frame(ctx->stack);
+    }
+    ctx->need_new_frame = true;
+}
+
+bool search_backtrack(SearchContext *ctx)
+{
+    if (!ctx || !ctx->stack || ctx->stack->top < ctx->floor)
+        return false;
+    if (!undo_top_placement(ctx->board, ctx->stack, ctx->counts, &ctx->filled_cells))
+        return false;
+    ctx->need_new_frame = false;
+    return true;
+}
+
+// a stored candidate must have a known shape, a piece left of its type and fit the board as it is now
+static bool candidate_valid(const SearchContext *ctx, const Placement *p)
+{
+    if ((unsigned)p->type >= TETRO_TYPE_COUNT || p->rotation >= tetro_rotation_count(p->type) ||
+        ctx->counts[p->type] == 0)
+        return false;
+    if (!board_in_bounds(ctx->board, p->x, p->y))
+        return false;
+    Cell cells[4];
+    size_t cell_num = tetro_get_cells(p->type, p->rotation, cells);
+    for (size_t i = 0; i < cell_num; ++i)
+    {
+        if (!board_is_empty(ctx->board, p->x + cells[i].x, p->y + cells[i].y))
+            return false;
+    }
+    return cell_num == 4;
+}
+
+StatusCode search_push_placed(SearchContext *ctx, const SolverFrame *frame)
+{
+    if (!ctx || !ctx->stack || !frame)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    if (frame->cands_size == 0 || frame->cands_size > CANDS_MAX_SIZE ||
+        frame->idx < 0 || (size_t)frame->idx >= frame->cands_size)
+        return STATUS_ERR_INPUT;
+    // every candidate, not only the placed one: the search moves on to the others when it backtracks
+    for (size_t i = 0; i < frame->cands_size; ++i)
+    {
+        if (!candidate_valid(ctx, frame->cands + i))
+            return STATUS_ERR_INPUT;
+    }
+    const Placement *p = frame->cands + frame->idx;
+    if (stack_is_full(ctx->stack))
+        return STATUS_ERR_INPUT;
+    if (!board_place(ctx->board, p->x, p->y, p->type, p->rotation, p->mark))
+        return STATUS_ERR_INPUT;
+
+    ctx->stack->top++;
+    memcpy(ctx->stack->frames + ctx->stack->top, frame, SOLVER_FRAME_SIZE);
+    ctx->counts[p->type]--;
+    ctx->filled_cells += 4;
+    ctx->need_new_frame = true;
+    return STATUS_OK;
+}
+
+size_t search_placements(const SearchContext *ctx, Placement *out)
+{
+    if (!ctx || !ctx->stack || !out)
+        return 0;
+    size_t n = (size_t)(ctx->stack->top + 1);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const SolverFrame *frame = ctx->stack->frames + i;
+        memcpy(out + i, frame->cands + frame->idx, PLACEMENT_SIZE);
+    }
+    return n;
+}
+
+SearchOutcome search_run(SearchContext *ctx)
+{
+    Board *board = ctx->board;
+    SolverStack *stack = ctx->stack;
+
+    // iterative backtracking
+    while (true)
+    {
+        // 1) terminate, solved
+        if (ctx->filled_cells == ctx->target_cells)
+            return SEARCH_SOLVED;
+
+        // 2) need to push new frame
+        if (ctx->need_new_frame)
+        {
+            if (ctx->depth_limit > 0 && stack->top + 1 >= ctx->depth_limit)
+                return SEARCH_DEPTH_LIMIT;
+            Cell pos = find_next_empty(board);
+
+            // small residual region: one table lookup replaces the last levels of the search (the table
+            // tries types in enum order with anchored candidates, so other orders would get a tiling their
+            // search does not find first, and a cover search could be cut where its own search succeeds)
+            EndgameResult endgame_res = ENDGAME_SKIP;
+            size_t remaining_cells = ctx->target_cells - ctx->filled_cells;
+            if (remaining_cells <= ENDGAME_MAX_CELLS && ctx->order == SEARCH_ORDER_TYPE && !ctx->cover)
+            {
+                Placement tail[ENDGAME_MAX_PIECES];
+                size_t tail_num = 0;
+                endgame_res = endgame_probe(ctx->endgame, board, pos, ctx->counts, remaining_cells, tail, &tail_num);
+                if (endgame_res == ENDGAME_TILEABLE)
+                {
+                    StatusCode res = push_endgame_tail(ctx, tail, tail_num);
+                    if (res != STATUS_OK)
+                    {
+                        ctx->error = res;
+                        return SEARCH_ERROR;
+                    }
+                    continue; // step 1 reports the solution
+                }
+            }
+
+            char mark = mark_at(stack->top + 1);
+            Placement cands[CANDS_MAX_SIZE];
+            size_t cands_size = 0;
+            if (endgame_res != ENDGAME_DEAD)
+                cands_size = generate_candidates(board, pos.x, pos.y, mark, ctx->counts, ctx->order,
+                                                 ctx->static_fits, ctx->cover, cands);
+            if (cands_size == 0)
+            {
+                // No candidates for next cell: undo the placement at current top frame
+                if (stack->top < ctx->floor ||
+                    !undo_top_placement(board, stack, ctx->counts, &ctx->filled_cells))
+                    return SEARCH_EXHAUSTED; // nothing to undo => unsolvable
+                ctx->need_new_frame = false;
+                continue;
+            }
+            if (ctx->randomize)
+                shuffle_candidates(cands, cands_size, &ctx->rng);
+            StatusCode res = push_frame(cands_size, cands, stack);
+            if (res != STATUS_OK)
+            {
+                ctx->error = res;
+                return SEARCH_ERROR;
+            }
+            ctx->need_new_frame = false;
+        }
+
+        // 3) try next candidate in the current frame
+        SolverFrame *top_frame = stack->frames + stack->top;
+        if (has_candidate(top_frame))
+        {
+            top_frame->idx++;
+            ctx->nodes++;
+            Placement *cand = top_frame->cands + top_frame->idx;
+            if (board_place(board, cand->x, cand->y, cand->type, cand->rotation, cand->mark))
+            {
+                ctx->counts[cand->type]--;
+                ctx->filled_cells += 4;
+                ctx->need_new_frame = true;
+                if (ctx->prune && ctx->prune(ctx, ctx->prune_arg))
+                {
+                    // the caller has no use for this subtree: take the placement back and move on
+                    undo_top_placement(board, stack, ctx->counts, &ctx->filled_cells);
+                    ctx->need_new_frame = false;
+                    continue;
+                }
+
+                // stop only here, where every frame on the stack is placed
+                if (ctx->node_limit != 0 && ctx->nodes >= ctx->node_limit)
+                    return SEARCH_NODE_LIMIT;
+                if (ctx->yield_interval != 0 && ctx->nodes % ctx->yield_interval == 0)
+                    return SEARCH_YIELD;
+                if (ctx->cancel && (ctx->nodes & CANCEL_POLL_MASK) == 0 &&
+                    atomic_load_explicit(ctx->cancel, memory_order_relaxed))
+                    return SEARCH_CANCELLED;
+                if (ctx->progress && *ctx->progress)
+                    return SEARCH_YIELD;
+            }
+            continue;
+        }
+
+        // 4) current frame exhausted, backtrack
+        SolverFrame *prev_frame = pop_frame(stack);
+        if (prev_frame != NULL)
+        {
+            // child frame removed; undo placement at new top (the parent) unless it is fixed
+            if (stack->top < ctx->floor ||
+                !undo_top_placement(board, stack, ctx->counts, &ctx->filled_cells))
+                return SEARCH_EXHAUSTED;
+            ctx->need_new_frame = false;
+            continue;
+        }
+
+        // unsolvable
+        return SEARCH_EXHAUSTED;
+    }
+}
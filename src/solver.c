@@ -1,297 +1,1115 @@
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
 #include "solver.h"
+#include "search.h"
+#include "construct.h"
+#include "regions.h"
+#include "checkpoint.h"
+#include "bitkernel.h"
+#include "cnf.h"
+#include "progress.h"
 #include "tetromino.h"
 
 /* Solver implementation:
  *   - Organize try order and intermediate state for backtracking.
  *   - Return the first full tiling via out_list.
- *   - Return UNSOLVABLE when coverage cannot be achieved. */
+ *   - Return UNSOLVABLE when coverage cannot be achieved.
+ *   - Randomized searches restart on a Luby schedule; a portfolio runs several on threads.
+ *   - Deterministic parallel solves hand out ordered subtrees and keep the leftmost solution.
+ *   - Long searches can be checkpointed periodically and resumed.
+ *   - Plain sequential solves on boards up to BITKERNEL_MAX_WIDTH wide run on a width-specialized kernel.
+ *   - Progress requests (progress.h) are answered between search_run calls.
+ *   - The SAT engine encodes the instance as CNF and runs the built-in CDCL solver instead, handing over
+ *     to the backtracking search if it runs out of its conflict budget.
+ *   - Boards whose empty cells form several regions are split and solved region by region.
+ *   - Wide boards are searched transposed, so the first-empty-cell frontier runs along the short side.
+ *   - Iterators keep one plain search alive and step it from solution to solution. */
 
-#define SOLVER_FRAME_SIZE sizeof(SolverFrame)
-#define SOLVER_STACK_SIZE sizeof(SolverStack)
-#define MARK_NUM 26 // 26 letters from A-Z
+#define LUBY_MAX_UNIT (UINT64_C(1) << 62)
+#define CHECKPOINT_YIELD_NODES (UINT64_C(1) << 16) // check the clock every 65536 nodes
+#define ORDERED_UNITS_PER_THREAD 16 // subtrees per thread a deterministic split aims for
+#define ORDERED_MAX_UNITS (1u << 16) // never split finer than this many subtrees
+#define SAT_CONFLICT_LIMIT 100000 // conflicts before the SAT engine hands over to the backtracking search
 
-// a frame in the solver stack
-typedef struct SolverFrame
+// shared state of a portfolio run
+typedef struct PortfolioShared
 {
-    size_t cands_size;
-    int idx;
-    Placement cands[CANDS_MAX_SIZE];
-} SolverFrame;
+    atomic_bool stop;
+    atomic_int winner; // index of the first worker with a definitive answer, -1 while none
+} PortfolioShared;
 
-// solver stack for backtracking
-typedef struct SolverStack
+// fixed prefixes of the subtrees at one depth, in search order
+typedef struct SubtreeSplit
 {
-    size_t capacity;
-    int top;
-    SolverFrame frames[];
-} SolverStack;
+    size_t depth;        // slots per prefix
+    size_t num;
+    size_t cap;
+    Placement *prefixes; // num * depth placements
+    size_t *lengths;     // placements per prefix: depth, or fewer for a solution found above it
+    uint64_t nodes;
+} SubtreeSplit;
 
-// create stack
-static inline SolverStack *create_stack(size_t max_frame_num)
+struct OrderedWorker;
+
+// shared state of a deterministic parallel run
+typedef struct OrderedShared
 {
-    // guard against overflow in allocation size
-    if (max_frame_num > 0 && max_frame_num > (SIZE_MAX - SOLVER_STACK_SIZE) / SOLVER_FRAME_SIZE)
-        return NULL;
-    size_t bytes = SOLVER_STACK_SIZE + max_frame_num * SOLVER_FRAME_SIZE;
-    SolverStack *stack = calloc(1, bytes);
-    if (!stack)
-        return NULL;
-    stack->capacity = max_frame_num;
-    stack->top = -1;
-    return stack;
+    const SubtreeSplit *split;
+    atomic_size_t next; // next subtree to hand out
+    atomic_size_t best; // leftmost subtree solved so far; SIZE_MAX while none
+    atomic_bool failed;
+    pthread_mutex_t lock; // guards solution, winner and error
+    Placement *solution;
+    size_t winner; // worker that solved the best subtree
+    StatusCode error;
+    struct OrderedWorker *workers;
+    size_t worker_num;
+} OrderedShared;
+
+// one deterministic worker: a search on its own board copy, rebuilt for every subtree it takes
+typedef struct OrderedWorker
+{
+    pthread_t thread;
+    bool started;
+    size_t index;
+    Board *board;
+    const TetrominoBag *bag;
+    SearchOrder order;
+    EndgameTable *endgame; // worker 0 borrows the caller's table, the others own theirs
+    atomic_size_t current; // subtree being searched; SIZE_MAX before the first
+    atomic_bool cancel;
+    uint64_t nodes;
+    OrderedShared *shared;
+} OrderedWorker;
+
+// solution iterator: a plain search kept between calls
+struct SolverIter
+{
+    SearchContext ctx;
+    bool searching; // ctx is initialized (false: area mismatch, nothing to enumerate)
+    bool started;   // a solution is on the board; the next call backtracks from it
+    bool done;
+    size_t piece_num; // bag->total: slots each solution needs
+};
+
+// one portfolio search running on its own board copy
+typedef struct PortfolioWorker
+{
+    pthread_t thread;
+    bool started;
+    bool cancelled;
+    size_t index;
+    Board *board;
+    const TetrominoBag *bag;
+    SolverConfig config;
+    Placement *list;
+    StatusCode result;
+    SolverStats stats;
+    PortfolioShared *shared;
+} PortfolioWorker;
+
+// Luby sequence 1,1,2,1,1,2,4,1,1,2,... for i >= 1
+static uint64_t luby(uint64_t i)
+{
+    while (true)
+    {
+        unsigned k = 1;
+        while (k < 63 && ((UINT64_C(1) << k) - 1) < i)
+            k++;
+        if (i == (UINT64_C(1) << k) - 1)
+            return UINT64_C(1) << (k - 1);
+        i -= (UINT64_C(1) << (k - 1)) - 1;
+    }
 }
 
-// destroy stack
-static inline void destroy_stack(SolverStack *stack)
+// node budget of the i-th restart, saturating instead of overflowing
+static uint64_t restart_budget(size_t base, uint64_t i)
 {
-    if (!stack)
-        return;
-    free(stack);
+    uint64_t unit = luby(i);
+    if (unit > LUBY_MAX_UNIT / base)
+        return UINT64_MAX;
+    return unit * (uint64_t)base;
 }
 
-// stack empty or not
-static inline bool stack_is_empty(SolverStack *stack)
+// absolute node limit for the next restart window
+static uint64_t next_node_limit(const SearchContext *ctx)
 {
-    return stack->top == -1;
+    uint64_t budget = restart_budget(ctx->restart_base, ctx->restarts + 1);
+    return budget > UINT64_MAX - ctx->nodes ? 0 : ctx->nodes + budget;
 }
 
-// stack full or not
-static inline bool stack_is_full(SolverStack *stack)
+// the earlier of two node limits, where 0 means none
+static inline uint64_t first_limit(uint64_t a, uint64_t b)
 {
-    return stack->top == (int)stack->capacity - 1;
+    if (a == 0 || b == 0)
+        return a > b ? a : b;
+    return a < b ? a : b;
 }
 
-// undo the placement represented by the current top frame (if any)
-static inline bool undo_top_placement(Board *board,
-                                      SolverStack *stack,
-                                      size_t counts[TETRO_TYPE_COUNT],
-                                      size_t *filled_cells)
+// print a progress line for the general engine; explored estimates the finished fraction of the whole tree
+static void report_search_progress(const SearchContext *ctx, double explored)
 {
-    if (stack_is_empty(stack))
-        return false;
-    SolverFrame *frame = stack->frames + stack->top;
-    if (frame->idx < 0)
-        return false; // nothing placed at this frame yet
-    Placement *prev_placement = frame->cands + frame->idx;
-    board_remove(board, prev_placement->x, prev_placement->y, prev_placement->type, prev_placement->rotation);
-    counts[prev_placement->type]++;
-    if (*filled_cells >= 4)
-        *filled_cells -= 4;
-    return true;
+    ProgressSnapshot snap;
+    snap.kernel = "generic";
+    snap.depth = (size_t)(ctx->stack->top + 1);
+    snap.piece_num = snap.depth + (ctx->target_cells - ctx->filled_cells) / 4;
+    snap.filled_cells = ctx->filled_cells;
+    snap.total_cells = board_cell_count(ctx->board);
+    snap.nodes = ctx->nodes;
+    snap.explored = explored;
+    progress_report(&snap);
 }
 
-// push a new frame to stack
-static inline StatusCode push_frame(size_t cands_size, Placement *cands, SolverStack *stack)
+// one search (with restarts/checkpoints if configured); on success out_list holds the solution.
+// With out_count set, every solution is counted instead (no restarts, no endgame shortcuts, no node budget).
+static StatusCode run_search(Board *board,
+                             const TetrominoBag *bag,
+                             const SolverConfig *config,
+                             const atomic_bool *cancel,
+                             Placement *out_list,
+                             uint64_t *out_count,
+                             SolverStats *stats,
+                             bool *cancelled)
 {
-    if (!cands)
-        return STATUS_ERR_MEMORY;
+    *cancelled = false;
+    SearchContext ctx;
+    bool counting = out_count != NULL;
+    StatusCode res = search_init(&ctx, board, bag, counting ? NULL : config->endgame);
+    if (res != STATUS_OK)
+        return res;
+    ctx.order = config->order;
+    ctx.cover = counting; // a count has to reach every tiling
+    ctx.randomize = config->randomize;
+    ctx.restart_base = config->randomize && !counting ? config->restart_base : 0;
+    uint64_t budget = counting ? 0 : config->node_limit;
+    ctx.cancel = cancel;
+    ctx.progress = progress_flag();
+    search_seed(&ctx, config->seed);
 
-    if (stack_is_full(stack))
-        return STATUS_ERR_MEMORY;
+    // a checkpoint carries its own counters, RNG state and restart window
+    if (config->resume_path)
+    {
+        res = checkpoint_load(config->resume_path, &ctx, bag);
+        if (res == STATUS_OK && counting && !ctx.cover)
+        {
+            // saved by an anchored solve: counting on from it would miss tilings
+            ctx.floor = 0;
+            search_unwind(&ctx);
+            res = STATUS_ERR_INPUT;
+        }
+        if (res != STATUS_OK)
+        {
+            search_release(&ctx);
+            return res;
+        }
+    }
+    else if (ctx.restart_base > 0)
+    {
+        ctx.node_limit = next_node_limit(&ctx);
+    }
+    ctx.node_limit = first_limit(ctx.node_limit, budget);
+    if (config->checkpoint_path)
+        ctx.yield_interval = CHECKPOINT_YIELD_NODES;
+    time_t last_save = time(NULL);
 
-    stack->top++;
-    SolverFrame *frame = stack->frames + stack->top;
-    frame->cands_size = cands_size;
-    frame->idx = -1;
-    memcpy(frame->cands, cands, cands_size * PLACEMENT_SIZE);
-    return STATUS_OK;
+    SearchOutcome outcome;
+    while (true)
+    {
+        outcome = search_run(&ctx);
+        if (outcome == SEARCH_YIELD)
+        {
+            if (ctx.progress && *ctx.progress)
+                report_search_progress(&ctx, search_explored(&ctx));
+            time_t now = time(NULL);
+            if (config->checkpoint_path && difftime(now, last_save) >= (double)config->checkpoint_interval)
+            {
+                if (checkpoint_save(config->checkpoint_path, &ctx, bag) == STATUS_OK)
+                    stats->checkpoints_written++;
+                else
+                    stats->checkpoint_failures++;
+                last_save = now;
+            }
+            continue;
+        }
+        if (outcome == SEARCH_SOLVED && counting)
+        {
+            // counting run: record the tiling and keep searching past it
+            ctx.solutions++;
+            if (search_backtrack(&ctx))
+                continue;
+            outcome = SEARCH_EXHAUSTED;
+            break;
+        }
+        if (outcome != SEARCH_NODE_LIMIT || (budget > 0 && ctx.nodes >= budget))
+            break;
+        // unlucky early choices: start over with the shuffler's state carried forward
+        search_unwind(&ctx);
+        ctx.restarts++;
+        ctx.node_limit = first_limit(next_node_limit(&ctx), budget);
+    }
+
+    stats->nodes = ctx.nodes;
+    stats->restarts = ctx.restarts;
+    stats->randomized = ctx.randomize;
+    stats->seed = config->seed;
+    stats->restart_base = ctx.restart_base;
+
+    switch (outcome)
+    {
+    case SEARCH_SOLVED:
+        search_placements(&ctx, out_list);
+        res = STATUS_OK;
+        break;
+    case SEARCH_EXHAUSTED:
+        res = counting ? STATUS_OK : STATUS_ERR_UNSOLVABLE;
+        if (counting)
+            *out_count = ctx.solutions;
+        // leave the board as the search found it (a resumed prefix is not part of the input)
+        ctx.floor = 0;
+        search_unwind(&ctx);
+        break;
+    case SEARCH_CANCELLED:
+        search_unwind(&ctx);
+        *cancelled = true;
+        res = STATUS_OK;
+        break;
+    case SEARCH_ERROR:
+        res = ctx.error;
+        break;
+    case SEARCH_NODE_LIMIT:
+        if (budget > 0 && ctx.nodes >= budget)
+        {
+            // out of budget: give up without a proof, leaving the board as it was
+            search_unwind(&ctx);
+            res = STATUS_ERR_UNSOLVABLE;
+            break;
+        }
+        res = STATUS_ERR_INVALID_ARGUMENT;
+        break;
+    case SEARCH_YIELD:
+    case SEARCH_DEPTH_LIMIT:
+    default:
+        res = STATUS_ERR_INVALID_ARGUMENT;
+        break;
+    }
+    search_release(&ctx);
+    return res;
 }
 
-// pop a frame from stack, return top frame after popping
-static inline SolverFrame *pop_frame(SolverStack *stack)
+// portfolio thread entry
+static void *portfolio_main(void *arg)
 {
-    if (!stack)
-        return NULL;
-    if (stack->top == -1)
-        return NULL; // already empty
-    stack->top--;
-    if (stack->top == -1)
-        return NULL;                   // no previous frame
-    return stack->frames + stack->top; // new top (previous frame)
+    PortfolioWorker *worker = arg;
+    worker->result = run_search(worker->board, worker->bag, &worker->config, &worker->shared->stop,
+                                worker->list, NULL, &worker->stats, &worker->cancelled);
+    if (!worker->cancelled && (worker->result == STATUS_OK || worker->result == STATUS_ERR_UNSOLVABLE))
+    {
+        int expected = -1;
+        if (atomic_compare_exchange_strong(&worker->shared->winner, &expected, (int)worker->index))
+            atomic_store(&worker->shared->stop, true);
+    }
+    return NULL;
 }
 
-// generate candidate placements at cell
-static inline size_t generate_candidates(int x, int y, char mark, size_t *counts, Placement *out_cands)
+// worker 0 runs the given config; the others are differently seeded restarting searches
+static SolverConfig worker_config(const SolverConfig *config, size_t index)
 {
-    size_t idx = 0;
-    for (TetrominoType type = 0; type < TETRO_TYPE_COUNT; ++type)
+    SolverConfig c = *config;
+    c.threads = 1;
+    if (index > 0)
+    {
+        c.randomize = true;
+        c.seed = config->seed + index;
+        if (c.restart_base == 0)
+            c.restart_base = SOLVER_DEFAULT_RESTART_BASE;
+    }
+    return c;
+}
+
+// run config->threads searches and take the first definitive answer
+static StatusCode run_portfolio(Board *board,
+                                const TetrominoBag *bag,
+                                const SolverConfig *config,
+                                Placement *out_list,
+                                SolverStats *stats)
+{
+    size_t n = config->threads;
+    PortfolioWorker *workers = calloc(n, sizeof(PortfolioWorker));
+    if (!workers)
+        return STATUS_ERR_MEMORY;
+    PortfolioShared shared;
+    atomic_init(&shared.stop, false);
+    atomic_init(&shared.winner, -1);
+
+    StatusCode res = STATUS_OK;
+    size_t alloc_count = bag->total > 0 ? bag->total : 1;
+    for (size_t i = 0; i < n && res == STATUS_OK; ++i)
     {
-        if (counts[type] > 0)
+        PortfolioWorker *worker = workers + i;
+        worker->index = i;
+        worker->bag = bag;
+        worker->config = worker_config(config, i);
+        // worker 0 borrows the caller's endgame table, the others own one (NULL only disables lookups)
+        if (i > 0)
+            worker->config.endgame = endgame_create(ENDGAME_TABLE_LOG2);
+        worker->shared = &shared;
+        worker->board = board_clone(board);
+        worker->list = malloc(alloc_count * PLACEMENT_SIZE);
+        if (!worker->board || !worker->list)
+            res = STATUS_ERR_MEMORY;
+    }
+    for (size_t i = 0; i < n && res == STATUS_OK; ++i)
+        workers[i].started = pthread_create(&workers[i].thread, NULL, portfolio_main, workers + i) == 0;
+
+    size_t started = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (!workers[i].started)
+            continue;
+        pthread_join(workers[i].thread, NULL);
+        started++;
+    }
+
+    int winner = atomic_load(&shared.winner);
+    if (res == STATUS_OK)
+    {
+        if (winner >= 0)
+        {
+            PortfolioWorker *worker = workers + winner;
+            res = worker->result;
+            *stats = worker->stats;
+            stats->worker = worker->index;
+            if (res == STATUS_OK)
+            {
+                // replay the winning tiling onto the caller's board
+                for (size_t i = 0; i < bag->total; ++i)
+                {
+                    Placement *p = worker->list + i;
+                    board_place(board, p->x, p->y, p->type, p->rotation, p->mark);
+                }
+                memcpy(out_list, worker->list, bag->total * PLACEMENT_SIZE);
+            }
+        }
+        else
         {
-            size_t rotation_count = tetro_rotation_count(type);
-            for (size_t rot = 0; rot < rotation_count; ++rot)
+            // no definitive answer: report the first worker error
+            res = started == 0 ? STATUS_ERR_MEMORY : STATUS_ERR_INVALID_ARGUMENT;
+            for (size_t i = 0; i < n; ++i)
             {
-                if (idx < CANDS_MAX_SIZE)
+                if (workers[i].started && workers[i].result != STATUS_OK)
                 {
-                    Placement *cand = out_cands + idx;
-                    cand->type = type;
-                    cand->rotation = rot;
-                    cand->x = x;
-                    cand->y = y;
-                    cand->mark = mark;
-                    idx++;
+                    res = workers[i].result;
+                    break;
                 }
             }
         }
     }
-    return idx;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        board_destroy(workers[i].board);
+        free(workers[i].list);
+        if (i > 0)
+            endgame_destroy(workers[i].config.endgame);
+    }
+    free(workers);
+    return res;
 }
 
-// frame has remaining candidates or not
-static inline bool has_candidate(SolverFrame *frame)
+static void subtree_split_free(SubtreeSplit *split)
 {
-    return frame->idx + 1 < (int)frame->cands_size;
+    free(split->prefixes);
+    free(split->lengths);
+    memset(split, 0, sizeof(*split));
 }
 
-// find next empty cell on board
-static inline Cell find_next_empty(Board *board)
+// append the placed frames as one prefix; false once the split would exceed ORDERED_MAX_UNITS
+static bool subtree_split_add(SubtreeSplit *split, const SearchContext *ctx, StatusCode *res)
 {
-    Cell cell = {-1, -1};
-    int H = board_height(board);
-    int W = board_width(board);
-    for (int y = 0; y < H; ++y)
+    if (split->num == ORDERED_MAX_UNITS)
+        return false;
+    if (split->num == split->cap)
     {
-        for (int x = 0; x < W; ++x)
+        size_t cap = split->cap > 0 ? split->cap * 2 : 64;
+        Placement *prefixes = realloc(split->prefixes, cap * split->depth * PLACEMENT_SIZE);
+        if (prefixes)
+            split->prefixes = prefixes;
+        size_t *lengths = prefixes ? realloc(split->lengths, cap * sizeof(size_t)) : NULL;
+        if (!lengths)
         {
-            if (board_is_empty(board, x, y))
+            *res = STATUS_ERR_MEMORY;
+            return false;
+        }
+        split->lengths = lengths;
+        split->cap = cap;
+    }
+    split->lengths[split->num] = search_placements(ctx, split->prefixes + split->num * split->depth);
+    split->num++;
+    return true;
+}
+
+/* Enumerate the subtrees at depth placements in search order (the plain search with the config's order,
+ * as work units are split). *out_full is set when there are more than ORDERED_MAX_UNITS of them. */
+static StatusCode split_subtrees(Board *board,
+                                 const TetrominoBag *bag,
+                                 SearchOrder order,
+                                 size_t depth,
+                                 SubtreeSplit *out,
+                                 bool *out_full)
+{
+    memset(out, 0, sizeof(*out));
+    out->depth = depth;
+    *out_full = false;
+    SearchContext ctx;
+    StatusCode res = search_init(&ctx, board, bag, NULL);
+    if (res != STATUS_OK)
+        return res;
+    ctx.order = order;
+    ctx.depth_limit = (int)depth;
+    while (res == STATUS_OK)
+    {
+        SearchOutcome outcome = search_run(&ctx);
+        if (outcome == SEARCH_DEPTH_LIMIT || outcome == SEARCH_SOLVED)
+        {
+            if (!subtree_split_add(out, &ctx, &res))
             {
-                cell.x = x;
-                cell.y = y;
-                return cell;
+                *out_full = res == STATUS_OK;
+                break;
             }
+            if (!search_backtrack(&ctx))
+                break;
+            continue;
         }
+        if (outcome == SEARCH_ERROR)
+            res = ctx.error;
+        break;
     }
-    return cell;
+    out->nodes = ctx.nodes;
+    search_unwind(&ctx);
+    search_release(&ctx);
+    if (res != STATUS_OK)
+        subtree_split_free(out);
+    return res;
 }
 
-// get mark based on index in stack
-static inline char mark_at(int depth)
+// deepen the split until every thread has ORDERED_UNITS_PER_THREAD subtrees to take, within ORDERED_MAX_UNITS
+static StatusCode choose_split(Board *board, const TetrominoBag *bag, SearchOrder order, size_t threads,
+                               SubtreeSplit *out)
 {
-    return (char)('A' + (depth % MARK_NUM));
+    memset(out, 0, sizeof(*out));
+    uint64_t nodes = 0;
+    for (size_t depth = 1; depth <= bag->total; ++depth)
+    {
+        SubtreeSplit split;
+        bool full = false;
+        StatusCode res = split_subtrees(board, bag, order, depth, &split, &full);
+        if (res != STATUS_OK)
+        {
+            subtree_split_free(out);
+            return res;
+        }
+        nodes += split.nodes;
+        if (full && out->depth > 0)
+        {
+            subtree_split_free(&split);
+            break; // the previous depth is as fine as the cap allows
+        }
+        subtree_split_free(out);
+        *out = split;
+        if (full || split.num == 0 || split.num >= threads * ORDERED_UNITS_PER_THREAD)
+            break;
+    }
+    out->nodes = nodes;
+    return STATUS_OK;
 }
 
-// main solver function
-StatusCode solver_solve(Board *board,
-                        const TetrominoBag *bag,
-                        Placement *out_list,
-                        size_t *inout_count)
+// cancel the workers searching subtrees right of index; they can no longer win
+static void cancel_right_of(OrderedShared *shared, size_t index)
 {
-    if (!board || !bag || !out_list || !inout_count)
-        return STATUS_ERR_INVALID_ARGUMENT;
-
-    size_t bag_total = bag->total;
-    size_t counts[TETRO_TYPE_COUNT];
-    memcpy(counts, bag->counts, sizeof(counts));
-    // overflow guard for computing target cells
-    if (bag_total > SIZE_MAX / 4)
-        return STATUS_ERR_INVALID_ARGUMENT;
-    // index guard for internal stack indexing (top is int)
-    if (bag_total > (size_t)INT_MAX)
-        return STATUS_ERR_INVALID_ARGUMENT;
-    size_t board_cells = board_cell_count(board);
-    size_t target_cells = bag_total * 4;
-    if (target_cells != board_cells)
+    for (size_t i = 0; i < shared->worker_num; ++i)
     {
-        // piece and board cell numbers do not match, unsolvable
-        *inout_count = 0;
-        return STATUS_ERR_UNSOLVABLE;
+        OrderedWorker *other = shared->workers + i;
+        if (atomic_load(&other->current) > index)
+            atomic_store(&other->cancel, true);
     }
-    // compute initial filled cells once
-    size_t filled_cells = board_filled_count(board);
+}
 
-    // create stack
-    SolverStack *stack = create_stack(bag_total);
-    if (!stack)
-        return STATUS_ERR_MEMORY;
+static void ordered_fail(OrderedShared *shared, StatusCode error)
+{
+    pthread_mutex_lock(&shared->lock);
+    if (shared->error == STATUS_OK)
+        shared->error = error;
+    pthread_mutex_unlock(&shared->lock);
+    atomic_store(&shared->failed, true);
+    for (size_t i = 0; i < shared->worker_num; ++i)
+        atomic_store(&shared->workers[i].cancel, true);
+}
 
-    // iterative backtracking
-    bool need_new_frame = true;
-    while (true)
+// search one subtree from its fixed prefix; true when the worker should take another one
+static bool ordered_subtree(OrderedWorker *worker, SearchContext *ctx, size_t index)
+{
+    OrderedShared *shared = worker->shared;
+    const SubtreeSplit *split = shared->split;
+    const Placement *prefix = split->prefixes + index * split->depth;
+    size_t length = split->lengths[index];
+
+    ctx->floor = 0;
+    search_unwind(ctx);
+    SolverFrame frame;
+    frame.cands_size = 1;
+    frame.idx = 0;
+    for (size_t k = 0; k < length; ++k)
     {
-        // 1) terminate, solved
-        if (filled_cells == target_cells)
+        frame.cands[0] = prefix[k];
+        StatusCode res = search_push_placed(ctx, &frame);
+        if (res != STATUS_OK)
         {
-            // solved
-            *inout_count = bag_total;
-            // write to out_list
-            for (size_t i = 0; i < bag_total; ++i)
-            {
-                SolverFrame *frame = stack->frames + i;
-                size_t cand_idx = (size_t)(frame->idx);
-                memcpy(out_list + i, frame->cands + cand_idx, PLACEMENT_SIZE);
-            }
-            destroy_stack(stack);
-            return STATUS_OK;
+            ordered_fail(shared, res);
+            return false;
         }
+    }
+    ctx->floor = (int)length;
 
-        // 2) need to push new frame
-        if (need_new_frame)
+    while (true)
+    {
+        SearchOutcome outcome = search_run(ctx);
+        switch (outcome)
         {
-            Cell pos = find_next_empty(board);
-            char mark = mark_at(stack->top + 1);
-            Placement cands[CANDS_MAX_SIZE];
-            size_t cands_size = generate_candidates(pos.x, pos.y, mark, counts, cands);
-            if (cands_size == 0)
+        case SEARCH_SOLVED:
+            pthread_mutex_lock(&shared->lock);
+            if (index < atomic_load(&shared->best))
             {
-                // No candidates for next cell: undo the placement at current top frame
-                if (!undo_top_placement(board, stack, counts, &filled_cells))
-                {
-                    // nothing to undo => unsolvable
-                    *inout_count = 0;
-                    board_clear(board);
-                    destroy_stack(stack);
-                    return STATUS_ERR_UNSOLVABLE;
-                }
-                need_new_frame = false;
-                continue;
-            }
-            StatusCode res = push_frame(cands_size, cands, stack);
-            if (res != STATUS_OK)
-            {
-                destroy_stack(stack);
-                return res;
+                search_placements(ctx, shared->solution);
+                shared->winner = worker->index;
+                atomic_store(&shared->best, index);
             }
-            need_new_frame = false;
+            pthread_mutex_unlock(&shared->lock);
+            cancel_right_of(shared, index);
+            return false; // every subtree still to hand out lies right of this one
+        case SEARCH_EXHAUSTED:
+            return true;
+        case SEARCH_CANCELLED:
+            if (atomic_load(&shared->failed))
+                return false;
+            // a flag raised before this subtree was taken: clear it, then check again who is ahead
+            atomic_store(&worker->cancel, false);
+            if (index > atomic_load(&shared->best))
+                return false;
+            continue;
+        case SEARCH_ERROR:
+            ordered_fail(shared, ctx->error);
+            return false;
+        case SEARCH_YIELD:
+            // a progress request: subtrees are handed out left to right, so this one's share starts at index
+            if (ctx->progress && *ctx->progress)
+                report_search_progress(ctx, ((double)index + search_explored(ctx)) / (double)split->num);
+            continue;
+        case SEARCH_NODE_LIMIT:
+        case SEARCH_DEPTH_LIMIT:
+        default:
+            ordered_fail(shared, STATUS_ERR_INVALID_ARGUMENT);
+            return false;
         }
+    }
+}
+
+// deterministic worker thread entry: take subtrees in order until none left of the best can remain
+static void *ordered_main(void *arg)
+{
+    OrderedWorker *worker = arg;
+    OrderedShared *shared = worker->shared;
+    SearchContext ctx;
+    StatusCode res = search_init(&ctx, worker->board, worker->bag, worker->endgame);
+    if (res != STATUS_OK)
+    {
+        ordered_fail(shared, res);
+        return NULL;
+    }
+    ctx.order = worker->order;
+    ctx.cancel = &worker->cancel;
+    ctx.progress = progress_flag();
+
+    while (!atomic_load(&shared->failed))
+    {
+        size_t index = atomic_fetch_add(&shared->next, 1);
+        if (index >= shared->split->num)
+            break;
+        // publish the subtree before looking at best, so a solver to the left either is seen or sees us
+        atomic_store(&worker->cancel, false);
+        atomic_store(&worker->current, index);
+        if (index > atomic_load(&shared->best))
+            break;
+        if (!ordered_subtree(worker, &ctx, index))
+            break;
+    }
+    worker->nodes = ctx.nodes;
+    ctx.floor = 0;
+    search_unwind(&ctx);
+    search_release(&ctx);
+    return NULL;
+}
+
+/* Deterministic parallel solve: the subtrees at a fixed depth are handed out in search order, and a
+ * solution in subtree i cancels only the subtrees right of i. The leftmost subtree holding a solution is
+ * searched to its first solution, exactly what one sequential search would return. */
+static StatusCode run_ordered(Board *board,
+                              const TetrominoBag *bag,
+                              const SolverConfig *config,
+                              Placement *out_list,
+                              SolverStats *stats)
+{
+    SubtreeSplit split;
+    StatusCode res = choose_split(board, bag, config->order, config->threads, &split);
+    if (res != STATUS_OK)
+        return res;
+    stats->nodes = split.nodes;
+    if (split.num == 0)
+    {
+        subtree_split_free(&split);
+        return STATUS_ERR_UNSOLVABLE;
+    }
 
-        // 3) try next candidate in the current frame
-        SolverFrame *top_frame = stack->frames + stack->top;
-        if (has_candidate(top_frame))
+    size_t n = config->threads < split.num ? config->threads : split.num;
+    OrderedWorker *workers = calloc(n, sizeof(OrderedWorker));
+    OrderedShared shared;
+    shared.split = &split;
+    atomic_init(&shared.next, 0);
+    atomic_init(&shared.best, SIZE_MAX);
+    atomic_init(&shared.failed, false);
+    shared.solution = malloc((bag->total > 0 ? bag->total : 1) * PLACEMENT_SIZE);
+    shared.winner = 0;
+    shared.error = STATUS_OK;
+    shared.workers = workers;
+    shared.worker_num = n;
+    bool locked = pthread_mutex_init(&shared.lock, NULL) == 0;
+    if (!workers || !shared.solution || !locked)
+        res = STATUS_ERR_MEMORY;
+    for (size_t i = 0; i < n && res == STATUS_OK; ++i)
+    {
+        OrderedWorker *worker = workers + i;
+        worker->index = i;
+        worker->bag = bag;
+        worker->order = config->order;
+        worker->endgame = i == 0 ? config->endgame : endgame_create(ENDGAME_TABLE_LOG2);
+        worker->shared = &shared;
+        atomic_init(&worker->current, SIZE_MAX);
+        atomic_init(&worker->cancel, false);
+        worker->board = board_clone(board);
+        if (!worker->board)
+            res = STATUS_ERR_MEMORY;
+    }
+    for (size_t i = 0; i < n && res == STATUS_OK; ++i)
+        workers[i].started = pthread_create(&workers[i].thread, NULL, ordered_main, workers + i) == 0;
+
+    size_t started = 0;
+    for (size_t i = 0; workers && i < n; ++i)
+    {
+        if (!workers[i].started)
+            continue;
+        pthread_join(workers[i].thread, NULL);
+        stats->nodes += workers[i].nodes;
+        started++;
+    }
+    if (res == STATUS_OK && started < n && atomic_load(&shared.best) == SIZE_MAX)
+        res = STATUS_ERR_MEMORY; // an unstarted worker's subtrees were never searched
+    if (res == STATUS_OK && shared.error != STATUS_OK)
+        res = shared.error;
+
+    if (res == STATUS_OK)
+    {
+        size_t best = atomic_load(&shared.best);
+        if (best == SIZE_MAX)
+            res = STATUS_ERR_UNSOLVABLE;
+        else
         {
-            top_frame->idx++;
-            Placement *cand = top_frame->cands + top_frame->idx;
-            if (board_place(board, cand->x, cand->y, cand->type, cand->rotation, cand->mark))
+            // replay the leftmost solution onto the caller's board
+            for (size_t i = 0; i < bag->total; ++i)
             {
-                counts[cand->type]--;
-                filled_cells += 4;
-                need_new_frame = true;
+                Placement *p = shared.solution + i;
+                board_place(board, p->x, p->y, p->type, p->rotation, p->mark);
             }
-            continue;
+            memcpy(out_list, shared.solution, bag->total * PLACEMENT_SIZE);
+            stats->worker = shared.winner;
         }
+    }
+
+    for (size_t i = 0; workers && i < n; ++i)
+    {
+        board_destroy(workers[i].board);
+        if (i > 0)
+            endgame_destroy(workers[i].endgame);
+    }
+    if (locked)
+        pthread_mutex_destroy(&shared.lock);
+    free(shared.solution);
+    free(workers);
+    subtree_split_free(&split);
+    return res;
+}
+
+void solver_config_init(SolverConfig *config)
+{
+    if (!config)
+        return;
+    config->randomize = false;
+    config->seed = 0;
+    config->restart_base = 0;
+    config->threads = 1;
+    config->deterministic = false;
+    config->checkpoint_path = NULL;
+    config->checkpoint_interval = SOLVER_DEFAULT_CHECKPOINT_INTERVAL;
+    config->resume_path = NULL;
+    config->engine = SOLVER_ENGINE_AUTO;
+    config->order = SEARCH_ORDER_TYPE;
+    config->scan = SOLVER_SCAN_AUTO;
+    config->endgame = NULL;
+    config->node_limit = 0;
+}
 
-        // 4) current frame exhausted, backtrack
-        SolverFrame *prev_frame = pop_frame(stack);
-        if (prev_frame != NULL)
+// the bitboard kernels cover plain deterministic single-threaded solves only
+static bool use_bitkernel(const Board *board, const SolverConfig *config)
+{
+    return config->engine == SOLVER_ENGINE_AUTO && config->threads == 1 && !config->randomize &&
+           config->order == SEARCH_ORDER_TYPE && !config->checkpoint_path && !config->resume_path &&
+           bitkernel_supports(board_width(board), board_height(board));
+}
+
+// scan along the short side: a wide board is searched transposed (checkpoints and work units stay row-major)
+static bool use_transpose(const Board *board, const SolverConfig *config)
+{
+    if (config->engine == SOLVER_ENGINE_SAT || config->scan == SOLVER_SCAN_ROW || config->checkpoint_path ||
+        config->resume_path)
+        return false;
+    return config->scan == SOLVER_SCAN_COLUMN || board_width(board) > board_height(board);
+}
+
+// run the engine the config selects on board as it is
+static StatusCode run_engine(Board *board,
+                             const TetrominoBag *bag,
+                             const SolverConfig *config,
+                             Placement *out_list,
+                             SolverStats *stats)
+{
+    StatusCode res;
+    if (config->engine == SOLVER_ENGINE_SAT)
+    {
+        SatStats sat;
+        bool limited = false;
+        res = cnf_solve(board, bag, SAT_CONFLICT_LIMIT, out_list, &sat, &limited);
+        stats->nodes = sat.decisions;
+        stats->kernel = "sat";
+        if (limited)
         {
-            // child frame removed; undo placement at new top (the parent)
-            if (!undo_top_placement(board, stack, counts, &filled_cells))
-            {
-                *inout_count = 0;
-                board_clear(board);
-                destroy_stack(stack);
-                return STATUS_ERR_UNSOLVABLE;
-            }
-            need_new_frame = false;
-            continue;
+            // no answer within the budget: the anchored search settles it instead (incompletely)
+            SolverConfig fallback = *config;
+            fallback.engine = SOLVER_ENGINE_AUTO;
+            res = run_engine(board, bag, &fallback, out_list, stats);
         }
+    }
+    else if (config->threads > 1 && config->deterministic)
+    {
+        res = run_ordered(board, bag, config, out_list, stats);
+        stats->kernel = "generic";
+    }
+    else if (config->threads > 1)
+    {
+        res = run_portfolio(board, bag, config, out_list, stats);
+        stats->kernel = "generic";
+    }
+    else if (use_bitkernel(board, config))
+    {
+        res = bitkernel_solve(board, bag, config->node_limit, out_list, &stats->nodes);
+        stats->kernel = bitkernel_name(board_width(board));
+    }
+    else
+    {
+        bool cancelled = false;
+        res = run_search(board, bag, config, NULL, out_list, NULL, stats, &cancelled);
+        stats->kernel = "generic";
+    }
+    return res;
+}
+
+// search the transposed board with the reflected bag, then reflect the tiling back onto board
+static StatusCode run_transposed(Board *board,
+                                 const TetrominoBag *bag,
+                                 const SolverConfig *config,
+                                 Placement *out_list,
+                                 SolverStats *stats)
+{
+    Board *transposed = board_transpose(board);
+    if (!transposed)
+        return STATUS_ERR_MEMORY;
+    TetrominoBag reflected;
+    reflected.total = bag->total;
+    for (TetrominoType t = 0; t < TETRO_TYPE_COUNT; ++t)
+        reflected.counts[tetro_transposed_type(t)] = bag->counts[t];
+
+    StatusCode res = run_engine(transposed, &reflected, config, out_list, stats);
+    board_destroy(transposed);
+    for (size_t i = 0; res == STATUS_OK && i < bag->total; ++i)
+    {
+        Placement *p = out_list + i;
+        tetro_transpose_placement(p);
+        board_place(board, p->x, p->y, p->type, p->rotation, p->mark);
+    }
+    return res;
+}
+
+// the search path of solver_solve_config, after the construction shortcut
+static StatusCode run_solve(Board *board,
+                            const TetrominoBag *bag,
+                            const SolverConfig *config,
+                            Placement *out_list,
+                            SolverStats *stats)
+{
+    StatusCode res;
+    // disconnected empty regions are tiled one by one (a checkpoint covers one search of the whole board,
+    // a node budget one search of it)
+    if (config->engine != SOLVER_ENGINE_SAT && !config->checkpoint_path && !config->resume_path &&
+        config->node_limit == 0 && regions_solve(board, bag, config, out_list, stats, &res))
+        stats->kernel = "regions";
+    else if (use_transpose(board, config))
+        res = run_transposed(board, bag, config, out_list, stats);
+    else
+        res = run_engine(board, bag, config, out_list, stats);
+    return res;
+}
+
+StatusCode solver_solve_config(Board *board,
+                               const TetrominoBag *bag,
+                               const SolverConfig *config,
+                               Placement *out_list,
+                               size_t *inout_count,
+                               SolverStats *out_stats)
+{
+    if (!board || !bag || !out_list || !inout_count)
+        return STATUS_ERR_INVALID_ARGUMENT;
+
+    SolverConfig defaults;
+    if (!config)
+    {
+        solver_config_init(&defaults);
+        config = &defaults;
+    }
+    if (config->threads < 1 || config->threads > SOLVER_MAX_THREADS)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    if (config->threads > 1 && (config->checkpoint_path || config->resume_path))
+        return STATUS_ERR_INVALID_ARGUMENT;
+    // a shuffled order depends on one RNG stream, which parallel subtrees cannot share
+    if (config->deterministic && config->randomize)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    // the SAT engine has no search stack to randomize, share or checkpoint
+    if (config->engine == SOLVER_ENGINE_SAT &&
+        (config->threads > 1 || config->randomize || config->order != SEARCH_ORDER_TYPE ||
+         config->checkpoint_path || config->resume_path))
+        return STATUS_ERR_INVALID_ARGUMENT;
+    if ((unsigned)config->order >= SEARCH_ORDER_NUM || (unsigned)config->scan >= SOLVER_SCAN_NUM)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    // a node budget bounds one search on the calling thread
+    if (config->node_limit > 0 && (config->threads > 1 || config->engine == SOLVER_ENGINE_SAT ||
+                                   config->checkpoint_path || config->resume_path))
+        return STATUS_ERR_INVALID_ARGUMENT;
+    SolverStats stats;
+    memset(&stats, 0, sizeof(stats));
+
+    size_t bag_total = bag->total;
+    // overflow guard for computing target cells
+    if (bag_total > SIZE_MAX / 4)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    // index guard for internal stack indexing (top is int)
+    if (bag_total > (size_t)INT_MAX)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    if (*inout_count < bag_total)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    size_t board_cells = board_cell_count(board);
+    // compute initial filled cells once
+    size_t filled_cells = board_filled_count(board);
+    if (filled_cells > board_cells || board_cells - filled_cells != bag_total * 4)
+    {
+        // piece and free cell numbers do not match, unsolvable
+        *inout_count = 0;
+        if (out_stats)
+            *out_stats = stats;
+        return STATUS_ERR_UNSOLVABLE;
+    }
+
+    // structurally easy instances are tiled directly, without any search (a resume must still
+    // validate its checkpoint, so it always goes through the engine)
+    StatusCode res;
+    if (filled_cells == 0 && !config->resume_path && construct_tiling(board, bag, out_list, *inout_count))
+    {
+        res = STATUS_OK;
+        stats.kernel = "construct";
+    }
+    else
+    {
+        // one endgame table serves every search this solve runs on the calling thread
+        SolverConfig shared = *config;
+        EndgameTable *owned = NULL;
+        if (!shared.endgame)
+            shared.endgame = owned = endgame_create(ENDGAME_TABLE_LOG2); // NULL only disables lookups
+        res = run_solve(board, bag, &shared, out_list, &stats);
+        endgame_destroy(owned);
+        stats.limited = res == STATUS_ERR_UNSOLVABLE && config->node_limit > 0 && stats.nodes >= config->node_limit;
+    }
 
-        // unsolvable
+    if (res == STATUS_OK)
+        *inout_count = bag_total;
+    else if (res == STATUS_ERR_UNSOLVABLE)
+    {
         *inout_count = 0;
         board_clear(board);
-        destroy_stack(stack);
+    }
+    if (out_stats)
+        *out_stats = stats;
+    return res;
+}
+
+// main solver function
+StatusCode solver_solve(Board *board,
+                        const TetrominoBag *bag,
+                        Placement *out_list,
+                        size_t *inout_count)
+{
+    return solver_solve_config(board, bag, NULL, out_list, inout_count, NULL);
+}
+
+StatusCode solver_count(Board *board,
+                        const TetrominoBag *bag,
+                        const SolverConfig *config,
+                        uint64_t *out_count,
+                        SolverStats *out_stats)
+{
+    if (!board || !bag || !out_count)
+        return STATUS_ERR_INVALID_ARGUMENT;
+
+    SolverConfig defaults;
+    if (!config)
+    {
+        solver_config_init(&defaults);
+        config = &defaults;
+    }
+    if (config->threads != 1 || config->engine == SOLVER_ENGINE_SAT)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    SolverStats stats;
+    memset(&stats, 0, sizeof(stats));
+    *out_count = 0;
+
+    bool cancelled = false;
+    StatusCode res = run_search(board, bag, config, NULL, NULL, out_count, &stats, &cancelled);
+    stats.kernel = "generic";
+    if (res == STATUS_ERR_UNSOLVABLE)
+        res = STATUS_OK; // area mismatch: zero tilings
+    if (out_stats)
+        *out_stats = stats;
+    return res;
+}
+
+StatusCode solver_iter_begin(Board *board,
+                             const TetrominoBag *bag,
+                             const SolverConfig *config,
+                             SolverIter **out_iter)
+{
+    if (!board || !bag || !out_iter)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    *out_iter = NULL;
+    SolverConfig defaults;
+    if (!config)
+    {
+        solver_config_init(&defaults);
+        config = &defaults;
+    }
+    if (config->threads != 1 || config->engine == SOLVER_ENGINE_SAT || config->checkpoint_path ||
+        config->resume_path)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    if (bag->total > (size_t)INT_MAX)
+        return STATUS_ERR_INVALID_ARGUMENT;
+
+    SolverIter *iter = calloc(1, sizeof(SolverIter));
+    if (!iter)
+        return STATUS_ERR_MEMORY;
+    iter->piece_num = bag->total;
+    // endgame lookups return one tiling per region, so enumeration runs the plain search
+    StatusCode res = search_init(&iter->ctx, board, bag, NULL);
+    if (res == STATUS_ERR_UNSOLVABLE)
+    {
+        iter->done = true; // area mismatch: no tilings
+    }
+    else if (res != STATUS_OK)
+    {
+        free(iter);
+        return res;
+    }
+    else
+    {
+        iter->searching = true;
+        iter->ctx.order = config->order;
+        iter->ctx.cover = true; // every tiling, each once
+        iter->ctx.randomize = config->randomize;
+        iter->ctx.progress = progress_flag();
+        search_seed(&iter->ctx, config->seed);
+    }
+    *out_iter = iter;
+    return STATUS_OK;
+}
+
+StatusCode solver_iter_next(SolverIter *iter, Placement *out_list, size_t *inout_count)
+{
+    if (!iter || !out_list || !inout_count)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    if (*inout_count < iter->piece_num)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    if (iter->done)
+    {
+        *inout_count = 0;
         return STATUS_ERR_UNSOLVABLE;
     }
+
+    SearchContext *ctx = &iter->ctx;
+    // continue past the solution handed out last time
+    if (iter->started && !search_backtrack(ctx))
+        iter->done = true;
+    SearchOutcome outcome = SEARCH_EXHAUSTED;
+    while (!iter->done)
+    {
+        outcome = search_run(ctx);
+        if (outcome != SEARCH_YIELD)
+            break;
+        if (ctx->progress && *ctx->progress)
+            report_search_progress(ctx, search_explored(ctx));
+    }
+    if (!iter->done && outcome == SEARCH_SOLVED)
+    {
+        iter->started = true;
+        *inout_count = search_placements(ctx, out_list);
+        return STATUS_OK;
+    }
+    if (!iter->done && outcome == SEARCH_ERROR)
+        return ctx->error;
+    iter->done = true;
+    iter->started = false;
+    *inout_count = 0;
+    return STATUS_ERR_UNSOLVABLE;
+}
+
+void solver_iter_end(SolverIter *iter)
+{
+    if (!iter)
+        return;
+    if (iter->searching)
+    {
+        search_unwind(&iter->ctx);
+        search_release(&iter->ctx);
+    }
+    free(iter);
+}
+
+uint64_t solver_iter_nodes(const SolverIter *iter)
+{
+    return iter && iter->searching ? iter->ctx.nodes : 0;
 }
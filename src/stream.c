@@ -0,0 +1,412 @@
+#include <stdlib.h>
+#include <string.h>
+#include "stream.h"
+#include "board.h"
+#include "search.h"
+#include "solver.h"
+#include "tetromino.h"
+
+/* Streaming implementation:
+ *   - The window is an ordinary Board; the band search is a small frame-stack DFS over it built on
+ *     the engine primitives (search_next_empty, search_candidates in cover mode, so no way of filling a
+ *     band is out of its reach).
+ *   - Committing a band removes the lookahead placements, prints the band rows, then rebuilds the window
+ *     from the filled cells below the band, moved up by band_rows (fragments of committed pieces).
+ *   - The final rows go through solver_solve_config on a board of exactly that height, with the band budget.
+ *     The last band is only accepted once such a solve of the rows below it succeeds (within
+ *     STREAM_TAIL_TRIAL_NODE_LIMIT nodes); that tiling is then printed as the tail, however many bands
+ *     it spans. */
+
+#define MARK_NUM 26 // 26 letters from A-Z
+
+// a window cell covered by a piece of an already committed band
+typedef struct CarriedCell
+{
+    int x;
+    int y;
+    char mark;
+} CarriedCell;
+
+// resident state of a streaming run
+typedef struct StreamState
+{
+    int width;
+    int band;       // rows committed per step
+    Board *window;  // 2 * band + 3 rows
+    SolverFrame *frames;
+    size_t frame_cap;
+    CarriedCell *carried; // cells filled by pieces of committed bands
+    size_t carried_num;
+    size_t counts[TETRO_TYPE_COUNT];
+    size_t initial[TETRO_TYPE_COUNT];
+    uint64_t placed; // pieces committed so far (marks continue from here)
+    uint64_t nodes;
+    Board *tail; // the rows below the last band, tiled by the trial that accepted it
+} StreamState;
+
+static inline char mark_at(uint64_t index)
+{
+    return (char)('A' + (index % MARK_NUM));
+}
+
+// types with the largest remaining share of their initial count first; ties keep enum order
+static void order_by_share(const StreamState *st, Placement *cands, size_t cands_size)
+{
+    double share[TETRO_TYPE_COUNT];
+    for (size_t t = 0; t < TETRO_TYPE_COUNT; ++t)
+        share[t] = st->initial[t] > 0 ? (double)st->counts[t] / (double)st->initial[t] : 0.0;
+    // insertion sort is stable and the lists hold at most CANDS_MAX_SIZE entries
+    for (size_t i = 1; i < cands_size; ++i)
+    {
+        Placement cur = cands[i];
+        size_t j = i;
+        for (; j > 0 && share[cands[j - 1].type] < share[cur.type]; --j)
+            cands[j] = cands[j - 1];
+        cands[j] = cur;
+    }
+}
+
+// checkerboard colour of a cell: +1 or -1
+static inline int cell_colour(int x, int y)
+{
+    return ((x + y) & 1) ? -1 : 1;
+}
+
+/* Only a T covers the two checkerboard colours unequally (3:1), so the pieces left after the first band
+ * must have enough T's, of the right parity, for the colour imbalance of the board below that band. */
+static bool colour_balance_ok(const StreamState *st, size_t depth, int rows_below)
+{
+    size_t t_left = st->counts[TETRO_T];
+    long imbalance = 0;
+    // uncovered rows below the band, before the pieces that reach into them
+    if (st->width % 2 != 0)
+    {
+        for (int y = 0; y < rows_below; ++y)
+            imbalance += cell_colour(0, st->band + y);
+    }
+    for (size_t d = 0; d < depth; ++d)
+    {
+        const Placement *p = st->frames[d].cands + st->frames[d].idx;
+        if (p->y >= st->band)
+        {
+            if (p->type == TETRO_T)
+                t_left++; // a lookahead piece goes back into the bag
+            continue;
+        }
+        Cell cells[4];
+        size_t n = tetro_get_cells(p->type, p->rotation, cells);
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (p->y + cells[i].y >= st->band)
+                imbalance -= cell_colour(p->x + cells[i].x, p->y + cells[i].y);
+        }
+    }
+    for (size_t i = 0; i < st->carried_num; ++i)
+    {
+        const CarriedCell *c = st->carried + i;
+        if (c->y >= st->band)
+            imbalance -= cell_colour(c->x, c->y);
+    }
+    // each T shifts the balance by +-2: need |imbalance| <= 2 * T and T = imbalance / 2 (mod 2)
+    size_t need = (size_t)(imbalance < 0 ? -imbalance : imbalance);
+    if (need % 2 != 0 || need / 2 > t_left)
+        return false;
+    return (t_left - need / 2) % 2 == 0;
+}
+
+// tile board (its fixed cells in place) with the remaining counts within node_limit nodes
+static StatusCode solve_rows(StreamState *st, Board *board, uint64_t node_limit)
+{
+    TetrominoBag bag;
+    memcpy(bag.counts, st->counts, sizeof(bag.counts));
+    bag.total = 0;
+    for (size_t t = 0; t < TETRO_TYPE_COUNT; ++t)
+        bag.total += bag.counts[t];
+    Placement *list = malloc((bag.total > 0 ? bag.total : 1) * PLACEMENT_SIZE);
+    if (!list)
+        return STATUS_ERR_MEMORY;
+    SolverConfig config;
+    solver_config_init(&config);
+    config.node_limit = node_limit;
+    size_t count = bag.total;
+    SolverStats stats;
+    StatusCode res = solver_solve_config(board, &bag, &config, list, &count, &stats);
+    st->nodes += stats.nodes;
+    free(list);
+    return res;
+}
+
+/* The last band just closed: try to tile the rows_below rows under it, with the carried cells and the band's
+ * pieces reaching into them in place. On success the tiled rows are kept in st->tail. */
+static StatusCode try_tail(StreamState *st, size_t depth, int rows_below)
+{
+    Board *rest = board_create(st->width, rows_below);
+    if (!rest)
+        return STATUS_ERR_MEMORY;
+    for (size_t i = 0; i < st->carried_num; ++i)
+    {
+        const CarriedCell *c = st->carried + i;
+        if (c->y >= st->band)
+            board_fill_cell(rest, c->x, c->y - st->band, c->mark);
+    }
+    for (size_t d = 0; d < depth; ++d)
+    {
+        const Placement *p = st->frames[d].cands + st->frames[d].idx;
+        Cell cells[4];
+        size_t n = tetro_get_cells(p->type, p->rotation, cells);
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (p->y + cells[i].y >= st->band)
+                board_fill_cell(rest, p->x + cells[i].x, p->y + cells[i].y - st->band, p->mark);
+        }
+    }
+    StatusCode res = solve_rows(st, rest, STREAM_TAIL_TRIAL_NODE_LIMIT);
+    if (res == STATUS_OK)
+        st->tail = rest;
+    else
+        board_destroy(rest);
+    return res;
+}
+
+// take back the placements of frames[0..depth), all placed
+static void drop_band(StreamState *st, size_t depth)
+{
+    for (size_t d = depth; d-- > 0;)
+    {
+        const Placement *p = st->frames[d].cands + st->frames[d].idx;
+        board_remove(st->window, p->x, p->y, p->type, p->rotation);
+        st->counts[p->type]++;
+    }
+}
+
+/* Fill the window rows [0, goal) with the remaining counts. On true, frames[0..*out_depth) hold the
+ * placements in anchor order (all placed) and leave a colour balance the rows_below rows under the first
+ * band can absorb; for the last band (last: goal is the band) those rows must also tile, see try_tail.
+ * On false the window is back to the carried pieces; *out_res is set on an error other than a dead end. */
+static bool search_band(StreamState *st, int goal, int rows_below, bool last, size_t *out_depth,
+                        StatusCode *out_res)
+{
+    Board *win = st->window;
+    size_t depth = 0; // frames on the stack
+    bool need_frame = true;
+    uint64_t budget = st->nodes + STREAM_BAND_NODE_LIMIT;
+    *out_res = STATUS_OK;
+    while (true)
+    {
+        if (need_frame)
+        {
+            Cell pos = search_next_empty(win);
+            // the first band just closed: check it before spending any work on the lookahead
+            bool band_closed = pos.y < 0 || pos.y >= st->band;
+            bool dead = false;
+            if (band_closed && (depth == 0 || st->frames[depth - 1].cands[0].y < st->band))
+            {
+                dead = !colour_balance_ok(st, depth, rows_below);
+                if (!dead && last)
+                {
+                    StatusCode res = try_tail(st, depth, rows_below);
+                    dead = res == STATUS_ERR_UNSOLVABLE;
+                    if (res != STATUS_OK && !dead)
+                        *out_res = res;
+                }
+            }
+            if (*out_res != STATUS_OK)
+            {
+                drop_band(st, depth);
+                return false;
+            }
+            if (dead)
+            {
+                need_frame = false; // the rest of the board cannot be tiled: try the next candidate
+                if (depth == 0)
+                    return false;
+                continue;
+            }
+            if (pos.y < 0 || pos.y >= goal)
+            {
+                *out_depth = depth;
+                return true;
+            }
+            if (depth == st->frame_cap)
+                return false; // cannot happen: every frame covers four window cells
+            SolverFrame *frame = st->frames + depth;
+            frame->cands_size = search_candidates(win, pos.x, pos.y, mark_at(st->placed + depth), st->counts, true,
+                                                  frame->cands);
+            order_by_share(st, frame->cands, frame->cands_size);
+            frame->idx = -1;
+            depth++;
+            need_frame = false;
+        }
+
+        SolverFrame *top = st->frames + depth - 1;
+        if (top->idx >= 0)
+        {
+            const Placement *p = top->cands + top->idx;
+            board_remove(win, p->x, p->y, p->type, p->rotation);
+            st->counts[p->type]++;
+        }
+        if ((size_t)(top->idx + 1) < top->cands_size)
+        {
+            top->idx++;
+            const Placement *p = top->cands + top->idx;
+            board_place(win, p->x, p->y, p->type, p->rotation, p->mark);
+            st->counts[p->type]--;
+            need_frame = true;
+            if (++st->nodes >= budget)
+            {
+                drop_band(st, depth);
+                return false;
+            }
+            continue;
+        }
+        // frame exhausted; the parent's placement is undone on the next pass
+        depth--;
+        if (depth == 0)
+            return false;
+    }
+}
+
+// keep the first band, drop the lookahead and move everything reaching below the band up by band rows
+static StatusCode commit_band(StreamState *st, size_t depth, FILE *out)
+{
+    Board *win = st->window;
+    size_t band_num = 0;
+    while (band_num < depth)
+    {
+        const SolverFrame *frame = st->frames + band_num;
+        if (frame->cands[frame->idx].y >= st->band)
+            break;
+        band_num++;
+    }
+    for (size_t d = depth; d-- > band_num;)
+    {
+        const Placement *p = st->frames[d].cands + st->frames[d].idx;
+        board_remove(win, p->x, p->y, p->type, p->rotation);
+        st->counts[p->type]++;
+    }
+    board_print_rows(win, 0, st->band, out);
+    if (ferror(out))
+        return STATUS_ERR_INPUT;
+
+    // whatever reaches below the band survives the shift, cell by cell
+    size_t kept = 0;
+    for (int y = st->band; y < board_height(win); ++y)
+    {
+        for (int x = 0; x < st->width; ++x)
+        {
+            char mark = board_cell_mark(win, x, y);
+            if (mark == '.')
+                continue;
+            CarriedCell *c = st->carried + kept++;
+            c->x = x;
+            c->y = y - st->band;
+            c->mark = mark;
+        }
+    }
+    st->carried_num = kept;
+    st->placed += band_num;
+
+    board_clear(win);
+    for (size_t i = 0; i < st->carried_num; ++i)
+        board_fill_cell(win, st->carried[i].x, st->carried[i].y, st->carried[i].mark);
+    return STATUS_OK;
+}
+
+// print the last rows: the tail the last band was accepted with or, when no band was committed, a solve of them
+static StatusCode solve_tail(StreamState *st, int rows, FILE *out)
+{
+    Board *tail = st->tail;
+    st->tail = NULL;
+    StatusCode res = STATUS_OK;
+    if (!tail)
+    {
+        tail = board_create(st->width, rows);
+        if (!tail)
+            return STATUS_ERR_MEMORY;
+        res = solve_rows(st, tail, STREAM_BAND_NODE_LIMIT);
+    }
+    if (res == STATUS_OK)
+    {
+        board_print(tail, out);
+        if (ferror(out))
+            res = STATUS_ERR_INPUT;
+    }
+    board_destroy(tail);
+    return res;
+}
+
+StatusCode stream_solve(int width, int height, const TetrominoBag *bag, size_t band_rows, FILE *out,
+                        StreamStats *out_stats)
+{
+    StreamStats stats = {0, 0, 0, -1};
+    if (out_stats)
+        *out_stats = stats;
+    if (!bag || !out || width <= 0 || height <= 0 || band_rows == 0)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    size_t area = (size_t)width * (size_t)height;
+    if (bag->total > SIZE_MAX / 4 || bag->total * 4 != area)
+        return STATUS_ERR_UNSOLVABLE;
+
+    StreamState st;
+    memset(&st, 0, sizeof(st));
+    st.width = width;
+    st.band = band_rows < (size_t)height ? (int)band_rows : height;
+    memcpy(st.counts, bag->counts, sizeof(st.counts));
+    memcpy(st.initial, bag->counts, sizeof(st.initial));
+    int window_rows = height;
+    if (band_rows < (size_t)height / 2 && 2 * band_rows + 3 < (size_t)height)
+        window_rows = 2 * st.band + 3;
+
+    StatusCode res = STATUS_OK;
+    int row = 0; // board row of window row 0
+    if (window_rows < height)
+    {
+        st.window = board_create(width, window_rows);
+        st.frame_cap = board_cell_count(st.window) / 4 + 1;
+        st.frames = malloc(st.frame_cap * sizeof(SolverFrame));
+        st.carried = malloc(board_cell_count(st.window) * sizeof(CarriedCell));
+        if (!st.window || !st.frames || !st.carried)
+            res = STATUS_ERR_MEMORY;
+
+        // commit bands while a full window still fits above the bottom edge, until one is accepted with its tail
+        while (res == STATUS_OK && height - row > window_rows && !st.tail)
+        {
+            size_t depth = 0;
+            int rows_below = height - row - st.band;
+            bool last = rows_below <= STREAM_TAIL_WINDOWS * window_rows;
+            if (!search_band(&st, last ? st.band : 2 * st.band, rows_below, last, &depth, &res))
+            {
+                if (res == STATUS_OK)
+                {
+                    res = STATUS_ERR_UNSOLVABLE;
+                    stats.stuck_row = row;
+                }
+                break;
+            }
+            res = commit_band(&st, depth, out);
+            if (res == STATUS_OK)
+            {
+                row += st.band;
+                stats.bands++;
+                stats.rows_done += band_rows;
+            }
+        }
+    }
+    if (res == STATUS_OK)
+    {
+        res = solve_tail(&st, height - row, out);
+        if (res == STATUS_OK)
+            stats.rows_done += (size_t)(height - row);
+        else if (res == STATUS_ERR_UNSOLVABLE)
+            stats.stuck_row = row;
+    }
+
+    stats.nodes = st.nodes;
+    if (out_stats)
+        *out_stats = stats;
+    board_destroy(st.window);
+    board_destroy(st.tail);
+    free(st.frames);
+    free(st.carried);
+    return res;
+}
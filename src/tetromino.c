@@ -6,6 +6,7 @@
  * Includes:
  *   - Name and token parsing for 7 shapes.
  *   - Relative coordinates for each rotation.
+ *   - Reflection across the main diagonal (for transposed searches).
  *   - Consistency of coordinates across the project. */
 
 const char *tetro_type_name(TetrominoType type)
@@ -252,4 +253,67 @@ size_t tetro_get_cells(TetrominoType type, size_t rotation, Cell out_cells[4])
     default:
         return 0;
     }
-}
\ No newline at end of file
+}
+
+TetrominoType tetro_transposed_type(TetrominoType type)
+{
+    switch (type)
+    {
+    case TETRO_S:
+        return TETRO_Z;
+    case TETRO_Z:
+        return TETRO_S;
+    case TETRO_J:
+        return TETRO_L;
+    case TETRO_L:
+        return TETRO_J;
+    case TETRO_I:
+    case TETRO_O:
+    case TETRO_T:
+    case TETRO_TYPE_COUNT:
+    default:
+        return type;
+    }
+}
+
+// cells are compared as sets: reflection keeps the bounding box at the anchor but not the cell order
+static bool same_cells(const Cell a[4], const Cell b[4])
+{
+    for (size_t i = 0; i < 4; ++i)
+    {
+        bool found = false;
+        for (size_t j = 0; j < 4 && !found; ++j)
+            found = a[i].x == b[j].x && a[i].y == b[j].y;
+        if (!found)
+            return false;
+    }
+    return true;
+}
+
+void tetro_transpose_placement(Placement *p)
+{
+    Cell cells[4];
+    tetro_get_cells(p->type, p->rotation, cells);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        int x = cells[i].x;
+        cells[i].x = cells[i].y;
+        cells[i].y = x;
+    }
+    TetrominoType type = tetro_transposed_type(p->type);
+    size_t rotation_num = tetro_rotation_count(type);
+    for (size_t r = 0; r < rotation_num; ++r)
+    {
+        Cell candidate[4];
+        tetro_get_cells(type, r, candidate);
+        if (same_cells(cells, candidate))
+        {
+            p->rotation = r;
+            break;
+        }
+    }
+    p->type = type;
+    int x = p->x;
+    p->x = p->y;
+    p->y = x;
+}
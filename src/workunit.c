@@ -0,0 +1,291 @@
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "workunit.h"
+#include "search.h"
+#include "checkpoint.h"
+#include "tetromino.h"
+
+/* Work unit implementation:
+ *   - Split: run the engine with a depth limit; each stop is saved as a unit and then skipped.
+ *   - Results: a line-oriented text file ("tetromino-result 1", size, obstacles if any, outcome, placements).
+ *   - Merge: sum counts, or take the first solved result in order. */
+
+#define RESULT_MAGIC "tetromino-result"
+#define RESULT_VERSION 1
+#define UNIT_NAME_FORMAT "%s/unit-%06zu.ckpt"
+#define TOKEN_MAX 32
+#define MARK_NUM 26 // 26 letters from A-Z
+
+// write the current stack as a unit with every frame fixed
+static StatusCode save_unit(const SearchContext *ctx, const TetrominoBag *bag, const char *dir, size_t index)
+{
+    int len = snprintf(NULL, 0, UNIT_NAME_FORMAT, dir, index);
+    if (len < 0)
+        return STATUS_ERR_INPUT;
+    char *path = malloc((size_t)len + 1);
+    if (!path)
+        return STATUS_ERR_MEMORY;
+    snprintf(path, (size_t)len + 1, UNIT_NAME_FORMAT, dir, index);
+
+    SearchContext unit = *ctx;
+    unit.floor = ctx->stack->top + 1;
+    unit.nodes = 0;
+    unit.solutions = 0;
+    StatusCode res = checkpoint_save(path, &unit, bag);
+    free(path);
+    return res;
+}
+
+StatusCode workunit_split(Board *board,
+                          const TetrominoBag *bag,
+                          size_t depth,
+                          const char *dir,
+                          size_t *out_units)
+{
+    if (!board || !bag || !dir || !out_units || depth == 0 || depth > (size_t)INT32_MAX)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    *out_units = 0;
+    if (board_filled_count(board) != board_blocked_count(board))
+        return STATUS_ERR_INVALID_ARGUMENT; // only obstacles may be filled
+
+    // endgame shortcuts would collapse subtrees, so split on the plain search
+    SearchContext ctx;
+    StatusCode res = search_init(&ctx, board, bag, NULL);
+    if (res != STATUS_OK)
+        return res == STATUS_ERR_UNSOLVABLE ? STATUS_OK : res; // area mismatch: no units
+    ctx.depth_limit = (int)depth;
+    ctx.cover = true; // units partition every tiling, so their counts add up and their solves are complete
+
+    size_t units = 0;
+    while (res == STATUS_OK)
+    {
+        SearchOutcome outcome = search_run(&ctx);
+        if (outcome == SEARCH_DEPTH_LIMIT || outcome == SEARCH_SOLVED)
+        {
+            res = save_unit(&ctx, bag, dir, units);
+            if (res != STATUS_OK)
+                break;
+            units++;
+            if (!search_backtrack(&ctx))
+                break;
+            continue;
+        }
+        if (outcome == SEARCH_ERROR)
+            res = ctx.error;
+        break; // exhausted: every subtree has been written
+    }
+
+    search_unwind(&ctx);
+    search_release(&ctx);
+    *out_units = units;
+    return res;
+}
+
+StatusCode workunit_write_result(const char *path, const WorkResult *result)
+{
+    if (!path || !result)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    FILE *fp = fopen(path, "w");
+    if (!fp)
+        return STATUS_ERR_INPUT;
+
+    fprintf(fp, "%s %d\n", RESULT_MAGIC, RESULT_VERSION);
+    fprintf(fp, "size %d %d\n", result->width, result->height);
+    if (result->blocked)
+    {
+        size_t cells = (size_t)result->width * (size_t)result->height, n = 0;
+        for (size_t i = 0; i < cells; ++i)
+            n += result->blocked[i];
+        fprintf(fp, "blocked %zu\n", n);
+        for (size_t i = 0; i < cells; ++i)
+        {
+            if (result->blocked[i])
+                fprintf(fp, "%zu %zu\n", i % (size_t)result->width, i / (size_t)result->width);
+        }
+    }
+    switch (result->outcome)
+    {
+    case WORK_SOLVED:
+        fprintf(fp, "solved %zu\n", result->placement_num);
+        for (size_t i = 0; i < result->placement_num; ++i)
+        {
+            const Placement *p = result->placements + i;
+            fprintf(fp, "%s %zu %d %d\n", tetro_type_name(p->type), p->rotation, p->x, p->y);
+        }
+        break;
+    case WORK_UNSOLVABLE:
+        fprintf(fp, "unsolvable\n");
+        break;
+    case WORK_COUNTED:
+        fprintf(fp, "counted %" PRIu64 "\n", result->count);
+        break;
+    default:
+        break;
+    }
+
+    bool ok = !ferror(fp);
+    if (fclose(fp) != 0)
+        ok = false;
+    return ok ? STATUS_OK : STATUS_ERR_INPUT;
+}
+
+StatusCode workunit_read_result(const char *path, WorkResult *out)
+{
+    if (!path || !out)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    memset(out, 0, sizeof(*out));
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+        return STATUS_ERR_INPUT;
+
+    char magic[TOKEN_MAX] = {0};
+    char outcome[TOKEN_MAX] = {0};
+    int version = 0;
+    bool ok = fscanf(fp, "%31s %d", magic, &version) == 2 &&
+              strcmp(magic, RESULT_MAGIC) == 0 && version == RESULT_VERSION &&
+              fscanf(fp, " size %d %d", &out->width, &out->height) == 2 &&
+              out->width > 0 && out->height > 0 &&
+              fscanf(fp, "%31s", outcome) == 1;
+
+    // optional obstacle list before the outcome
+    if (ok && strcmp(outcome, "blocked") == 0)
+    {
+        size_t cells = (size_t)out->width * (size_t)out->height, n = 0;
+        ok = fscanf(fp, "%zu", &n) == 1 && n > 0 && n <= cells;
+        if (ok)
+        {
+            out->blocked = calloc(cells, sizeof(bool));
+            ok = out->blocked != NULL;
+        }
+        for (size_t i = 0; ok && i < n; ++i)
+        {
+            int x = 0, y = 0;
+            ok = fscanf(fp, "%d %d", &x, &y) == 2 && x >= 0 && y >= 0 && x < out->width && y < out->height;
+            ok = ok && !out->blocked[(size_t)y * (size_t)out->width + (size_t)x];
+            if (ok)
+                out->blocked[(size_t)y * (size_t)out->width + (size_t)x] = true;
+        }
+        ok = ok && fscanf(fp, "%31s", outcome) == 1;
+    }
+
+    if (ok && strcmp(outcome, "unsolvable") == 0)
+    {
+        out->outcome = WORK_UNSOLVABLE;
+    }
+    else if (ok && strcmp(outcome, "counted") == 0)
+    {
+        out->outcome = WORK_COUNTED;
+        ok = fscanf(fp, "%" SCNu64, &out->count) == 1;
+    }
+    else if (ok && strcmp(outcome, "solved") == 0)
+    {
+        out->outcome = WORK_SOLVED;
+        size_t n = 0;
+        ok = fscanf(fp, "%zu", &n) == 1 && n > 0 &&
+             n <= (size_t)out->width * (size_t)out->height / 4;
+        if (ok)
+        {
+            out->placements = malloc(n * PLACEMENT_SIZE);
+            ok = out->placements != NULL;
+        }
+        for (size_t i = 0; ok && i < n; ++i)
+        {
+            char name[TOKEN_MAX] = {0};
+            Placement *p = out->placements + i;
+            ok = fscanf(fp, "%31s %zu %d %d", name, &p->rotation, &p->x, &p->y) == 4;
+            p->type = tetro_type_from_token(name);
+            p->mark = (char)('A' + (i % MARK_NUM));
+            ok = ok && p->type != TETRO_TYPE_COUNT && p->rotation < tetro_rotation_count(p->type);
+        }
+        out->placement_num = ok ? n : 0;
+    }
+    else
+    {
+        ok = false;
+    }
+    fclose(fp);
+
+    if (!ok)
+    {
+        workunit_result_free(out);
+        return STATUS_ERR_INPUT;
+    }
+    return STATUS_OK;
+}
+
+void workunit_result_free(WorkResult *result)
+{
+    if (!result)
+        return;
+    free(result->placements);
+    free(result->blocked);
+    result->placements = NULL;
+    result->placement_num = 0;
+    result->blocked = NULL;
+}
+
+// same obstacles on two results of one board size
+static bool same_obstacles(const WorkResult *a, const WorkResult *b)
+{
+    if (!a->blocked || !b->blocked)
+        return !a->blocked && !b->blocked;
+    return memcmp(a->blocked, b->blocked, (size_t)a->width * (size_t)a->height * sizeof(bool)) == 0;
+}
+
+StatusCode workunit_merge(const char *const *paths, size_t path_num, WorkResult *out)
+{
+    if (!paths || !out || path_num == 0)
+        return STATUS_ERR_INVALID_ARGUMENT;
+    memset(out, 0, sizeof(*out));
+    out->outcome = WORK_UNSOLVABLE;
+
+    for (size_t i = 0; i < path_num; ++i)
+    {
+        WorkResult part;
+        StatusCode res = workunit_read_result(paths[i], &part);
+        if (res != STATUS_OK)
+        {
+            workunit_result_free(out);
+            return res;
+        }
+
+        // every part must describe the same board and the same kind of run
+        bool counted_part = part.outcome == WORK_COUNTED;
+        bool counted_merge = out->outcome == WORK_COUNTED;
+        if ((i > 0 && (part.width != out->width || part.height != out->height)) ||
+            (i > 0 && (counted_part != counted_merge || !same_obstacles(&part, out))))
+        {
+            workunit_result_free(&part);
+            workunit_result_free(out);
+            return STATUS_ERR_INPUT;
+        }
+        out->width = part.width;
+        out->height = part.height;
+        if (i == 0)
+        {
+            out->blocked = part.blocked; // the merge owns the first part's obstacles
+            part.blocked = NULL;
+        }
+
+        if (counted_part)
+        {
+            out->outcome = WORK_COUNTED;
+            out->count += part.count;
+            workunit_result_free(&part);
+        }
+        else if (part.outcome == WORK_SOLVED && out->outcome != WORK_SOLVED)
+        {
+            // first solved unit in order: keep its tiling
+            out->outcome = WORK_SOLVED;
+            out->placements = part.placements;
+            out->placement_num = part.placement_num;
+            free(part.blocked);
+        }
+        else
+        {
+            workunit_result_free(&part);
+        }
+    }
+    return STATUS_OK;
+}
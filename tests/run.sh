@@ -8,6 +8,9 @@ if [ ! -x "$BIN" ]; then
 fi
 
 fail=0
+# scratch directory for files cases write (@TMP@ in a .args file); removed on exit
+TEST_TMP="$(mktemp -d)"
+trap 'rm -rf "$TEST_TMP"' EXIT
 
 echo "== Running tests =="
 for f in tests/cases/*.in; do
@@ -18,9 +21,17 @@ for f in tests/cases/*.in; do
   echo "Input:"
   sed 's/^/  /' "$f"
   echo
+  # optional extra CLI flags live next to the case as <name>.args
+  args=()
+  if [ -f "${f%.in}.args" ]; then
+    read -r -a args < "${f%.in}.args"
+    args=("${args[@]//@TMP@/$TEST_TMP}")
+    echo "Args: ${args[*]}"
+  fi
   echo "Output:"
-  "$BIN" < "$f"
+  output="$("$BIN" ${args[@]+"${args[@]}"} < "$f")"
   status=$?
+  [ -n "$output" ] && printf '%s\n' "$output"
   echo "Exit code: $status"
 
   expected=0
@@ -31,11 +42,15 @@ for f in tests/cases/*.in; do
     solvable_*)   expected=0 ;;
   esac
 
-  if [ "$status" -eq "$expected" ]; then
-    echo "RESULT: PASS"
-  else
+  # optional expected stdout lives next to the case as <name>.out
+  if [ "$status" -ne "$expected" ]; then
     echo "RESULT: FAIL (expected $expected)"
     fail=$((fail+1))
+  elif [ -f "${f%.in}.out" ] && [ "$output" != "$(cat "${f%.in}.out")" ]; then
+    echo "RESULT: FAIL (output differs from ${f%.in}.out)"
+    fail=$((fail+1))
+  else
+    echo "RESULT: PASS"
   fi
 
 done